@@ -0,0 +1,70 @@
+//
+// Created by maojrs on 4/16/20.
+//
+
+#pragma once
+#include <set>
+#include <vector>
+
+namespace msmrd {
+    /**
+     * Graph of the bonds between particles, used to keep track of the compounds (connected components) and
+     * ring formation without rebuilding them from all the pairs of particles. The connectivity is stored in a
+     * union-find structure, so binding two particles merges their compounds in (almost) O(1), and a bond between
+     * two particles of the same compound, which closes a loop, is detected in the same call. Unbinding can split
+     * a compound, which union-find can't undo, so only the compound of the unbound particles is relabeled
+     * (linear in its size). A compound with as many bonds as particles is a ring (a single closed loop).
+     */
+    class bondGraph {
+    protected:
+        std::vector<int> parent;
+        std::vector<int> compoundSize;
+        std::vector<int> compoundBonds;
+        std::vector<std::vector<int>> bonds;
+        std::set<int> ringRoots;
+        std::vector<int> stack;
+        std::vector<int> members;
+        int numBonds = 0;
+        /**
+         * @param parent parent of each particle in the union-find trees, the root identifies the compound.
+         * @param compoundSize number of particles in the compound (only valid at the roots)
+         * @param compoundBonds number of bonds in the compound (only valid at the roots)
+         * @param bonds indexes of the particles bound to each particle
+         * @param ringRoots roots of the compounds that are rings
+         * @param stack, members buffers used to relabel compounds after unbinding
+         * @param numBonds total number of bonds
+         */
+
+        int findRoot(int index);
+
+        void updateRing(int root);
+
+        void relabelCompound(int index);
+
+    public:
+        explicit bondGraph(int numParticles = 0);
+
+        void reset(int numParticles);
+
+        bool addBond(int iIndex, int jIndex);
+
+        bool removeBond(int iIndex, int jIndex);
+
+        bool isBound(int iIndex, int jIndex) const;
+
+        int getCompoundSize(int index);
+
+        int getCompoundBonds(int index);
+
+        bool isInRing(int index);
+
+        std::vector<int> getRingSizes() const;
+
+        int getNumberOfParticles() const { return static_cast<int>(parent.size()); }
+
+        int getNumberOfBonds() const { return numBonds; }
+
+        int getNumberOfRings() const { return static_cast<int>(ringRoots.size()); }
+    };
+
+}
@@ -58,6 +58,8 @@ namespace msmrd {
 
         void setThetasOffset(double offset);
 
+        void setLookupTable(int resolution);
+
         int getSectionNumber(vec3<double> relativePosition, quaternion<double> relativeQuaternion,
                              quaternion<double> quaternionReference = {1,0,0,0});
 
@@ -50,6 +50,8 @@ namespace msmrd {
 
         void setThetasOffset(double offset);
 
+        void setLookupTable(int resolution);
+
         int getSectionNumber(quaternion<double> quatCoordinate);
 
         std::tuple<std::array<double, 2>, std::array<double, 2>,
@@ -14,13 +14,44 @@ namespace msmrd {
     * This class creates an equal area partition on the surface of a sphere. It is a c++ copy and extension
     * of the python code in module msmrd2.tools.spherePartition.
     *
+    * Section numbers are found with binary searches over the collar and theta cuts. Optionally (setLookupTable),
+    * a cube map lookup table gives the section of most directions in O(1) without trigonometric functions; the
+    * directions in cells cut by a section boundary fall back to the binary searches, so results are the same.
+    *
     * Note section numbering (secNumber) starts in 1 and not zero.
     */
     class spherePartition {
     protected:
+        std::vector<int> collarOffsets;
+        std::vector<std::vector<double>> collarThetas;
+        int lookupResolution = 0;
+        std::vector<int> lookupTable;
+        /**
+         * @param collarOffsets number of sections before each collar (cumulative sum of regionsPerCollar), its
+         * last entry is numSections.
+         * @param collarThetas theta cuts of each collar (except the polar caps) with the thetasOffset subtracted,
+         * as they are compared in getSectionNumber.
+         * @param lookupResolution number of cells along each side of the faces of the cube map lookup table, zero
+         * if the lookup table is disabled.
+         * @param lookupTable section number of each cell of the cube map, or zero if the cell is cut by the
+         * boundary of a section. Cell (i,j) of face f is in lookupTable[(f * lookupResolution + i) *
+         * lookupResolution + j].
+         */
 
         void partitionSphere();
 
+        void setSectionOffsets();
+
+        int getCollarIndex(double phi) const;
+
+        int getThetaIndex(int collarIndex, double theta) const;
+
+        void buildLookupTable();
+
+        int getCellSectionNumber(int face, double a0, double a1, double b0, double b1) const;
+
+        int lookupSectionNumber(const vec3<double> &coordinate) const;
+
         /*The following three functions should remain outside of the main partition calculation,
          * so it can be easily generalizable to other discretizations (like the half sphere) */
 
@@ -64,6 +95,10 @@ namespace msmrd {
 
         std::tuple<std::array<double, 2>, std::array<double, 2>> getAngles(int secNumber);
 
+        void setLookupTable(int resolution);
+
+        double getLookupTableCoverage() const;
+
 
         /* Other not so important functions (mostly for PyBindings)*/
 
@@ -71,6 +106,8 @@ namespace msmrd {
 
         int getNumSections(){ return numSections; }
 
+        int getLookupTableResolution() const { return lookupResolution; }
+
         int getSectionNumberPyBind(std::vector<double> coord);
 
     };
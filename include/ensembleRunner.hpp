@@ -0,0 +1,173 @@
+//
+// Created by maojrs on 4/2/20.
+//
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include "particle.hpp"
+#include "randomgen.hpp"
+
+namespace msmrd {
+    /**
+     * Thread pool with work stealing to run a fixed number of independent tasks (indexed 0 to numTasks-1). Every
+     * thread has its own queue of tasks, initially a contiguous block of indexes. Threads take tasks from the
+     * front of their own queue and, once it is empty, steal from the back of the other queues. So the load is
+     * balanced even if the run time of the tasks varies by orders of magnitude (e.g. first passage times).
+     */
+    class workStealingPool {
+    private:
+        int numThreads;
+        std::vector<std::vector<int>> queues;
+        std::vector<size_t> queueFront;
+        std::vector<std::unique_ptr<std::mutex>> queueMutex;
+        std::atomic<long> numSteals{0};
+        /**
+         * @param numThreads number of threads (the calling thread is not used)
+         * @param queues tasks of each thread; the entries between queueFront and the end are pending
+         * @param queueFront index of the next task of each queue taken by its owner
+         * @param queueMutex mutex of each queue
+         * @param numSteals number of tasks taken from the queue of another thread in the last run
+         */
+
+        bool popTask(int thread, int &task);
+
+        bool stealTask(int thread, int &task);
+
+    public:
+        explicit workStealingPool(int numThreads);
+
+        void run(int numTasks, const std::function<void(int task)> &function);
+
+        int getNumThreads() const { return numThreads; }
+
+        long getNumSteals() const { return numSteals.load(); }
+    };
+
+
+    /**
+     * Result of a replica of an ensemble of simulations
+     * @param replica index of the replica
+     * @param time clock of the integrator at the end of the run
+     * @param numSteps number of time steps integrated
+     * @param stopped true if the stop condition was fulfilled, false if the maximum number of steps was reached
+     * @param particles particle list at the end of the run
+     */
+    struct replicaResult {
+        int replica;
+        double time;
+        long numSteps;
+        bool stopped;
+        std::vector<particle> particles;
+    };
+
+
+    /**
+     * Runs an ensemble of independent replicas of a simulation (e.g. to sample first passage times) in parallel
+     * threads. Every replica integrates its own copy of the prototype integrator, with the counter-based random
+     * number generator keyed by the replica index, so the replicas are independent and reproducible regardless of
+     * the thread that runs them. The initial particle list of each replica is given by a generator function, that
+     * receives the replica index and a random number generator keyed by it. Each replica is integrated until the
+     * stop condition is fulfilled or a maximum number of steps is reached. The results are passed to a callback as
+     * soon as each replica finishes (one at a time) and returned sorted by replica index. The particle generator
+     * and the stop condition are called concurrently from several threads. The potentials and boundary are shared
+     * by all the replicas; they are only read during the integration (see integrator::setSharedPotentials).
+     * @tparam INTEGRATOR integrator class (copy constructible), e.g. overdampedLangevin or msmrdIntegrator<ctmsm>
+     */
+    template <typename INTEGRATOR>
+    class ensembleRunner {
+    public:
+        using particleGenerator = std::function<std::vector<particle>(int replica, randomgen &randg)>;
+        using stopCondition = std::function<bool(const std::vector<particle> &parts, double time)>;
+        using resultCallback = std::function<void(const replicaResult &result)>;
+    private:
+        INTEGRATOR prototype;
+        particleGenerator generateParticles;
+        long seed;
+        stopCondition stop;
+        int numThreads = 1;
+        /**
+         * @param prototype copy of the integrator (with potentials, boundary, MSMs...) used to create the replicas
+         * @param generateParticles function returning the initial particle list of a replica
+         * @param seed seed of the random number generator passed to generateParticles
+         * @param stop condition evaluated after each time step (no condition if empty)
+         * @param numThreads number of threads of the work stealing pool
+         */
+
+    public:
+        ensembleRunner(const INTEGRATOR &prototype, particleGenerator generateParticles, long seed)
+                : prototype(prototype), generateParticles(std::move(generateParticles)), seed(seed) {};
+
+        replicaResult runReplica(int replica, long maxSteps) const;
+
+        std::vector<replicaResult> run(int numReplicas, long maxSteps, const resultCallback &callback = nullptr);
+
+        void setStopCondition(stopCondition condition) { stop = std::move(condition); }
+
+        void setNumThreads(int nthreads);
+
+        int getNumThreads() const { return numThreads; }
+    };
+
+
+    // Runs one replica; it doesn't modify the runner, so it can be called concurrently for different replicas
+    template <typename INTEGRATOR>
+    replicaResult ensembleRunner<INTEGRATOR>::runReplica(int replica, long maxSteps) const {
+        INTEGRATOR integ = prototype;
+        integ.setRandomGenerator("philox");
+        integ.setReplicaID(replica);
+        integ.setSharedPotentials(true);
+        randomgen randg;
+        randg.setSeed(seed);
+        randg.setBackend("philox");
+        randg.setReplicaID(replica);
+        replicaResult result{replica, 0.0, 0, false, generateParticles(replica, randg)};
+        while (result.numSteps < maxSteps) {
+            integ.integrate(result.particles);
+            result.numSteps++;
+            if (stop and stop(result.particles, integ.getClock())) {
+                result.stopped = true;
+                break;
+            }
+        }
+        result.time = integ.getClock();
+        return result;
+    }
+
+    /* Runs numReplicas replicas in the work stealing pool. The callback is called from the pool threads, but
+     * never concurrently. If a replica throws, the exception is rethrown once all the threads finished. */
+    template <typename INTEGRATOR>
+    std::vector<replicaResult> ensembleRunner<INTEGRATOR>::run(int numReplicas, long maxSteps,
+                                                               const resultCallback &callback) {
+        std::vector<replicaResult> results;
+        results.reserve(numReplicas);
+        std::mutex resultsMutex;
+        workStealingPool pool(std::min(numThreads, std::max(numReplicas, 1)));
+        pool.run(numReplicas, [&](int replica) {
+            auto result = runReplica(replica, maxSteps);
+            std::lock_guard<std::mutex> lock(resultsMutex);
+            if (callback) {
+                callback(result);
+            }
+            results.push_back(std::move(result));
+        });
+        std::sort(results.begin(), results.end(), [](const replicaResult &a, const replicaResult &b) {
+            return a.replica < b.replica;
+        });
+        return results;
+    }
+
+    template <typename INTEGRATOR>
+    void ensembleRunner<INTEGRATOR>::setNumThreads(int nthreads) {
+        if (nthreads < 1) {
+            throw std::invalid_argument("Number of threads must be at least one");
+        }
+        numThreads = nthreads;
+    }
+
+}
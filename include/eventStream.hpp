@@ -0,0 +1,109 @@
+//
+// Created by maojrs on 4/28/20.
+//
+
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "pairEventManager.hpp"
+
+namespace msmrd {
+    /**
+     * Fixed size record of an event applied in MSM/RD, written as is into binary event streams. It can be read
+     * in python with numpy.fromfile(filename, dtype=[('time', 'f8'), ('part1Index', 'i4'), ('part2Index', 'i4'),
+     * ('originState', 'i4'), ('endState', 'i4'), ('type', 'i4'), ('replicaID', 'i4')]).
+     * @param time time when the event happened
+     * @param part1Index, part2Index indexes of the particles involved (part1Index < part2Index)
+     * @param originState, endState states before and after the event
+     * @param type event type, integer value of the eventType enum (binding = 1, unbinding = 2, bound2bound = 3)
+     * @param replicaID replica that applied the event (see msmrdIntegrator::setReplicaID), so the records of the
+     * replicas of an ensemble, which share one stream, can be told apart. Zero for a single simulation.
+     */
+    struct eventRecord {
+        double time;
+        std::int32_t part1Index;
+        std::int32_t part2Index;
+        std::int32_t originState;
+        std::int32_t endState;
+        std::int32_t type;
+        std::int32_t replicaID;
+    };
+    static_assert(std::is_pod<eventRecord>::value and sizeof(eventRecord) == 32,
+                  "Event records must be 32 byte POD structures");
+
+
+    /**
+     * Binary stream of event records into a file. The records are copied into a bounded ring buffer, which is
+     * written into the file by a background thread, when it is half full or periodically (every flushInterval).
+     * Therefore recording an event doesn't format or write anything, and the memory used is fixed. If the buffer
+     * is full, recording waits until the writer frees space, so no records are lost. Recording is thread safe.
+     */
+    class eventStream {
+    protected:
+        std::ofstream outputFile;
+        std::vector<eventRecord> buffer;
+        std::vector<eventRecord> writeBuffer;
+        long numRecorded = 0;
+        long numTaken = 0;
+        long numWritten = 0;
+        bool flushRequested = false;
+        bool stopWriter = false;
+        bool writeFailed = false;
+        std::chrono::milliseconds flushInterval;
+        std::mutex bufferMutex;
+        std::condition_variable writerCondition;
+        std::condition_variable recorderCondition;
+        std::thread writer;
+        /**
+         * @param outputFile binary file where the records are written
+         * @param buffer ring buffer of records, record n is stored in buffer[n % buffer.size()]
+         * @param writeBuffer records taken from the ring buffer by the writer thread to write them into the file
+         * @param numRecorded, numTaken, numWritten total number of records recorded, taken from the ring buffer
+         * by the writer thread and written into the file, respectively.
+         * @param flushRequested, stopWriter requests to the writer thread to write all the records (and flush the
+         * file), or to write them and finish.
+         * @param writeFailed true if writing into the file failed.
+         * @param flushInterval maximum time a record waits in the ring buffer before it is written.
+         * @param bufferMutex, writerCondition, recorderCondition mutex of all the above variables, and condition
+         * variables to notify the writer thread and the recording threads, respectively.
+         * @param writer background thread that writes the records.
+         */
+
+        void writeRecords();
+
+        void stop();
+
+    public:
+        explicit eventStream(const std::string &filename, int bufferSize = 4096, int flushIntervalMs = 1000);
+
+        ~eventStream();
+
+        eventStream(const eventStream &) = delete;
+
+        eventStream &operator=(const eventStream &) = delete;
+
+        void record(const eventRecord &event);
+
+        void record(double time, const pairEvent &event, std::int32_t replicaID = 0);
+
+        void flush();
+
+        void close();
+
+        long getNumRecorded();
+
+        long getNumWritten();
+
+        int getBufferSize() const { return static_cast<int>(buffer.size()); }
+
+        static std::vector<eventRecord> readEventStream(const std::string &filename);
+    };
+
+}
@@ -0,0 +1,182 @@
+//
+// Created by maojrs on 4/9/20.
+//
+
+#pragma once
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "particle.hpp"
+#include "integrators/integrator.hpp"
+
+namespace msmrd {
+    /**
+     * Stopping condition of a first passage time simulation. It is evaluated after every time step with the
+     * integrator and the particle list, and it returns true once it is fulfilled. The predefined conditions are
+     * created by the static functions below, and they can be composed with allOf, anyOf and negation.
+     */
+    class passageCondition {
+    public:
+        using predicate = std::function<bool(integrator &integ, std::vector<particle> &parts)>;
+        predicate isFulfilled;
+        /**
+         * @param isFulfilled function of the integrator and the particle list that returns true if the condition
+         * is fulfilled.
+         */
+
+        passageCondition(predicate isFulfilled) : isFulfilled(std::move(isFulfilled)) {};
+
+        bool operator()(integrator &integ, std::vector<particle> &parts) const { return isFulfilled(integ, parts); }
+
+        // Predefined conditions
+
+        static passageCondition boundStates(std::vector<int> states, int iIndex = 0, int jIndex = 1);
+
+        template <typename TRAJECTORY>
+        static passageCondition discreteStates(TRAJECTORY &discreteTraj, std::vector<int> states,
+                                               int iIndex = 0, int jIndex = 1);
+
+        static passageCondition unbound(double distance, int iIndex = 0, int jIndex = 1);
+
+        template <typename INTEGRATOR>
+        static passageCondition ringFormation(int ringSize);
+
+        static passageCondition clockLimit(double maxTime);
+
+        // Composition of conditions
+
+        static passageCondition allOf(std::vector<passageCondition> conditions);
+
+        static passageCondition anyOf(std::vector<passageCondition> conditions);
+
+        static passageCondition negation(passageCondition condition);
+    };
+
+
+    /**
+     * Result of a first passage time simulation
+     * @param time elapsed time (clock of the integrator) from the beginning of the run until the condition was
+     * fulfilled, or until the maximum number of steps was reached.
+     * @param numSteps number of time steps integrated
+     * @param condition index of the condition that was fulfilled (the first one in order if several were
+     * fulfilled in the same time step), or -1 if the maximum number of steps was reached.
+     * @param conditionName name of the condition that was fulfilled, empty if none.
+     */
+    struct passageResult {
+        double time;
+        long numSteps;
+        int condition;
+        std::string conditionName;
+    };
+
+
+    /**
+     * First passage time driver. It integrates the particle list with the integrator until one of the stopping
+     * conditions is fulfilled and returns the elapsed time and the condition that was fulfilled. The conditions
+     * are evaluated after every time step, so the passage time is resolved up to one time step. This replaces
+     * first passage time loops in python, that need a python call per time step and usually check expensive
+     * conditions (e.g. ring formation) only every few thousand time steps.
+     * @tparam INTEGRATOR integrator class, e.g. overdampedLangevin, overdampedLangevinSelective,
+     * msmrdIntegrator<ctmsm> or msmrdMultiParticleIntegrator<ctmsm>.
+     */
+    template <typename INTEGRATOR>
+    class firstPassage {
+    private:
+        INTEGRATOR &integ;
+        std::vector<passageCondition> conditions;
+        std::vector<std::string> conditionNames;
+        /**
+         * @param integ reference to the integrator used for the simulation
+         * @param conditions stopping conditions, evaluated in order after each time step
+         * @param conditionNames names of the conditions, returned in the result of the run
+         */
+
+    public:
+        explicit firstPassage(INTEGRATOR &integ) : integ(integ) {};
+
+        void addCondition(std::string name, passageCondition condition);
+
+        void clearConditions();
+
+        int getNumberOfConditions() const { return static_cast<int>(conditions.size()); }
+
+        passageResult run(std::vector<particle> &parts, long maxSteps = -1);
+    };
+
+
+    /* Condition fulfilled when the discrete state of particles iIndex and jIndex, given by the discrete
+     * trajectory class (e.g. patchyDimerTrajectory), is any of the states. Useful to detect binding when the
+     * integrator doesn't keep track of bound states (e.g. overdampedLangevin). The discrete trajectory is
+     * referenced, so it must outlive the condition. */
+    template <typename TRAJECTORY>
+    passageCondition passageCondition::discreteStates(TRAJECTORY &discreteTraj, std::vector<int> states,
+                                                      int iIndex, int jIndex) {
+        auto trajectory = &discreteTraj;
+        return passageCondition([trajectory, states, iIndex, jIndex](integrator &integ,
+                                                                     std::vector<particle> &parts) {
+            int state = trajectory->sampleDiscreteState(parts[iIndex], parts[jIndex]);
+            return std::find(states.begin(), states.end(), state) != states.end();
+        });
+    }
+
+    /* Condition fulfilled when a ring of ringSize particles is formed, as detected by the particle compounds
+     * of the integrator (findClosedBindingLoops). INTEGRATOR must be the class of the integrator that evaluates
+     * the condition, e.g. overdampedLangevinSelective or msmrdMultiParticleIntegrator<ctmsm>. */
+    template <typename INTEGRATOR>
+    passageCondition passageCondition::ringFormation(int ringSize) {
+        return passageCondition([ringSize](integrator &integ, std::vector<particle> &parts) {
+            auto ringInteg = dynamic_cast<INTEGRATOR*>(&integ);
+            if (ringInteg == nullptr) {
+                throw std::invalid_argument("Ring formation condition evaluated with an integrator of a different "
+                                            "class than the one it was created for");
+            }
+            auto boundLoops = ringInteg->findClosedBindingLoops(parts);
+            return std::find(boundLoops.begin(), boundLoops.end(), ringSize) != boundLoops.end();
+        });
+    }
+
+
+    template <typename INTEGRATOR>
+    void firstPassage<INTEGRATOR>::addCondition(std::string name, passageCondition condition) {
+        conditionNames.push_back(std::move(name));
+        conditions.push_back(std::move(condition));
+    }
+
+    template <typename INTEGRATOR>
+    void firstPassage<INTEGRATOR>::clearConditions() {
+        conditionNames.clear();
+        conditions.clear();
+    }
+
+    /* Integrates the particle list until one of the conditions is fulfilled or maxSteps time steps are
+     * integrated (no limit if maxSteps is negative). The conditions are only checked after each time step, so
+     * a condition already fulfilled by the initial particle list is not detected. */
+    template <typename INTEGRATOR>
+    passageResult firstPassage<INTEGRATOR>::run(std::vector<particle> &parts, long maxSteps) {
+        if (conditions.empty() and maxSteps < 0) {
+            throw std::invalid_argument("First passage run requires at least one condition or a maximum number "
+                                        "of steps");
+        }
+        double initialClock = integ.getClock();
+        passageResult result{0.0, 0, -1, ""};
+        while (maxSteps < 0 or result.numSteps < maxSteps) {
+            integ.integrate(parts);
+            result.numSteps++;
+            for (int i = 0; i < conditions.size(); i++) {
+                if (conditions[i](integ, parts)) {
+                    result.condition = i;
+                    result.conditionName = conditionNames[i];
+                    break;
+                }
+            }
+            if (result.condition >= 0) {
+                break;
+            }
+        }
+        result.time = integ.getClock() - initialClock;
+        return result;
+    }
+
+}
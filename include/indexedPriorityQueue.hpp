@@ -0,0 +1,62 @@
+//
+// Created by maojrs on 4/23/20.
+//
+
+#pragma once
+#include <utility>
+#include <vector>
+
+namespace msmrd {
+    /**
+     * Indexed binary min-heap of (key, index) entries, with integer indexes from zero to maxIndex - 1. The position
+     * of each index in the heap is stored, so the key of any index can be read, changed or removed in O(log n)
+     * (O(1) to read) without searching the heap. Entries with the same key are ordered by index.
+     */
+    class indexedPriorityQueue {
+    protected:
+        std::vector<std::pair<double, int>> heap;
+        std::vector<int> heapPosition;
+        /**
+         * @param heap binary heap of (key, index) entries, the smallest one at heap[0].
+         * @param heapPosition position of each index in the heap, -1 if it is not in the queue.
+         */
+
+        void siftUp(int position);
+
+        void siftDown(int position);
+
+        void swapEntries(int position1, int position2);
+
+    public:
+        explicit indexedPriorityQueue(int maxIndex = 0);
+
+        void reset(int maxIndex);
+
+        void extend(int maxIndex);
+
+        void push(int index, double key);
+
+        void remove(int index);
+
+        void shiftKeys(double shift);
+
+        int pop();
+
+        bool contains(int index) const {
+            return index >= 0 and index < static_cast<int>(heapPosition.size()) and heapPosition[index] >= 0;
+        }
+
+        double getKey(int index) const;
+
+        int top() const;
+
+        double topKey() const;
+
+        int size() const { return static_cast<int>(heap.size()); }
+
+        bool empty() const { return heap.empty(); }
+
+        int getMaxIndex() const { return static_cast<int>(heapPosition.size()); }
+    };
+
+}
@@ -4,10 +4,16 @@
 
 #pragma once
 #include <array>
+#include <cmath>
+#include <functional>
 #include <utility>
 #include <memory>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "boundaries/boundary.hpp"
 #include "boundaries/noBoundary.hpp"
+#include "neighborList.hpp"
 #include "particle.hpp"
 #include "randomgen.hpp"
 #include "potentials/potentials.hpp"
@@ -30,6 +36,11 @@ namespace msmrd {
         std::vector<vec3<double>> forceField;
         std::vector<vec3<double>> torqueField;
 
+        // Number of threads to calculate forces and torques and per-thread buffers for the pair interactions
+        int numThreads = 1;
+        std::vector<std::vector<vec3<double>>> threadForceField;
+        std::vector<std::vector<vec3<double>>> threadTorqueField;
+
         bool boundaryActive = false;
         bool externalPotentialActive = false;
         bool pairPotentialActive = false;
@@ -43,6 +54,13 @@ namespace msmrd {
         // Pair potentials pointers (pairPot)
         pairPotential *pairPot;
 
+        // Cell/Verlet list to find interacting pairs (inactive by default, i.e. all pairs are evaluated)
+        bool neighborListActive = false;
+        neighborList neighbors = neighborList(1.0, 0.0);
+
+        // True if the potentials are shared with other integrators running concurrently (e.g. ensemble replicas)
+        bool sharedPotentials = false;
+
 
         /**
         * @param KbTemp = Boltzman constant times temperature
@@ -52,10 +70,13 @@ namespace msmrd {
         * be either point, rod or rigidbody, and it is determined by orientational degrees of freedom, points
         * have no orientation, rods need only one vector and rigidsolid requires a complete quaternion).
         * @param rotation boolean to indicate if rotation should be integrated
-        * @param randg random number generator based in mt19937
+        * @param randg random number generator (mt19937 or counter-based philox, see randomgen)
         *
         * @param forceField stores force experienced by each particle at a given time
         * @param torqueField stores torque experienced by each particle at a given time
+        * @param numThreads number of OpenMP threads used to calculate the force and torque fields (default 1)
+        * @param threadForceField/threadTorqueField per-thread buffers accumulating the pair interactions. They are
+        * summed in thread order afterwards, so results are reproducible for a fixed number of threads.
         *
         * @param boundaryActive indicates if a boundary conditions is active
         * @param externalPotActive indicates if external potential has been set
@@ -65,6 +86,11 @@ namespace msmrd {
         * Note all following potentials default to zero and not every integrator will make use of all this potentials
         * @param *externalPot pointer to external potential
         * @param *pairPot pointer to pair potential between two particles
+        * @param neighborListActive if true, pair forces are only evaluated for pairs found by the neighbor list.
+        * Only used if the pair potential has a finite cut off (pairPot->getCutOff()).
+        * @param neighbors cell list (Verlet list if skin > 0) to search pairs within the pair potential cut off
+        * @param sharedPotentials if true, the pair potential precompute function is not called, since it modifies
+        * the potential and other integrators may be using it at the same time (the results don't change)
         * @param clock keeps track of global time
         */
 
@@ -75,18 +101,38 @@ namespace msmrd {
 
         virtual void rotate(particle &part, vec3<double> torque, double dt) = 0;
 
+        /* Selects the random stream of the particle (or compound) with the given index at the current time step,
+         * only used by the counter-based random number generator. */
+        void setRandomSubstream(int index) {
+            if (randg.isCounterBased()) {
+                randg.setSubstream(index, std::llround(clock/dt));
+            }
+        }
+
 
         /* Protected functions to get forces and torques due to external or pair potentials for integrator.
          * The template PARTICLE can take values of particle or particleMS or other custom defined particles.
-         * This is required because vectors of child classes are not recognized as childs of vector of parents class.*/
+         * This is required because vectors of child classes are not recognized as childs of vector of parents class.
+         * The pair interaction function is pairPotential::forceTorque, unless another one is given (e.g. the slow
+         * or fast parts used by multiple time step integrators). */
+        using pairForceTorqueFunction = std::array<vec3<double>, 4> (pairPotential::*)(const particle &,
+                                                                                       const particle &) const;
+
         template< typename PARTICLE >
-        void calculateForceTorqueFields(std::vector<PARTICLE> &parts); // external + pairs
+        void calculateForceTorqueFields(std::vector<PARTICLE> &parts,
+                                        pairForceTorqueFunction pairForceTorque = &pairPotential::forceTorque);
 
         template< typename PARTICLE >
         void calculateExternalForceTorques(std::vector<PARTICLE> &parts, int numParticles);
 
         template< typename PARTICLE >
-        void calculatePairsForceTorques(std::vector<PARTICLE> &parts, int numParticles);
+        void calculatePairsForceTorques(std::vector<PARTICLE> &parts, int numParticles,
+                                        pairForceTorqueFunction pairForceTorque = &pairPotential::forceTorque);
+
+        template< typename PARTICLE >
+        void calculatePairsForceTorquesThreaded(std::vector<PARTICLE> &parts, int numParticles,
+                                                const std::vector<std::array<int, 2>> *pairs,
+                                                pairForceTorqueFunction pairForceTorque);
 
         // Other functions used by most integrators, so defined here as template functions
 
@@ -105,6 +151,10 @@ namespace msmrd {
         // Main public functions definitions
         virtual void integrate(std::vector<particle> &parts);
 
+        using stepCondition = std::function<bool(std::vector<particle> &parts, double time)>;
+
+        long integrateSteps(std::vector<particle> &parts, long nsteps, const stepCondition &stopCondition = nullptr);
+
         vec3<double> calculateRelativePosition(vec3<double> p1, vec3<double> p2);
 
 
@@ -115,13 +165,32 @@ namespace msmrd {
 
         void setPairPotential(pairPotential *pot);
 
+        void setNeighborList(double skin);
+
+        void disableNeighborList() { neighborListActive = false; }
+
+        bool isNeighborListActive() { return neighborListActive; }
+
+        void setNumThreads(int nthreads);
+
+        int getNumThreads() const { return numThreads; }
+
+        virtual void setRandomGenerator(std::string backend) { randg.setBackend(backend); }
+
+        virtual void setReplicaID(long replicaID) { randg.setReplicaID(replicaID); }
+
+        void setSharedPotentials(bool shared) { sharedPotentials = shared; }
+
+        std::string getRandomGenerator() const { return randg.getBackend(); }
+
         void setKbT(double kbt) { KbTemp = kbt; }
 
         double getClock() const { return clock; }
 
-        void setClock(double newTime) { clock = newTime; }
+        // Virtual since integrators that keep absolute event times need to shift them
+        virtual void setClock(double newTime) { clock = newTime; }
 
-        void resetClock() {clock = 0.0;}
+        void resetClock() { setClock(0.0); }
 
         std::string getParticlesBodyType() const { return particlesbodytype; }
 
@@ -141,7 +210,8 @@ namespace msmrd {
     /* Calculates the total force and torque fields experienced by all particles, including external and
      * interaction pairs potentials. Relies on two other auxiliary functions to divide the work. */
     template <typename PARTICLE>
-    void integrator::calculateForceTorqueFields(std::vector<PARTICLE> &parts) {
+    void integrator::calculateForceTorqueFields(std::vector<PARTICLE> &parts,
+                                                pairForceTorqueFunction pairForceTorque) {
         unsigned int N = static_cast<int>(parts.size());
 
         // Resize force/torque fields array if the number of particles have changed
@@ -163,7 +233,7 @@ namespace msmrd {
 
         // Add forces and torques coming from pair interactions.
         if (pairPotentialActive) {
-            calculatePairsForceTorques(parts, N);
+            calculatePairsForceTorques(parts, N, pairForceTorque);
         }
     }
 
@@ -173,6 +243,8 @@ namespace msmrd {
     template <typename PARTICLE>
     void integrator::calculateExternalForceTorques(std::vector<PARTICLE> &parts, int numParticles) {
         std::array<vec3<double>, 2> forctorq;
+        // Each iteration only writes into its own entry, so the threaded loop gives the same result as the serial one
+        #pragma omp parallel for num_threads(numThreads) schedule(static) private(forctorq) if(numThreads > 1)
         for (int i = 0; i < numParticles; i++) {
             forctorq = externalPot->forceTorque(parts[i]);
             forceField[i] = 1.0 * forctorq[0];
@@ -184,15 +256,44 @@ namespace msmrd {
      * forceField and torqueField. Note different bodytypes require different function calls. Also note
      * to avoid duplicate calls to pairPotential.forceTorque, the two loops cover all the pair interactions
      * only once. The function pairPotential.forceTorque returns the force and torque exerted on particle1
-     * and the force and torque exerted on particle2 (in that order), from their mutual interaction. */
+     * and the force and torque exerted on particle2 (in that order), from their mutual interaction. If the
+     * neighbor list is active and the pair potential has a finite cut off, only nearby pairs are evaluated. */
     template <typename PARTICLE>
-    void integrator::calculatePairsForceTorques(std::vector<PARTICLE> &parts, int numParticles) {
-        unsigned int N = static_cast<int>(parts.size());
+    void integrator::calculatePairsForceTorques(std::vector<PARTICLE> &parts, int numParticles,
+                                                pairForceTorqueFunction pairForceTorque) {
         std::array<vec3<double>, 4> forctorq;
+        // Per time step precalculations of the potential (e.g. rotated patches)
+        if (not sharedPotentials) {
+            pairPot->precompute(parts);
+        }
+        double cutOff = pairPot->getCutOff();
+        bool useNeighborList = neighborListActive and std::isfinite(cutOff);
+        if (useNeighborList and cutOff != neighbors.getCutOff()) {
+            neighbors.setCutOff(cutOff);
+        }
+        if (numThreads > 1) {
+            auto pairs = useNeighborList ? &neighbors.getNeighborPairs(parts) : nullptr;
+            calculatePairsForceTorquesThreaded(parts, numParticles, pairs, pairForceTorque);
+            return;
+        }
+        /* Only evaluate pairs found by the neighbor list, the list is sorted, so the forces are added in the
+         * same order as in the loop over all pairs below. */
+        if (useNeighborList) {
+            for (auto &pair : neighbors.getNeighborPairs(parts)) {
+                int i = pair[0];
+                int j = pair[1];
+                forctorq = (pairPot->*pairForceTorque)(parts[i], parts[j]);
+                forceField[i] += 1.0*forctorq[0];
+                torqueField[i] += 1.0*forctorq[1];
+                forceField[j] += 1.0*forctorq[2];
+                torqueField[j] += 1.0*forctorq[3];
+            }
+            return;
+        }
         // Calculate the forces and torque for each possible interaction
         for (int i = 0; i < numParticles; i++) {
             for (int j = i + 1; j < numParticles; j++) {
-                forctorq = pairPot->forceTorque(parts[i], parts[j]);
+                forctorq = (pairPot->*pairForceTorque)(parts[i], parts[j]);
                 forceField[i] += 1.0*forctorq[0];
                 torqueField[i] += 1.0*forctorq[1];
                 forceField[j] += 1.0*forctorq[2];
@@ -202,6 +303,67 @@ namespace msmrd {
     }
 
 
+    /* Multithreaded version of calculatePairsForceTorques. Since each pair interaction modifies two particles,
+     * every thread accumulates its share of the pairs (given by the neighbor list, or all pairs if pairs is a
+     * null pointer) into its own buffer. The buffers are then added into forceField and torqueField in thread
+     * order. The static schedule assigns the same pairs to the same threads at every call, so the result is
+     * bitwise reproducible for a fixed number of threads (though not equal to the serial one up to round off). */
+    template <typename PARTICLE>
+    void integrator::calculatePairsForceTorquesThreaded(std::vector<PARTICLE> &parts, int numParticles,
+                                                        const std::vector<std::array<int, 2>> *pairs,
+                                                        pairForceTorqueFunction pairForceTorque) {
+#ifdef _OPENMP
+        threadForceField.resize(numThreads);
+        threadTorqueField.resize(numThreads);
+        int teamSize = numThreads;
+        #pragma omp parallel num_threads(numThreads)
+        {
+            #pragma omp single
+            teamSize = omp_get_num_threads();
+            int thread = omp_get_thread_num();
+            auto &threadForce = threadForceField[thread];
+            auto &threadTorque = threadTorqueField[thread];
+            threadForce.assign(numParticles, vec3<double>(0, 0, 0));
+            threadTorque.assign(numParticles, vec3<double>(0, 0, 0));
+            std::array<vec3<double>, 4> forctorq;
+            if (pairs != nullptr) {
+                int numPairs = static_cast<int>(pairs->size());
+                #pragma omp for schedule(static)
+                for (int k = 0; k < numPairs; k++) {
+                    int i = (*pairs)[k][0];
+                    int j = (*pairs)[k][1];
+                    forctorq = (pairPot->*pairForceTorque)(parts[i], parts[j]);
+                    threadForce[i] += forctorq[0];
+                    threadTorque[i] += forctorq[1];
+                    threadForce[j] += forctorq[2];
+                    threadTorque[j] += forctorq[3];
+                }
+            } else {
+                // Rows are dealt cyclically to balance the triangular loop
+                #pragma omp for schedule(static, 1)
+                for (int i = 0; i < numParticles; i++) {
+                    for (int j = i + 1; j < numParticles; j++) {
+                        forctorq = (pairPot->*pairForceTorque)(parts[i], parts[j]);
+                        threadForce[i] += forctorq[0];
+                        threadTorque[i] += forctorq[1];
+                        threadForce[j] += forctorq[2];
+                        threadTorque[j] += forctorq[3];
+                    }
+                }
+            }
+            // Implicit barrier at the end of the loops above, so all buffers are complete.
+            #pragma omp for schedule(static)
+            for (int i = 0; i < numParticles; i++) {
+                for (int t = 0; t < teamSize; t++) {
+                    forceField[i] += threadForceField[t][i];
+                    torqueField[i] += threadTorqueField[t][i];
+                }
+            }
+        }
+#endif
+    }
+
+
     /* Update positions and orientations (sets calculated next position/orientation
      * calculated by integrator and boundary as current position/orientation). Only
      * updated isparticle is active. Orientation only updated if rotation is active */
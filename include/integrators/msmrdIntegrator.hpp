@@ -9,7 +9,8 @@
 #include "discretizations/positionOrientationPartition.hpp"
 #include "integrators/overdampedLangevinMarkovSwitch.hpp"
 #include "markovModels/msmrdMarkovModel.hpp"
-#include "eventManager.hpp"
+#include "eventStream.hpp"
+#include "pairEventManager.hpp"
 #include "tools.hpp"
 
 namespace msmrd {
@@ -32,8 +33,13 @@ namespace msmrd {
         int numParticleTypes;
         bool firstrun = true;
         bool recordEventLog = false;
+        std::shared_ptr<eventStream> eventOutput;
+        long replicaID = 0;
+        neighborList candidatePairs = neighborList(1.0, 0.5);
+        boundary *candidatePairsBoundary = nullptr;
+        std::vector<vec3<double>> candidatePositions;
     public:
-        eventManager eventMgr = eventManager();
+        pairEventManager eventMgr = pairEventManager();
         msmrdMarkovModel msmrdMSM;
         //spherePartition *positionPart;
         //fullPartition *positionOrientationPart;
@@ -54,6 +60,14 @@ namespace msmrd {
         * @param firstrun boolean variable to check if the integrator is ran for the first time in a simulation.
         * @param recordEventLog boolean to dump or not dump event list for every time step
         * into eventMgr.eventLog. Useful for debugging, but need to watch out memory if log not dumped fast enough.
+        * @param eventOutput binary stream of the applied events (binding, unbinding and bound2bound), only recorded
+        * if set with setEventStream. Copies of the integrator share the stream (recording is thread safe), so all
+        * the replicas of an ensembleRunner write into one file, and each record carries the replicaID.
+        * @param replicaID replica index set by setReplicaID (zero by default), written into the event records.
+        * @param candidatePairs Verlet list of the pairs closer than radialBounds[1] plus a skin, only these pairs
+        * can be in the transition region. It is only rebuilt once a particle moved more than half the skin.
+        * @param candidatePairsBoundary boundary set in candidatePairs (periodic boxes are wrapped around)
+        * @param candidatePositions buffer of the next positions of the particles used to update candidatePairs
         * @param eventManager class to manage order of events (reactions/transitions).
         * @param markovModel pointer to class msmrdMSMDiscrete, which is the markovModel class specialized for
         * the MSM/RD scheme. It controls the markov Model in the bound state and the msmrd coupling.
@@ -100,6 +114,22 @@ namespace msmrd {
 
         void printEventLog(std::string filename);
 
+        void setEventStream(std::string filename, int bufferSize = 4096);
+
+        void closeEventStream();
+
+        void recordAppliedEvent(const pairEvent &appliedEvent);
+
+        const std::vector<std::array<int, 2>> &getCandidatePairs(std::vector<particle> &parts);
+
+        void setCandidatePairsSkin(double skin) { candidatePairs.setSkin(skin); }
+
+        int getNumberOfCandidatePairsRebuilds() const { return candidatePairs.getNumberOfRebuilds(); }
+
+        void setRandomGenerator(std::string backend) override;
+
+        void setReplicaID(long replicaID) override;
+
 
         /* Main MSM/RD function. They are defined as virtual in case we want to override them in derived classes
          * to modify fucntionality */
@@ -190,6 +220,67 @@ namespace msmrd {
         positionOrientationPart = thisFullPartition;
     }
 
+    // Random number generator settings, also used by the MSM/RD Markov model
+    template <typename templateMSM>
+    void msmrdIntegrator<templateMSM>::setRandomGenerator(std::string backend) {
+        overdampedLangevinMarkovSwitch<templateMSM>::setRandomGenerator(backend);
+        msmrdMSM.setRandomGenerator(backend);
+    }
+
+    template <typename templateMSM>
+    void msmrdIntegrator<templateMSM>::setReplicaID(long replicaID) {
+        overdampedLangevinMarkovSwitch<templateMSM>::setReplicaID(replicaID);
+        msmrdMSM.setReplicaID(replicaID);
+        this->replicaID = replicaID;
+    }
+
+    /* Records the applied events (binding, unbinding and bound2bound) into the binary file filename.bin, as fixed
+     * size records (see eventRecord). Unlike the event log, the memory used is bounded and the file is written by a
+     * background thread. */
+    template <typename templateMSM>
+    void msmrdIntegrator<templateMSM>::setEventStream(std::string filename, int bufferSize) {
+        closeEventStream();
+        eventOutput = std::make_shared<eventStream>(filename + ".bin", bufferSize);
+    }
+
+    // Writes all the recorded events and closes the binary event stream
+    template <typename templateMSM>
+    void msmrdIntegrator<templateMSM>::closeEventStream() {
+        if (eventOutput) {
+            auto closingOutput = std::move(eventOutput);
+            closingOutput->close();
+        }
+    }
+
+    /* Returns the sorted list of pairs (i,j), i<j, that can be in the transition region, i.e. it includes all the
+     * pairs with relative distance smaller than radialBounds[1]. Uses the next positions, as
+     * computeCurrentTransitionState does. */
+    template <typename templateMSM>
+    const std::vector<std::array<int, 2>> &msmrdIntegrator<templateMSM>::getCandidatePairs(
+            std::vector<particle> &parts) {
+        if (this->boundaryActive and this->domainBoundary != candidatePairsBoundary) {
+            candidatePairsBoundary = this->domainBoundary;
+            candidatePairs.setBoundary(candidatePairsBoundary);
+        }
+        if (candidatePairs.getCutOff() != radialBounds[1]) {
+            candidatePairs.setCutOff(radialBounds[1]);
+        }
+        candidatePositions.resize(parts.size());
+        for (size_t i = 0; i < parts.size(); i++) {
+            candidatePositions[i] = parts[i].nextPosition;
+        }
+        return candidatePairs.update(candidatePositions);
+    }
+
+    // Records an applied event into the binary event stream (if set) with the exact time it happened
+    template <typename templateMSM>
+    void msmrdIntegrator<templateMSM>::recordAppliedEvent(const pairEvent &appliedEvent) {
+        if (eventOutput) {
+            eventOutput->record(this->clock + appliedEvent.time - eventMgr.getCurrentTime(), appliedEvent,
+                                static_cast<std::int32_t>(replicaID));
+        }
+    }
+
     // Prints eventlog by invoking method from eventMgr into file filename.dat
     template <typename templateMSM>
     void msmrdIntegrator<templateMSM>::printEventLog(std::string filename) {
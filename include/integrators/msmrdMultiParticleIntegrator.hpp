@@ -4,6 +4,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <deque>
+#include <set>
+#include <stdexcept>
 #include "integrators/msmrdIntegrator.hpp"
 #include "trajectories/discrete/discreteTrajectory.hpp"
 #include "trajectories/discrete/patchyDimerTrajectory.hpp"
@@ -15,6 +19,21 @@ namespace msmrd {
     using ctmsm = msmrd::continuousTimeMarkovStateModel;
     using fullPartition = msmrd::positionOrientationPartition;
 
+    /**
+     * Closed binding loop formed by a binding event in multiparticle MSM/RD
+     * @param time time of the binding event that closed the loop (clock of the integrator)
+     * @param loopSize size of the loop (see findClosedBindingLoops)
+     * @param iIndex, jIndex indexes of the particles whose binding closed the loop
+     * @param compoundIndex index of the compound that contains the loop at the time of the binding
+     */
+    struct ringFormationEvent {
+        double time;
+        int loopSize;
+        int iIndex;
+        int jIndex;
+        int compoundIndex;
+    };
+
     /**
      * Class for multi-particle msmrd integration based on patchy particles. Uses base functionality from
      * msmrdIntegrator, but extends its methods for multiparticle MSM/RD integration.
@@ -96,7 +115,25 @@ namespace msmrd {
 
         int getCompoundSize(int compoundIndex);
 
+        int getNumberOfRingFormations() const { return static_cast<int>(ringFormations.size()); }
+
+        ringFormationEvent popRingFormation();
+
+        void clearRingFormations() { ringFormations.clear(); }
+
     protected:
+        std::set<int> closedCompounds;
+        std::deque<ringFormationEvent> ringFormations;
+        std::vector<double> compoundNoise;
+        /**
+         * @param closedCompounds indexes of the active compounds with a closed binding loop (or five particles, see
+         * findClosedBindingLoops). It is updated on every binding, so findClosedBindingLoops doesn't need to check
+         * all the compounds.
+         * @param ringFormations queue of the binding events that closed a loop, in the order they happened. Only
+         * bindings between two particles of the same compound can close a loop.
+         * @param compoundNoise normal random numbers of one time step for the diffusion of the compounds, six per
+         * compound (translation followed by rotation)
+         */
 
         /* Auxiliary functions used by functions above */
 
@@ -110,6 +147,12 @@ namespace msmrd {
 
         void closeCompound(std::vector<particle> &parts, int mainIndex, int secondIndex, int endState);
 
+        std::vector<int> getClosedBindingLoops(std::vector<particle> &parts, int compoundIndex);
+
+        bool isClosedCompound(std::vector<particle> &parts, int compoundIndex);
+
+        void updateClosedCompounds(std::vector<particle> &parts, int iIndex, int jIndex, bool closingBinding);
+
 
 //        quaternion<double> getParticleCompoundOrientation(particle &mainParticle);
 
@@ -151,13 +194,26 @@ namespace msmrd {
      * functions in header). */
     template <typename templateMSM>
     void msmrdMultiParticleIntegrator<templateMSM>::integrateDiffusionCompounds(std::vector<particle> &parts, double dt0){
-        for (auto &particleCompound : particleCompounds) {
+        // Draw the noise of all the compounds at once (the counter-based generator draws it compound by compound)
+        bool counterBased = integrator::randg.isCounterBased();
+        compoundNoise.resize(6 * particleCompounds.size());
+        if (not counterBased) {
+            integrator::randg.fillNormal(compoundNoise, 0, 1);
+        }
+        for (int i = 0; i < particleCompounds.size(); i++) {
+            auto &particleCompound = particleCompounds[i];
             if (particleCompound.isActive()) {
+                const double *noise = &compoundNoise[6 * i];
+                if (counterBased) {
+                    // Compounds use the random streams after the ones of the particles
+                    integrator::setRandomSubstream(static_cast<int>(parts.size()) + i);
+                    integrator::randg.fillNormal(&compoundNoise[6 * i], 6, 0, 1);
+                }
                 // Calculate change in position
-                vec3<double> dr = std::sqrt(2 * dt0 * particleCompound.D) * integrator::randg.normal3D(0, 1);
+                vec3<double> dr = std::sqrt(2 * dt0 * particleCompound.D) * vec3<double>(noise[0], noise[1], noise[2]);
                 // Calculate change in orientation
                 vec3<double> dphi = std::sqrt(2 * dt0 * particleCompound.Drot) *
-                                    integrator::randg.normal3D(0, 1);
+                                    vec3<double>(noise[3], noise[4], noise[5]);
                 quaternion<double> dquat = msmrdtools::axisangle2quaternion(dphi);
                 // Update position and orientation of particles in compound
                 updateParticlesInCompound(parts, particleCompound, dr, dquat);
@@ -183,6 +239,8 @@ namespace msmrd {
         int mainIndex = 1 * iIndex;
         int secondIndex = 1 * jIndex;
         int endStateIndex = endState - 1;
+        bool closingBinding = parts[iIndex].compoundIndex != -1 and
+                              parts[iIndex].compoundIndex == parts[jIndex].compoundIndex;
         // If neither particle belongs to a compound, create one.
         if (parts[iIndex].compoundIndex == -1 and parts[jIndex].compoundIndex == -1) {
             createCompound(parts, mainIndex, secondIndex, endState);
@@ -208,6 +266,7 @@ namespace msmrd {
         else {
             closeCompound(parts, mainIndex, secondIndex, endState);
         }
+        updateClosedCompounds(parts, iIndex, jIndex, closingBinding);
     };
 
     /* Updates particles positions and orientations in a compound that diffused by deltar and rotated by deltaq */
@@ -278,36 +337,44 @@ namespace msmrd {
                 }
             }
         }
+        // Readjust the indexes of the compounds with closed loops
+        closedCompounds.clear();
+        for (int index = 0; index < particleCompounds.size(); index++) {
+            if (isClosedCompound(parts, index)) {
+                closedCompounds.insert(index);
+            }
+        }
     };
 
     /* Checks if there is any closed binding loop in any of the particle compounds. If so, it returns the size of
-     * the loops found in a vector of integers, which size is the number of loops */
+     * the loops found in a vector of integers, which size is the number of loops. A compound of five particles
+     * also counts as a pentameric loop, even if it is still open. Only the compounds with a closed loop are
+     * checked, they are tracked on every binding (see updateClosedCompounds). */
     template <typename templateMSM>
     std::vector<int> msmrdMultiParticleIntegrator<templateMSM>::findClosedBindingLoops(std::vector<particle> &parts){
         std::vector<int> boundLoops = {};
-        for (auto &particleCompound : particleCompounds) {
-            if (particleCompound.active) {
-                auto compoundSize = particleCompound.getSizeOfCompound();
-                auto numBindings = particleCompound.getNumberOfbindings();
-                if (compoundSize == numBindings) {
-                    boundLoops.push_back(numBindings);
-                }
-                // Check for two-particle closed loop bindings (will not appear with method below )
-                if (compoundSize == 2){
-                    auto particleIndexes = particleCompound.boundPairsDictionary.begin()->first;
-                    auto iIndex = std::get<0>(particleIndexes);
-                    if (parts[iIndex].boundList[0] == parts[iIndex].boundList[1]) {
-                        boundLoops.push_back(2);
-                    }
-                }
-                if (compoundSize == 5){
-                    boundLoops.push_back(compoundSize);
-                }
+        for (auto compoundIndex : closedCompounds) {
+            auto compoundLoops = getClosedBindingLoops(parts, compoundIndex);
+            boundLoops.insert(boundLoops.end(), compoundLoops.begin(), compoundLoops.end());
+            if (particleCompounds[compoundIndex].active and getCompoundSize(compoundIndex) == 5) {
+                boundLoops.push_back(5);
             }
         }
         return boundLoops;
     };
 
+    /* Removes and returns the oldest binding event that closed a loop. The events are recorded when the binding
+     * happens, so polling them gives the exact ring formation times without checking the compounds. */
+    template <typename templateMSM>
+    ringFormationEvent msmrdMultiParticleIntegrator<templateMSM>::popRingFormation() {
+        if (ringFormations.empty()) {
+            throw std::out_of_range("No ring formation events left in the queue");
+        }
+        auto ringFormation = ringFormations.front();
+        ringFormations.pop_front();
+        return ringFormation;
+    };
+
     /* Extracts number of bindings in a compound indexed by compoundIndex */
     template <typename templateMSM>
     int msmrdMultiParticleIntegrator<templateMSM>::getNumberOfBindingsInCompound(int compoundIndex) {
@@ -585,6 +652,67 @@ namespace msmrd {
 
 
 
+    /* Returns the sizes of the closed binding loops in the compound with index compoundIndex (empty if it has
+     * none or it is inactive) */
+    template <typename templateMSM>
+    std::vector<int> msmrdMultiParticleIntegrator<templateMSM>::getClosedBindingLoops(std::vector<particle> &parts,
+                                                                                     int compoundIndex) {
+        std::vector<int> boundLoops = {};
+        auto &particleCompound = particleCompounds[compoundIndex];
+        if (particleCompound.active) {
+            auto compoundSize = particleCompound.getSizeOfCompound();
+            auto numBindings = particleCompound.getNumberOfbindings();
+            if (compoundSize == numBindings) {
+                boundLoops.push_back(numBindings);
+            }
+            // Check for two-particle closed loop bindings (will not appear with method below )
+            if (compoundSize == 2){
+                auto particleIndexes = particleCompound.boundPairsDictionary.begin()->first;
+                auto iIndex = std::get<0>(particleIndexes);
+                auto &boundList = parts[iIndex].boundList;
+                if (boundList.size() > 1 and boundList[0] == boundList[1]) {
+                    boundLoops.push_back(2);
+                }
+            }
+        }
+        return boundLoops;
+    }
+
+    /* Checks if the compound with index compoundIndex is active and has a closed binding loop or five particles,
+     * so it is reported by findClosedBindingLoops. */
+    template <typename templateMSM>
+    bool msmrdMultiParticleIntegrator<templateMSM>::isClosedCompound(std::vector<particle> &parts,
+                                                                     int compoundIndex) {
+        return particleCompounds[compoundIndex].active and (getCompoundSize(compoundIndex) == 5 or
+                                                            not getClosedBindingLoops(parts, compoundIndex).empty());
+    }
+
+    /* Updates the compounds with closed loops after the binding of iIndex and jIndex (see addCompound). Only the
+     * compound of the binding can change: it can close a loop or grow, or it can absorb another compound (which is
+     * deactivated). The binding is recorded in the ring formations queue only if it closed a loop, i.e. if both
+     * particles were already in the same compound (closingBinding); joining compounds never closes a loop. */
+    template <typename templateMSM>
+    void msmrdMultiParticleIntegrator<templateMSM>::updateClosedCompounds(std::vector<particle> &parts, int iIndex,
+                                                                          int jIndex, bool closingBinding) {
+        for (auto it = closedCompounds.begin(); it != closedCompounds.end();) {
+            if (particleCompounds[*it].active) {
+                ++it;
+            } else {
+                it = closedCompounds.erase(it);
+            }
+        }
+        int compoundIndex = parts[iIndex].compoundIndex;
+        if (isClosedCompound(parts, compoundIndex)) {
+            closedCompounds.insert(compoundIndex);
+        }
+        auto boundLoops = getClosedBindingLoops(parts, compoundIndex);
+        if (closingBinding and not boundLoops.empty()) {
+            auto loopSize = *std::max_element(boundLoops.begin(), boundLoops.end());
+            ringFormations.push_back({integrator::clock, loopSize, iIndex, jIndex, compoundIndex});
+        }
+    }
+
+
 //    /* Recovers the rotation quaternion for the particle compound based on the reference particle of the compound. It
 //     * assumer the center of the compound is the center of a pentamer formation, so this is estremely dependent on the
 //     * specific application. */
@@ -3,16 +3,76 @@
 //
 
 #pragma once
+#include <utility>
 #include "integrators/integrator.hpp"
 #include "particle.hpp"
 #include "potentials/potentials.hpp"
 
 namespace msmrd {
     /**
-     * Over-damped Langevin integrator declaration (a.k.a. standard Brownian motion)
+     * Over-damped Langevin integrator declaration (a.k.a. standard Brownian motion). Optionally with adaptive time
+     * stepping: each call to integrate still advances the clock by dt (so trajectories are sampled as with the fixed
+     * time step), but the step is covered by internal steps whose length is controlled by a local error estimate.
      */
     class overdampedLangevin : public integrator {
     protected:
+        std::vector<double> noiseBuffer;
+        size_t noiseIndex = 0;
+        size_t noiseEnd = 0;
+        /**
+         * @param noiseBuffer normal random numbers of one time step, drawn in one call before integrating the
+         * particles: three per particle for translation followed by three for rotation (if active).
+         * @param noiseIndex next unused entry in noiseBuffer. If the buffer is exhausted (e.g. integrators with
+         * a variable number of substeps per particle), the noise is drawn from randg directly.
+         * @param noiseEnd end of the entries of noiseBuffer available to getNoise (the whole buffer after
+         * drawNoise, the noise of one particle after selectParticleNoise)
+         */
+
+        // Adaptive time stepping variables
+        bool adaptiveTimeStepping = false;
+        double errorTolerance = 1e-3;
+        double minTimestep = 0.0;
+        double trialTimestep = 0.0;
+        long numAcceptedSteps = 0;
+        long numRejectedSteps = 0;
+        std::vector<std::pair<double, std::vector<double>>> brownianIncrements;
+        std::vector<vec3<double>> startPositions;
+        std::vector<quaternion<double>> startOrientations;
+        std::vector<vec3<double>> startOrientvectors;
+        std::vector<char> startActive;
+        std::vector<vec3<double>> startForceField;
+        std::vector<vec3<double>> startTorqueField;
+        /**
+         * @param adaptiveTimeStepping if true, every call to integrate advances the clock by dt in internal steps
+         * of variable length (see integrateAdaptive)
+         * @param errorTolerance maximum local error of the internal steps, in units of length for the positions
+         * and in radians for the orientations
+         * @param minTimestep internal steps are never shortened below this value (accepted regardless of the error)
+         * @param trialTimestep length of the next internal step, kept between calls to integrate
+         * @param numAcceptedSteps/numRejectedSteps internal steps accepted and rejected so far
+         * @param brownianIncrements stack of pending subintervals of the current time step, with their length
+         * and Brownian increments (three per particle for translation followed by three for rotation, if active)
+         * @param start*** state and forces/torques of the particles at the beginning of the current internal step,
+         * to retry it if it is rejected
+         */
+
+        void drawNoise(int numParticles);
+
+        void drawParticleNoise(int numParticles);
+
+        void selectParticleNoise(int partIndex);
+
+        vec3<double> getNoise();
+
+        void integrateAdaptive(std::vector<particle> &parts);
+
+        void integrateHalfStep(std::vector<particle> &parts, double halfstep, const std::vector<vec3<double>> &forces,
+                               const std::vector<vec3<double>> &torques, const std::vector<double> &increments);
+
+        void saveStartState(const std::vector<particle> &parts);
+
+        void restoreStartState(std::vector<particle> &parts);
+
         void integrateOne(int partIndex, std::vector<particle> &parts, double timestep) override;
 
         void translate(particle &part, vec3<double> force, double dt) override;
@@ -21,6 +81,18 @@ namespace msmrd {
 
     public:
         overdampedLangevin(double dt, long seed, std::string particlesbodytype);
+
+        void integrate(std::vector<particle> &parts) override;
+
+        virtual void setAdaptiveTimeStepping(double tolerance, double minimumTimestep);
+
+        void disableAdaptiveTimeStepping() { adaptiveTimeStepping = false; }
+
+        bool isAdaptiveTimeStepping() const { return adaptiveTimeStepping; }
+
+        long getNumAcceptedSteps() const { return numAcceptedSteps; }
+
+        long getNumRejectedSteps() const { return numRejectedSteps; }
     };
 
 }
\ No newline at end of file
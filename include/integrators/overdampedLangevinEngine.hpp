@@ -0,0 +1,212 @@
+//
+// Created by maojrs on 3/16/20.
+//
+
+#pragma once
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include "boundaries/boundary.hpp"
+#include "integrators/overdampedLangevin.hpp"
+
+namespace msmrd {
+    /**
+     * Body type policies for overdampedLangevinEngine, they fix at compile time if the orientation (and the
+     * orientation vector of rod-like particles) is integrated.
+     */
+    struct pointBody {
+        static constexpr bool rotation = false;
+        static constexpr bool orientvector = false;
+        static std::string name() { return "point"; }
+    };
+
+    struct rodBody {
+        static constexpr bool rotation = true;
+        static constexpr bool orientvector = true;
+        static std::string name() { return "rod"; }
+    };
+
+    struct rigidBody {
+        static constexpr bool rotation = true;
+        static constexpr bool orientvector = false;
+        static std::string name() { return "rigidbody"; }
+    };
+
+
+    /**
+     * Boundary policies for overdampedLangevinEngine. They are constructed from the integrator boundary at
+     * every time step (throwing if it doesn't match the policy). The function enforce acts on the next position
+     * of an active particle, as boundary::enforceBoundary, and returns false if the particle left the domain.
+     */
+    class noBoundaryPolicy {
+    public:
+        noBoundaryPolicy(bool boundaryActive, boundary *domainBoundary) {
+            if (boundaryActive and domainBoundary->getBoundaryType() != "none") {
+                throw std::invalid_argument("Integrator boundary doesn't match the noBoundaryPolicy of the engine");
+            }
+        };
+
+        bool enforce(particle &) const { return true; }
+    };
+
+    // Periodic box, inlined version of box::enforcePeriodicBoundary
+    class periodicBoxPolicy {
+    private:
+        vec3<double> boxsize;
+    public:
+        periodicBoxPolicy(bool boundaryActive, boundary *domainBoundary) {
+            if (not boundaryActive or domainBoundary->getBoundaryType() != "periodic" or
+                domainBoundary->boxsize.normSquared() == 0) {
+                throw std::invalid_argument("Integrator boundary must be a periodic box to use the periodicBoxPolicy"
+                                            " of the engine");
+            }
+            boxsize = domainBoundary->boxsize;
+        };
+
+        bool enforce(particle &part) const {
+            for (int i = 0; i < 3; i++) {
+                if (part.nextPosition[i] >= boxsize[i] / 2) { part.nextPosition[i] -= boxsize[i]; }
+                if (part.nextPosition[i] <= -boxsize[i] / 2) { part.nextPosition[i] += boxsize[i]; }
+            }
+            return true;
+        }
+    };
+
+    // Any boundary (e.g. reflective or open), calls the virtual functions of the boundary
+    class genericBoundaryPolicy {
+    private:
+        boundary *domainBoundary;
+        bool boundaryActive;
+    public:
+        genericBoundaryPolicy(bool boundaryActive, boundary *domainBoundary)
+                : domainBoundary(domainBoundary), boundaryActive(boundaryActive) {};
+
+        bool enforce(particle &part) const {
+            if (boundaryActive) {
+                domainBoundary->enforceBoundary(part);
+            }
+            return part.isActive();
+        }
+    };
+
+
+    /**
+     * Over-damped Langevin integrator specialized at compile time for a pair potential, boundary and body type.
+     * The main loop calls the pair potential, boundary and translation/rotation functions without virtual
+     * dispatch, so the compiler can inline the ones implemented in headers (boundary and body type policies,
+     * relative positions and e.g. harmonicRepulsion::forceTorque); the pair potentials implemented in the core
+     * library are still direct calls, optimized with interprocedural optimization (see CMakeLists.txt) but not
+     * inlined into this loop. It is still an integrator, so it can be used wherever the generic
+     * overdampedLangevin is used (simulation class, python bindings). It yields the same trajectories as
+     * overdampedLangevin with the same seed.
+     * @tparam POTENTIAL concrete pair potential class (e.g. patchyParticleAngular2); the pair potential set in
+     * the integrator must be of this type (or a child class, which then uses the POTENTIAL functions)
+     * @tparam BOUNDARY boundary policy (noBoundaryPolicy, periodicBoxPolicy or genericBoundaryPolicy)
+     * @tparam BODYTYPE body type policy (pointBody, rodBody or rigidBody)
+     */
+    template <typename POTENTIAL, typename BOUNDARY, typename BODYTYPE>
+    class overdampedLangevinEngine : public overdampedLangevin {
+    protected:
+        void calculatePairsForceTorquesStatic(std::vector<particle> &parts, POTENTIAL &potential);
+
+    public:
+        overdampedLangevinEngine(double dt, long seed) : overdampedLangevin(dt, seed, BODYTYPE::name()) {};
+
+        void integrate(std::vector<particle> &parts) override;
+
+        // The engine integrates fixed time steps, adaptive time stepping is not supported
+        void setAdaptiveTimeStepping(double, double) override {
+            throw std::invalid_argument("Adaptive time stepping is not supported by the overdamped Langevin engine");
+        }
+    };
+
+
+    template <typename POTENTIAL, typename BOUNDARY, typename BODYTYPE>
+    void overdampedLangevinEngine<POTENTIAL, BOUNDARY, BODYTYPE>::integrate(std::vector<particle> &parts) {
+        int numParticles = static_cast<int>(parts.size());
+        BOUNDARY boundaryPolicy(boundaryActive, domainBoundary);
+
+        /* Calculate forces and torques, the pair forces are calculated with the concrete potential (the
+         * threaded version of the generic integrator is used if several threads were requested). */
+        if (pairPotentialActive and numThreads == 1) {
+            auto potential = dynamic_cast<POTENTIAL *>(pairPot);
+            if (potential == nullptr) {
+                throw std::invalid_argument("Pair potential doesn't match the potential type of the engine");
+            }
+            forceField.resize(numParticles);
+            torqueField.resize(numParticles);
+            if (externalPotentialActive) {
+                calculateExternalForceTorques(parts, numParticles);
+            } else {
+                std::fill(forceField.begin(), forceField.end(), vec3<double>(0, 0, 0));
+                std::fill(torqueField.begin(), torqueField.end(), vec3<double>(0, 0, 0));
+            }
+            calculatePairsForceTorquesStatic(parts, *potential);
+        } else {
+            calculateForceTorqueFields(parts);
+        }
+
+        // Integrate, enforce boundary and update position/orientation of each particle
+        drawNoise(numParticles);
+        for (int i = 0; i < numParticles; i++) {
+            auto &part = parts[i];
+            vec3<double> dr = forceField[i] * dt * part.D / KbTemp + std::sqrt(2 * dt * part.D) * getNoise();
+            part.nextPosition = part.position + dr;
+            if (BODYTYPE::rotation) {
+                vec3<double> dphi = torqueField[i] * dt * part.Drot / KbTemp +
+                        std::sqrt(2 * dt * part.Drot) * getNoise();
+                quaternion<double> dquat = msmrdtools::axisangle2quaternion(dphi);
+                part.nextOrientation = dquat * part.orientation;
+                if (BODYTYPE::orientvector) {
+                    part.nextOrientvector = msmrdtools::rotateVec(part.orientvector, dquat);
+                }
+            }
+            if (part.isActive() and boundaryPolicy.enforce(part)) {
+                part.position = part.nextPosition;
+                if (BODYTYPE::rotation) {
+                    part.orientvector = part.nextOrientvector;
+                    part.orientation = part.nextOrientation;
+                }
+            }
+        }
+        noiseBuffer.clear();
+        clock += dt;
+    }
+
+    /* Same as integrator::calculatePairsForceTorques, but calling the forceTorque function of the concrete
+     * potential directly (qualified call, so no virtual dispatch). */
+    template <typename POTENTIAL, typename BOUNDARY, typename BODYTYPE>
+    void overdampedLangevinEngine<POTENTIAL, BOUNDARY, BODYTYPE>::calculatePairsForceTorquesStatic(
+            std::vector<particle> &parts, POTENTIAL &potential) {
+        std::array<vec3<double>, 4> forctorq;
+        if (not sharedPotentials) {
+            potential.POTENTIAL::precompute(parts);
+        }
+        double cutOff = potential.POTENTIAL::getCutOff();
+        bool useNeighborList = neighborListActive and std::isfinite(cutOff);
+        if (useNeighborList) {
+            if (cutOff != neighbors.getCutOff()) {
+                neighbors.setCutOff(cutOff);
+            }
+            for (auto &pair : neighbors.getNeighborPairs(parts)) {
+                forctorq = potential.POTENTIAL::forceTorque(parts[pair[0]], parts[pair[1]]);
+                forceField[pair[0]] += forctorq[0];
+                torqueField[pair[0]] += forctorq[1];
+                forceField[pair[1]] += forctorq[2];
+                torqueField[pair[1]] += forctorq[3];
+            }
+            return;
+        }
+        int numParticles = static_cast<int>(parts.size());
+        for (int i = 0; i < numParticles; i++) {
+            for (int j = i + 1; j < numParticles; j++) {
+                forctorq = potential.POTENTIAL::forceTorque(parts[i], parts[j]);
+                forceField[i] += forctorq[0];
+                torqueField[i] += forctorq[1];
+                forceField[j] += forctorq[2];
+                torqueField[j] += forctorq[3];
+            }
+        }
+    }
+
+}
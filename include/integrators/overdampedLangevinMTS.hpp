@@ -0,0 +1,38 @@
+//
+// Created by maojrs on 3/30/20.
+//
+
+#pragma once
+#include "integrators/overdampedLangevin.hpp"
+
+namespace msmrd {
+    /**
+     * Multiple time step (RESPA-like) over-damped Langevin integrator. The pair interaction is split into slow
+     * and fast parts (see pairPotential::forceTorqueSlow and forceTorqueFast). Every time step dt, the particles
+     * are first moved by the slow forces (external and slow pair interactions) and the noise over the whole time
+     * step, like in overdampedLangevin. Then the stiff fast forces are integrated in numSubsteps deterministic
+     * substeps of length dt/numSubsteps. The boundary is enforced after every (sub)step. If the pair potential
+     * has no fast part, the trajectories are the same as the ones of overdampedLangevin with the same seed.
+     */
+    class overdampedLangevinMTS : public overdampedLangevin {
+    protected:
+        int numSubsteps;
+        /**
+         * @param numSubsteps number of substeps to integrate the fast forces in every time step
+         */
+
+        void integrateFastSubstep(std::vector<particle> &parts, double substep);
+
+    public:
+        overdampedLangevinMTS(double dt, long seed, std::string particlesbodytype, int numSubsteps);
+
+        void integrate(std::vector<particle> &parts) override;
+
+        void setAdaptiveTimeStepping(double tolerance, double minimumTimestep) override;
+
+        void setNumSubsteps(int newNumSubsteps);
+
+        int getNumSubsteps() const { return numSubsteps; }
+    };
+
+}
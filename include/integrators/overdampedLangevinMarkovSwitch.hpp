@@ -3,6 +3,9 @@
 //
 
 #pragma once
+#include <limits>
+#include <stdexcept>
+#include "indexedPriorityQueue.hpp"
 #include "integrators/overdampedLangevin.hpp"
 #include "particle.hpp"
 #include "markovModels/discreteTimeMarkovModel.hpp"
@@ -20,9 +23,31 @@ namespace msmrd {
     class overdampedLangevinMarkovSwitch : public overdampedLangevin {
     protected:
         std::string msmtype;
+        bool eventDrivenSwitching = false;
+        indexedPriorityQueue switchingQueue;
+        const particle *switchingParticles = nullptr;
+        size_t numSwitchingParticles = 0;
+        /**
+         * @param eventDrivenSwitching if true, the next switching times of all the particles are kept in
+         * switchingQueue, and only the particles that switch in the current time step are propagated by the MSM.
+         * @param switchingQueue indexed priority queue of the (absolute) times of the next switch of the particles
+         * with an active MSM, used in event driven switching. The times are shifted when the clock is set.
+         * @param switchingParticles, numSwitchingParticles data pointer and size of the particle list of
+         * switchingQueue; the queue is built again for a different particle list.
+         */
 
         void integrateOneMS(int partIndex, std::vector<particle> &parts, double timestep);
 
+        void integrateEventDriven(std::vector<particle> &parts);
+
+        void integrateOneSwitching(int partIndex, std::vector<particle> &parts, double timestep);
+
+        void scheduleSwitch(int partIndex, std::vector<particle> &parts);
+
+        void updateSwitchingQueue(std::vector<particle> &parts);
+
+        void synchronizeLagtimes(std::vector<particle> &parts);
+
     public:
         std::vector<templateMSM> MSMlist;
         /**
@@ -41,6 +66,26 @@ namespace msmrd {
 
 
         void integrate(std::vector<particle> &parts) override;
+
+        // The MSMs are propagated in fixed time steps, adaptive time stepping is not supported
+        void setAdaptiveTimeStepping(double, double) override {
+            throw std::invalid_argument("Adaptive time stepping is not supported by the Markov switch integrator");
+        }
+
+        void setEventDrivenSwitching(bool eventDriven) { eventDrivenSwitching = eventDriven; }
+
+        bool isEventDrivenSwitching() const { return eventDrivenSwitching; }
+
+        double getNextSwitchTime(int partIndex) const {
+            return switchingQueue.contains(partIndex) ? switchingQueue.getKey(partIndex) :
+                   std::numeric_limits<double>::infinity();
+        }
+
+        void setClock(double newTime) override;
+
+        void setRandomGenerator(std::string backend) override;
+
+        void setReplicaID(long replicaID) override;
     };
 
 
@@ -58,4 +103,30 @@ namespace msmrd {
         msmtype = typeid(templateMSM).name(); // gives somewhat human readable name
     };
 
+    /* Sets the clock and shifts the switching times in the switching queue by the same amount, so the time left
+     * until the next switch of each particle is kept (also used by resetClock). */
+    template<typename templateMSM>
+    void overdampedLangevinMarkovSwitch<templateMSM>::setClock(double newTime) {
+        switchingQueue.shiftKeys(newTime - clock);
+        clock = newTime;
+    }
+
+    /* The switching times are drawn from the integrator random streams (see integrateOneMS), but the MSMs can still
+     * draw their own random numbers (e.g. propagating them directly), so they also use the generator and replica */
+    template<typename templateMSM>
+    void overdampedLangevinMarkovSwitch<templateMSM>::setRandomGenerator(std::string backend) {
+        overdampedLangevin::setRandomGenerator(backend);
+        for (auto &thisMSM : MSMlist) {
+            thisMSM.setRandomGenerator(backend);
+        }
+    }
+
+    template<typename templateMSM>
+    void overdampedLangevinMarkovSwitch<templateMSM>::setReplicaID(long replicaID) {
+        overdampedLangevin::setReplicaID(replicaID);
+        for (auto &thisMSM : MSMlist) {
+            thisMSM.setReplicaID(replicaID);
+        }
+    }
+
 }
\ No newline at end of file
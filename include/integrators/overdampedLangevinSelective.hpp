@@ -2,6 +2,7 @@
 // Created by maojrs on 10/15/20.
 //
 #pragma once
+#include "bondGraph.hpp"
 #include "integrators/overdampedLangevin.hpp"
 #include "trajectories/discrete/discreteTrajectory.hpp"
 #include "trajectories/discrete/patchyDimerTrajectory.hpp"
@@ -42,17 +43,44 @@ namespace msmrd {
 
         void integrate(std::vector<particle> &parts) override;
 
+        void setAdaptiveTimeStepping(double tolerance, double minimumTimestep) override;
+
         void updateParticleCompounds(std::vector<particle> &parts);
 
         std::vector<int> findClosedBindingLoops(std::vector<particle> &parts);
 
         int getCompoundSize(int compoundIndex);
 
+        int getParticleCompoundSize(int partIndex);
+
 
         // int hasRingFormed(std::vector<particle> &parts);
 
     protected:
         std::vector<bool> referenceCondition = std::vector<bool>(5, true);
+        neighborList boundPairsNeighbors = neighborList(1.25, 0.0);
+        std::vector<std::array<int, 3>> boundPatchPairs;
+        std::vector<std::array<int, 3>> newBoundPatchPairs;
+        bondGraph bondedParticles;
+        const particle *boundPairsParticles = nullptr;
+        size_t numBoundPairsParticles = 0;
+        bool activePatchesOutdated = true;
+        /**
+         * @param boundPairsNeighbors cell list to find the pairs closer than the bound region radius of patchyTraj,
+         * only these pairs can be in a bound state.
+         * @param boundPatchPairs pairs (i, j, state) in a bound state in the last call of updateBoundPairs, sorted
+         * by particle indexes.
+         * @param newBoundPatchPairs buffer to find the bound pairs in the current time step
+         * @param bondedParticles graph of the bound pairs in boundPatchPairs, it keeps track of the compounds and
+         * rings. It is only updated with the pairs that bind or unbind between calls of updateBoundPairs.
+         * @param boundPairsParticles, numBoundPairsParticles data pointer and size of the particle list of
+         * boundPatchPairs; the bound pairs and the graph are built from scratch for a different particle list.
+         * @param activePatchesOutdated true if boundPatchPairs changed since the active patches were last assigned.
+         */
+
+        void findBoundPatchPairs(std::vector<particle> &parts);
+
+        void updateBoundPairs(std::vector<particle> &parts);
 
         void setActivePatches(std::vector<particle> &parts);
     };
@@ -16,6 +16,8 @@ namespace msmrd {
 
         void calculateParameters();
 
+        int sampleTransition(int state, double &lagt, randomgen &randgen) const;
+
     public:
         continuousTimeMarkovStateModel(int msmid, long seed);
 
@@ -27,6 +29,8 @@ namespace msmrd {
 
         void propagateNoUpdate(particle &part, int ksteps);
 
+        void propagateNoUpdate(particle &part, int ksteps, randomgen &randgen) const;
+
         // Getters for testing purposes
         std::vector<double> getLambda0() const { return lambda0; };
 
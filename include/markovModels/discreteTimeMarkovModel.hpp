@@ -10,6 +10,9 @@ namespace msmrd {
      * Discrete-time Markov state model class declaration
      */
     class discreteTimeMarkovStateModel : public markovModel {
+    protected:
+        void buildTransitionTables();
+
     public:
 
         discreteTimeMarkovStateModel(int msmid, double lagtime, long seed);
@@ -9,6 +9,31 @@
 #include "randomgen.hpp"
 
 namespace msmrd {
+    /**
+     * Alias table (Walker's alias method with Vose's construction) to sample an index with probability
+     * proportional to a vector of non-negative weights in O(1): one uniform sample chooses a column and whether
+     * to return the column index or its alias. It is built once in O(n). If all the weights are zero, all the
+     * indexes are equally likely.
+     */
+    class aliasTable {
+    protected:
+        std::vector<double> probability;
+        std::vector<int> alias;
+        /**
+         * @param probability probability of returning the column index when the column is chosen
+         * @param alias index returned otherwise
+         */
+    public:
+        aliasTable() = default;
+
+        explicit aliasTable(const std::vector<double> &weights);
+
+        int sample(randomgen &randg) const;
+
+        int size() const { return static_cast<int>(probability.size()); }
+    };
+
+
     /**
      * Abstract base class for Markov state models of particles
      */
@@ -19,6 +44,7 @@ namespace msmrd {
         const long double tolerance = 1 * pow(10.0L, -10);
         long seed;
         randomgen randg;
+        std::vector<aliasTable> transitionTables;
     public:
         double lagtime;
         std::vector<std::vector<double>> tmatrix = {{0.0}};
@@ -30,6 +56,8 @@ namespace msmrd {
          * @param tolerance tolerance limit for MSM integrity check
          * @param seed variable for random number generation; seed = -1 corresponds to random_device;
          * @param randg random number generator class based on mt19937
+         * @param transitionTables alias table of each row of the transition matrix to sample the next state, built
+         * once by the child classes (only valid for the matrix given in the constructor).
          * @param lagtime msm lagtime (in ctmsm it is calculated after each propagation step)
          * @param tmatrix transition matrix (for ctmsm transition rate matrix)
          * @param nstates number of states in the msm (obtained directly from matrix size)
@@ -54,7 +82,7 @@ namespace msmrd {
 
         double getLagtime() const { return lagtime; }
 
-        std::vector<std::vector<double>> getTmatrix() const { return tmatrix; }
+        virtual std::vector<std::vector<double>> getTmatrix() const { return tmatrix; }
 
         void setD(std::vector<double> &D) {
             Dlist.resize(nstates);
@@ -65,6 +93,11 @@ namespace msmrd {
             Drotlist.resize(nstates);
             Drotlist = Drot;
         }
+
+        // Random number generator settings (see randomgen), e.g. to make copies of a model independent
+        void setRandomGenerator(std::string backend) { randg.setBackend(backend); }
+
+        void setReplicaID(long replicaID) { randg.setReplicaID(replicaID); }
     };
 
 
@@ -14,6 +14,24 @@ namespace msmrd {
     protected:
         int numBoundStates;
         unsigned int maxNumberBoundStates;
+        std::vector<int> rowOffsets;
+        std::vector<int> columns;
+        std::vector<double> values;
+        std::vector<int> MSMindexes;
+        /**
+         * @param rowOffsets, columns, values transition matrix in compressed sparse row (CSR) format: the non-zero
+         * probabilities of row i are values[rowOffsets[i]:rowOffsets[i+1]], in the columns with the same indexes.
+         * Only the non-zero probabilities are stored (the dense tmatrix of the parent class is left empty), and
+         * the alias tables of the rows to sample transitions are built over the non-zero probabilities.
+         * @param MSMindexes dense reverse lookup of activeSet, MSMindexes[activeSet[i]] = i and -1 for the
+         * states not in the active set.
+         */
+
+        void setSparseTmatrix(std::vector<int> newRowOffsets, std::vector<int> newColumns,
+                              std::vector<double> newValues);
+
+        void setActiveSet(std::vector<int> newActiveSet);
+
     public:
         std::vector<int> activeSet;
         /**
@@ -26,9 +44,12 @@ namespace msmrd {
          * The transition matrix will only be as large as the number of active sets/states, so the indexing of the
          * transition matrix (tmarix) and the indexing of the discrete trajectories doesn't match. The ith component
          * of this vector yields its corresponding index in the original discrete trajectory. This is usually given
-         * by pyemma when calculating an MSM.
+         * by pyemma when calculating an MSM. It shouldn't be modified after construction, since its reverse lookup
+         * (MSMindexes) is built in the constructor.
          * @param tmatrix transition probability matrix of the MSM. Note the rank is larger than numBoundStates
-         * since it also includes all the transition states
+         * since it also includes all the transition states. It can be given as a dense matrix or in CSR format
+         * (rowOffsets, columns, values), e.g. the indptr, indices and data arrays of a scipy sparse matrix; it is
+         * stored in CSR format in both cases.
          * @param lagtime the lagtime of the discrete time MSM. This should be given in units corresponding to
          * the ones used in the simulation
          */
@@ -37,8 +58,30 @@ namespace msmrd {
                                  std::vector <std::vector<double>> tmatrix, std::vector<int> activeSet,
                                  double lagtime, long seed);
 
+        msmrdMarkovModel(int numBoundStates, int maxNumberBoundStates, std::vector<int> rowOffsets,
+                         std::vector<int> columns, std::vector<double> values, std::vector<int> activeSet,
+                         double lagtime, long seed);
+
+        void propagate(particle &part, int ksteps) override;
+
+        std::tuple<double, int> propagateMSM(int initialState, int ksteps);
+
+        void propagateNoUpdate(particle &part, int ksteps);
+
         std::tuple<double, int> calculateTransition(int initialState);
 
+        std::vector<std::vector<double>> getTmatrix() const override;
+
+        double getTransitionProbability(int MSMindex1, int MSMindex2) const;
+
+        int getNumberOfNonZeros() const { return static_cast<int>(values.size()); }
+
+        std::vector<int> getRowOffsets() const { return rowOffsets; }
+
+        std::vector<int> getColumns() const { return columns; }
+
+        std::vector<double> getValues() const { return values; }
+
         int getActiveSetIndex(int MSMindex);
 
         int getMSMindex(int activeSetIndex);
@@ -0,0 +1,102 @@
+//
+// Created by maojrs on 3/2/20.
+//
+
+#pragma once
+#include <array>
+#include <vector>
+#include "boundaries/boundary.hpp"
+#include "vec3.hpp"
+
+namespace msmrd {
+    /**
+     * Neighbor search for pair interactions with a finite cut off. Particles are binned into a cell list of
+     * cells of length >= cutOff + skin, so only particles in the same or adjacent cells are candidate pairs.
+     * The cell list honors periodic boxes (minimum image convention and wrapping of the adjacent cells). If the
+     * skin is positive, the resulting list of pairs is kept as a Verlet list and only rebuilt once a particle
+     * has moved more than skin/2 since the last build; otherwise the list is rebuilt at every call.
+     */
+    class neighborList {
+    protected:
+        double cutOff;
+        double skin;
+        bool boundaryActive = false;
+        boundary *domainBoundary;
+
+        std::array<int, 3> numCells{};
+        vec3<double> lowerCorner;
+        vec3<double> cellLength;
+        std::vector<int> cellHead;
+        std::vector<int> cellNext;
+        std::vector<std::array<int, 3>> cellCoordinates;
+
+        std::vector<vec3<double>> positions;
+        std::vector<vec3<double>> referencePositions;
+        std::vector<std::array<int, 2>> neighborPairs;
+        bool rebuildRequired = true;
+        int numRebuilds = 0;
+
+        bool isPeriodic() const;
+
+        vec3<double> relativePosition(const vec3<double> &p1, const vec3<double> &p2) const;
+
+        bool isRebuildRequired(const std::vector<vec3<double>> &newPositions);
+
+        void setCellGrid(const std::vector<vec3<double>> &newPositions, double listRadius);
+
+        std::array<int, 3> getCellCoordinates(const vec3<double> &pos) const;
+
+        void buildNeighborPairs(const std::vector<vec3<double>> &newPositions);
+
+    public:
+        /**
+         * @param cutOff interaction range of the pair potential, pairs further apart than cutOff are not listed.
+         * @param skin additional distance added to the cut off to build the Verlet list. A zero skin yields a plain
+         * cell list rebuilt at every call.
+         * @param domainBoundary pointer to the boundary of the integrator; periodic boxes are wrapped around.
+         * @param numCells number of cells along each axis; @param lowerCorner and @param cellLength define the grid.
+         * @param cellHead/cellNext linked lists of the particle indexes in each cell.
+         * @param cellCoordinates cell coordinates of each particle at the last build.
+         * @param positions buffer of the current positions (reused between calls).
+         * @param referencePositions positions at the last build of the list, used to track displacements.
+         * @param neighborPairs sorted list of pairs (i,j), i<j, with relative distance <= cutOff + skin.
+         * @param rebuildRequired forces a rebuild in the next call (e.g. cut off or boundary changed).
+         * @param numRebuilds number of times the list has been rebuilt.
+         */
+        neighborList(double cutOff, double skin);
+
+        template< typename PARTICLE >
+        const std::vector<std::array<int, 2>> &getNeighborPairs(std::vector<PARTICLE> &parts);
+
+        const std::vector<std::array<int, 2>> &update(const std::vector<vec3<double>> &newPositions);
+
+        void setBoundary(boundary *bndry);
+
+        void setCutOff(double newCutOff);
+
+        void setSkin(double newSkin);
+
+        void reset() { rebuildRequired = true; }
+
+        double getCutOff() const { return cutOff; }
+
+        double getSkin() const { return skin; }
+
+        int getNumberOfRebuilds() const { return numRebuilds; }
+
+    };
+
+
+    /* Returns the list of pairs (i,j), i<j, of particles that can interact, the list is sorted so summing the
+     * forces over it follows the same order as the double loop over all pairs. The positions of the particles
+     * are copied into a reusable buffer, so the actual search is not templated. */
+    template< typename PARTICLE >
+    const std::vector<std::array<int, 2>> &neighborList::getNeighborPairs(std::vector<PARTICLE> &parts) {
+        positions.resize(parts.size());
+        for (size_t i = 0; i < parts.size(); i++) {
+            positions[i] = parts[i].position;
+        }
+        return update(positions);
+    }
+
+}
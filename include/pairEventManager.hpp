@@ -0,0 +1,126 @@
+//
+// Created by maojrs on 4/27/20.
+//
+
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "indexedPriorityQueue.hpp"
+
+namespace msmrd {
+    /**
+     * Types of the events in the MSM/RD algorithm: transitioning into a bound state, out of it, within bound
+     * states or within transition states. Events in transition (inTransition) were already applied, but are kept
+     * until their next transition is computed. Empty corresponds to no event.
+     */
+    enum class eventType : std::uint8_t {
+        empty, binding, unbinding, bound2bound, transition2transition, inTransition
+    };
+
+    std::string eventTypeName(eventType type);
+
+    eventType eventTypeFromName(const std::string &name);
+
+    /**
+     * Event of a pair of particles, with the absolute time when it happens (time of the event manager), the
+     * indexes (in the particleList) of the particles involved (part1Index < part2Index always), the origin and
+     * end states of the transition and the event type.
+     */
+    struct pairEvent {
+        double time;
+        int part1Index;
+        int part2Index;
+        int originState;
+        int endState;
+        eventType type;
+    };
+
+
+    /**
+     * Class to manage events (mainly transitions and/or reactions) in MSM/RD algorithm, with at most one event
+     * per pair of particles. The events are found by the pair of indexes packed in a 64-bit key, and they are
+     * ordered by their absolute time in an indexed min-heap. Therefore advancing time is O(1) (the events are
+     * not modified), and getting the k events that are due is O(k log n).
+     */
+    class pairEventManager {
+    protected:
+        std::vector<pairEvent> events;
+        std::vector<int> freeSlots;
+        std::unordered_map<std::uint64_t, int> eventSlots;
+        indexedPriorityQueue eventQueue;
+        double currentTime = 0.0;
+        /**
+         * @param events storage of the events, the slots of removed events are empty events.
+         * @param freeSlots indexes of the empty slots in events, reused by new events.
+         * @param eventSlots slot of the event of each pair of particles, the key is given by pairKey.
+         * @param eventQueue slots of the events that will be applied, ordered by time. Empty and in
+         * transition events are not in the queue.
+         * @param currentTime time of the event manager, advanced by advanceTime.
+         */
+
+        static std::uint64_t pairKey(int part1Index, int part2Index) {
+            return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(part1Index)) << 32) |
+                   static_cast<std::uint32_t>(part2Index);
+        }
+
+        int findSlot(int part1Index, int part2Index) const;
+
+        int allocateSlot();
+
+        void removeSlot(int slot);
+
+    public:
+        pairEvent emptyEvent = {std::numeric_limits<double>::infinity(), -1, -1, -1, -1, eventType::empty};
+        std::vector<std::string> eventLog;
+        /**
+         * @param emptyEvent default empty event, with time = infinity.
+         * @param eventLog can be programmed to keep a log of the events for all or some timesteps.
+         */
+
+        pairEventManager() = default;
+
+        void addEvent(double waitTime, int part1Index, int part2Index,
+                      int originState, int endState, eventType type);
+
+        void removeEvent(int part1Index, int part2Index);
+
+        void advanceTime(double timeStep) { currentTime += timeStep; }
+
+        pairEvent getEvent(int part1Index, int part2Index) const;
+
+        void setEventType(eventType newType, int part1Index, int part2Index);
+
+        double getEventTime(int part1Index, int part2Index) const;
+
+        bool popDueEvent(pairEvent &dueEvent);
+
+        template<typename PREDICATE>
+        void removeEventsIf(PREDICATE predicate);
+
+        void clear();
+
+        int getNumEvents() const { return static_cast<int>(eventSlots.size()); }
+
+        double getCurrentTime() const { return currentTime; }
+
+        void write2EventLog(int timeIteration);
+
+        void printEventLog(std::string baseFilename);
+
+    };
+
+
+    /* Removes all the events for which predicate(event) is true (including in transition events). Linear in the
+     * number of event slots. */
+    template<typename PREDICATE>
+    void pairEventManager::removeEventsIf(PREDICATE predicate) {
+        for (int slot = 0; slot < events.size(); slot++) {
+            if (events[slot].type != eventType::empty and predicate(static_cast<const pairEvent &>(events[slot]))) {
+                removeSlot(slot);
+            }
+        }
+    }
+}
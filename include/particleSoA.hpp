@@ -0,0 +1,98 @@
+//
+// Created by maojrs on 3/9/20.
+//
+
+#pragma once
+#include <vector>
+#include "particle.hpp"
+#include "quaternion.hpp"
+#include "vec3.hpp"
+
+namespace msmrd {
+    /**
+     * Structure of arrays (SoA) container for particles. Stores the variables used in every time step of the
+     * integration in contiguous arrays, one per component, instead of a vector of particle objects. Adapters to
+     * and from std::vector<particle> are provided, mostly for the python API. The integrators, potentials and
+     * boundaries work on particle lists, so the container is a data layout for analysis and exchange with numpy,
+     * not an integration path: convert it with toParticleList/copyToParticleList to integrate it.
+     * The multiparticle variables stored in vectors (boundList, boundStates and activePatchList) are not part of
+     * the container; copyToParticleList keeps their values in the target particle list.
+     */
+    class particleSoA {
+    public:
+        // Main variables
+        std::vector<int> pid;
+        std::vector<char> active;
+        std::vector<int> type;
+        std::vector<double> D;
+        std::vector<double> Drot;
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> z;
+        std::vector<double> ux;
+        std::vector<double> uy;
+        std::vector<double> uz;
+        std::vector<double> q0;
+        std::vector<double> q1;
+        std::vector<double> q2;
+        std::vector<double> q3;
+        // Markovian switching variables
+        std::vector<int> state;
+        std::vector<int> nextState;
+        std::vector<double> lagtime;
+        std::vector<double> timeCounter;
+        std::vector<char> propagateTMSM;
+        std::vector<char> activeMSM;
+        std::vector<int> boundTo;
+        std::vector<int> boundState;
+        std::vector<int> compoundIndex;
+        /**
+         * Each array has one entry per particle, see particle class for the meaning of each variable.
+         * @param x/y/z components of the position
+         * @param ux/uy/uz components of the orientation vector (only used by rod-like particles)
+         * @param q0/q1/q2/q3 components of the orientation quaternion (q0 is the real part)
+         * @param active, propagateTMSM, activeMSM boolean flags stored as char, so they are contiguous in
+         * memory (unlike std::vector<bool>).
+         */
+
+        particleSoA() = default;
+
+        explicit particleSoA(const std::vector<particle> &parts);
+
+        int size() const { return static_cast<int>(x.size()); }
+
+        void resize(int numParticles);
+
+        // Adapters to and from particle and particle lists
+
+        void setParticle(int index, const particle &part);
+
+        void copyToParticle(int index, particle &part) const;
+
+        particle getParticle(int index) const;
+
+        void fromParticleList(const std::vector<particle> &parts);
+
+        std::vector<particle> toParticleList() const;
+
+        void copyToParticleList(std::vector<particle> &parts) const;
+
+        // Getters and setters of single particle variables
+
+        vec3<double> getPosition(int index) const { return {x[index], y[index], z[index]}; }
+
+        vec3<double> getOrientvector(int index) const { return {ux[index], uy[index], uz[index]}; }
+
+        quaternion<double> getOrientation(int index) const { return {q0[index], q1[index], q2[index], q3[index]}; }
+
+        bool isActive(int index) const { return active[index] != 0; }
+
+        void setPosition(int index, const vec3<double> &pos);
+
+        void setOrientvector(int index, const vec3<double> &orientvec);
+
+        void setOrientation(int index, const quaternion<double> &orient);
+
+    };
+
+}
@@ -22,9 +22,24 @@ namespace msmrd {
          */
         harmonicRepulsion(double k, double range);
 
-        double evaluate(particle &part1, particle &part2) override;
+        double evaluate(const particle &part1, const particle &part2) const override;
 
-        std::array<vec3<double>, 4> forceTorque(particle &part1, particle &part2) override;
+        /* Returns -gradient of potential (force) and zero torque. Implemented in header, so the integrators
+         * specialized for this potential (see overdampedLangevinEngine) can inline it. */
+        std::array<vec3<double>, 4> forceTorque(const particle &part1, const particle &part2) const override {
+            vec3<double> force = vec3<double>(0, 0, 0);
+            vec3<double> torque = vec3<double>(0, 0, 0);
+            vec3<double> d = relativePosition(part2.position, part1.position); //part1.position - part2.position;
+            double R = d.norm();
+            if (R > range) {
+                force = 0. * d;
+            } else {
+                force = k * (R - range) / R * d;
+            }
+            return {force, torque, -1.0*force, -1.0*torque};
+        }
+
+        double getCutOff() const override { return range; }
     };
 
 }
\ No newline at end of file
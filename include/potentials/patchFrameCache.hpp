@@ -0,0 +1,77 @@
+//
+// Created by maojrs on 3/23/20.
+//
+
+#pragma once
+#include <vector>
+#include "particle.hpp"
+#include "quaternion.hpp"
+#include "tools.hpp"
+#include "vec3.hpp"
+
+namespace msmrd {
+    /**
+     * Cache of the patch frames (patch coordinates rotated by the particle orientation) of all the particles in
+     * a particle list. Patchy potentials update it once per time step (see pairPotential::precompute), so the
+     * patches of each particle are rotated once per step instead of once per pair interaction. The normals of
+     * each particle are stored contiguously, so the patch-patch loops run over contiguous arrays.
+     * A particle is only served from the cache if it is an element of the cached particle list and its
+     * orientation and type didn't change since the update; otherwise its patches are rotated on the fly.
+     */
+    class patchFrameCache {
+    private:
+        const particle *firstParticle = nullptr;
+        int numParticles = 0;
+        std::vector<int> offsets;
+        std::vector<int> types;
+        std::vector<quaternion<double>> orientations;
+        std::vector<vec3<double>> normals;
+        std::vector<vec3<double>> unitNormals;
+    public:
+        /**
+         * @param firstParticle address of the first particle of the cached particle list
+         * @param numParticles number of particles in the cached particle list
+         * @param offsets index of the first patch of each particle in normals (numParticles + 1 entries)
+         * @param types and @param orientations of the particles when the cache was updated
+         * @param normals rotated patch coordinates of all particles
+         * @param unitNormals same as normals but renormalized (to correct round off)
+         */
+        patchFrameCache() = default;
+
+        template< typename PATCHES >
+        void update(const std::vector<particle> &parts, PATCHES getPatches);
+
+        int getIndex(const particle &part) const;
+
+        const vec3<double> *getPatchNormals(const particle &part, const std::vector<vec3<double>> &patchesCoords,
+                                            bool unitary, std::vector<vec3<double>> &buffer) const;
+
+        void clear();
+    };
+
+
+    /* Rotates the patches of every particle in the list. The function getPatches(part) returns the patch
+     * coordinates of a particle (e.g. depending on its type). */
+    template< typename PATCHES >
+    void patchFrameCache::update(const std::vector<particle> &parts, PATCHES getPatches) {
+        numParticles = static_cast<int>(parts.size());
+        firstParticle = parts.data();
+        offsets.resize(numParticles + 1);
+        types.resize(numParticles);
+        orientations.resize(numParticles);
+        normals.clear();
+        unitNormals.clear();
+        offsets[0] = 0;
+        for (int i = 0; i < numParticles; i++) {
+            types[i] = parts[i].type;
+            orientations[i] = parts[i].orientation;
+            for (auto &patch : getPatches(parts[i])) {
+                vec3<double> patchNormal = msmrdtools::rotateVec(patch, parts[i].orientation);
+                normals.push_back(patchNormal);
+                unitNormals.push_back(patchNormal / patchNormal.norm());
+            }
+            offsets[i + 1] = static_cast<int>(normals.size());
+        }
+    }
+
+}
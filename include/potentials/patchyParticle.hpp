@@ -4,6 +4,7 @@
 
 #pragma once
 #include "potentials.hpp"
+#include "potentials/patchFrameCache.hpp"
 
 namespace msmrd {
     /*
@@ -30,13 +31,15 @@ namespace msmrd {
         double rstarRepulsive;
         double rstarAttractive;
         double rstarPatches;
+        // Rotated patches of the particles in the current time step
+        patchFrameCache patchFrames;
 
-        double quadraticPotential(double r, double sig, double eps, double a, double rstar);
+        double quadraticPotential(double r, double sig, double eps, double a, double rstar) const;
 
-        double derivativeQuadraticPotential(double r, double sig, double eps, double a, double rstar);
+        double derivativeQuadraticPotential(double r, double sig, double eps, double a, double rstar) const;
 
         std::tuple<vec3<double>, vec3<double>, vec3<double>, vec3<double>> forceTorquePatches(
-                particle &part1, particle &part2, const vec3<double> pos1virtual);
+                const particle &part1, const particle &part2, const vec3<double> pos1virtual) const;
 
     public:
         /**
@@ -48,6 +51,7 @@ namespace msmrd {
          * anisotropic attractive patches potentials.
          * @param a*** stiffness paramaters for the same three potentials.
          * @param rstar*** range paramaters for the same three potentials.
+         * @param patchFrames cache of the rotated patches of each particle, updated by precompute.
          */
         patchyParticle() = default;
 
@@ -57,10 +61,18 @@ namespace msmrd {
 
         // Main functions
 
-        double evaluate(particle &part1, particle &part2) override;
+        double evaluate(const particle &part1, const particle &part2) const override;
 
         std::array<vec3<double>, 4>
-        forceTorque(particle &part1, particle &part2) override;
+        forceTorque(const particle &part1, const particle &part2) const override;
+
+        double getCutOff() const override;
+
+        void precompute(const std::vector<particle> &parts) override;
+
+        std::array<vec3<double>, 4> forceTorqueSlow(const particle &part1, const particle &part2) const override;
+
+        std::array<vec3<double>, 4> forceTorqueFast(const particle &part1, const particle &part2) const override;
 
     };
 }
\ No newline at end of file
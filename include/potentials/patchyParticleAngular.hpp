@@ -30,10 +30,12 @@ namespace msmrd {
         patchyParticleAngular(double sigma, double strength, double angularStrength,
                               std::vector<vec3<double>> patchesCoordinates);
 
-        double evaluate(particle &part1, particle &part2) override;
+        double evaluate(const particle &part1, const particle &part2) const override;
 
         std::array<vec3<double>, 4>
-        forceTorque(particle &part1, particle &part2) override;
+        forceTorque(const particle &part1, const particle &part2) const override;
+
+        std::array<vec3<double>, 4> forceTorqueFast(const particle &part1, const particle &part2) const override;
 
     };
 
@@ -51,22 +53,23 @@ namespace msmrd {
         // Inherit parent class constructor
         using patchyParticleAngular::patchyParticleAngular;
 
-        double evaluate(particle &part1, particle &part2) override;
+        double evaluate(const particle &part1, const particle &part2) const override;
 
         std::array<vec3<double>, 4>
-        forceTorque(particle &part1, particle &part2) override;
+        forceTorque(const particle &part1, const particle &part2) const override;
 
+        std::array<vec3<double>, 4> forceTorqueFast(const particle &part1, const particle &part2) const override;
 
-        // Additional auxiliary functions
 
-        std::array<vec3<double>, 4> normalForceTorque(particle &part1, particle &part2);
+        // Additional auxiliary functions
 
         std::tuple<vec3<double>, vec3<double>, vec3<double>, vec3<double>> forceTorquePatchesSelective(
-                particle &part1, particle &part2, const vec3<double> pos1virtual);
+                const particle &part1, const particle &part2, const vec3<double> pos1virtual) const;
 
-        bool isPatchBindingActive(particle &part1, particle &part2, int indexPatch1, int indexPatch2);
+        bool isPatchBindingActive(const particle &part1, const particle &part2,
+                                  int indexPatch1, int indexPatch2) const;
 
-        std::tuple<vec3<double>, vec3<double>> calculatePlanes(const particle &part1, const particle &part2);
+        std::tuple<vec3<double>, vec3<double>> calculatePlanes(const particle &part1, const particle &part2) const;
 
     };
 
@@ -4,6 +4,7 @@
 
 #pragma once
 #include "potentials/patchyParticle.hpp"
+#include "potentials/patchFrameCache.hpp"
 
 namespace msmrd{
 
@@ -41,22 +42,24 @@ namespace msmrd{
         double rstarRepulsive;
         double rstarAttractive;
         std::array<double, 2> rstarPatches;
+        // Rotated patches of the particles in the current time step
+        patchFrameCache patchFrames;
 
-        std::vector<vec3<double>> assignPatches(int type);
+        const std::vector<vec3<double>> &assignPatches(int type) const;
 
-        double quadraticPotential(double r, double sig, double eps, double a, double rstar);
+        double quadraticPotential(double r, double sig, double eps, double a, double rstar) const;
 
-        double derivativeQuadraticPotential(double r, double sig, double eps, double a, double rstar);
+        double derivativeQuadraticPotential(double r, double sig, double eps, double a, double rstar) const;
 
-        double evaluatePatchesPotential( particle &part1, particle &part2,
+        double evaluatePatchesPotential( const particle &part1, const particle &part2,
                                         vec3<double> &pos1virtual,
-                                        std::vector<vec3<double>> &patchesCoords1,
-                                        std::vector<vec3<double>> &patchesCoords2);
+                                        const std::vector<vec3<double>> &patchesCoords1,
+                                        const std::vector<vec3<double>> &patchesCoords2) const;
 
-        std::array<vec3<double>, 4> forceTorquePatches(particle &part1, particle &part2,
+        std::array<vec3<double>, 4> forceTorquePatches(const particle &part1, const particle &part2,
                                                        vec3<double> &pos1virtual,
-                                                       std::vector<vec3<double>> &patchesCoords1,
-                                                       std::vector<vec3<double>> &patchesCoords2);
+                                                       const std::vector<vec3<double>> &patchesCoords1,
+                                                       const std::vector<vec3<double>> &patchesCoords2) const;
 
     public:
         patchyProtein() = default;
@@ -68,9 +71,17 @@ namespace msmrd{
                       std::vector<std::vector<double>> patchesCoordinatesA,
                       std::vector<std::vector<double>> patchesCoordinatesB);
 
-        double evaluate(particle &part1, particle &part2) override;
+        double evaluate(const particle &part1, const particle &part2) const override;
 
-        std::array<vec3<double>, 4> forceTorque(particle &part1, particle &part2) override;
+        std::array<vec3<double>, 4> forceTorque(const particle &part1, const particle &part2) const override;
+
+        double getCutOff() const override;
+
+        void precompute(const std::vector<particle> &parts) override;
+
+        std::array<vec3<double>, 4> forceTorqueSlow(const particle &part1, const particle &part2) const override;
+
+        std::array<vec3<double>, 4> forceTorqueFast(const particle &part1, const particle &part2) const override;
 
         bool arePatchesActive() { return patchesActive; }
 
@@ -2,6 +2,7 @@
 // Created by maojrs on 8/14/18.
 //
 #pragma once
+#include <limits>
 #include "particle.hpp"
 #include "randomgen.hpp"
 #include "quaternion.hpp"
@@ -19,12 +20,13 @@ namespace msmrd {
         externalPotential() = default;
 
         /* Virtual functions to calculate value of potential and force/torque at position "pos".
-         * Possible orientation dependence can be added into the aux variables. */
-        virtual double evaluate(particle &part) = 0;
+         * Possible orientation dependence can be added into the aux variables. They are const, so they
+         * can be evaluated concurrently. */
+        virtual double evaluate(const particle &part) const = 0;
 
-        virtual std::array<vec3<double>, 2> forceTorque(particle &part) = 0;
+        virtual std::array<vec3<double>, 2> forceTorque(const particle &part) const = 0;
 
-        std::vector<std::vector<double>> forceTorquePyBind(particle &part);
+        std::vector<std::vector<double>> forceTorquePyBind(const particle &part) const;
     };
 
 
@@ -36,11 +38,22 @@ namespace msmrd {
     protected:
         boundary *domainBoundary;
         bool boundaryActive = false;
+        bool periodicBoundary = false;
         /*
         * @param *domainBoundary pointer to the boundary object to be used. Useful to compute potentials
         * in periodic domains. It must point to the same boundary as the integrator.
         * @param boundaryActive true is boundary is active in the system.
+        * @param periodicBoundary true if the boundary is a periodic box, set by setBoundary so the relative
+        * positions don't compare the boundary type for every pair.
         */
+
+        /* Auxiliary functions to split patchy potentials into slow and fast parts (see forceTorqueSlow): the force
+         * and torque of a central force with norm forceNorm along rvec = pos2 - pos1 (soft isotropic part), and
+         * the sum of two (force1, torque1, force2, torque2) contributions (e.g. slow and fast parts). */
+        static std::array<vec3<double>, 4> centralForceTorque(vec3<double> rvec, double forceNorm);
+
+        static std::array<vec3<double>, 4> addForceTorques(const std::array<vec3<double>, 4> &forceTorque1,
+                                                           const std::array<vec3<double>, 4> &forceTorque2);
     public:
 
         pairPotential() = default;
@@ -49,22 +62,56 @@ namespace msmrd {
          * Possible orientation dependence can be added into the aux variables. The function forceTorque should
          * return (force1, torque1, force2, torque2), the first two correspond to the force and torque acting on
          * particle 1 due to its interaction with particle 2, and the second two correspond to the force and
-         * torque acting on particle 2 due to its interaction with particle 1.*/
-        virtual double evaluate(particle &part1, particle &part2) = 0;
+         * torque acting on particle 2 due to its interaction with particle 1. Both functions must not modify the
+         * potential nor the particles, since the integrators may call them concurrently from several threads. */
+        virtual double evaluate(const particle &part1, const particle &part2) const = 0;
+
+        virtual std::array<vec3<double>, 4> forceTorque(const particle &part1, const particle &part2) const = 0;
+
+        /* Interaction range of the potential: for relative distances larger than the cut off, evaluate and
+         * forceTorque must return exactly zero. Used by the integrator neighbor search to skip pairs that
+         * cannot interact; long range potentials keep the default (infinity), which disables the search. */
+        virtual double getCutOff() const { return std::numeric_limits<double>::infinity(); }
 
-        virtual std::array<vec3<double>, 4> forceTorque(particle &part1, particle &part2) = 0;
+        /* Called by the integrators once per time step, before the pair interactions are evaluated, so potentials
+         * can precompute per particle quantities (e.g. rotated patches, see patchFrameCache). It must not change
+         * the values returned by evaluate and forceTorque. */
+        virtual void precompute(const std::vector<particle> &parts) {};
+
+        /* Splitting of forceTorque into slow (soft) and fast (stiff, short ranged) contributions, used by multiple
+         * time step integrators (see overdampedLangevinMTS). Their sum must equal forceTorque; by default the whole
+         * interaction is slow. */
+        virtual std::array<vec3<double>, 4> forceTorqueSlow(const particle &part1, const particle &part2) const {
+            return forceTorque(part1, part2);
+        }
+
+        virtual std::array<vec3<double>, 4> forceTorqueFast(const particle &part1, const particle &part2) const;
 
 
         // Function to translate forceTorque function to pyBind
-        std::vector<std::vector<double>> forceTorquePyBind(particle &part1, particle &part2);
+        std::vector<std::vector<double>> forceTorquePyBind(const particle &part1, const particle &part2) const;
 
 
-        // Additional useful functions so potentials can deal with possible periodic boundaries.
+        /* Additional useful functions so potentials can deal with possible periodic boundaries. The relative
+         * positions are called for every pair, so they are implemented in the header (inline). */
         void setBoundary(boundary *bndry);
 
-        vec3<double> relativePosition(const vec3<double> p1, const vec3<double> p2);
-
-        std::array<vec3<double>, 2> relativePositionComplete(vec3<double> p1, vec3<double> p2);
+        // Calculates relative distance (p2-p1) of two vectors, p1, p2, taking into account possible periodic boundary
+        vec3<double> relativePosition(const vec3<double> p1, const vec3<double> p2) const {
+            if (boundaryActive and periodicBoundary) {
+                return msmrdtools::distancePeriodicBox(p1, p2, domainBoundary->boxsize);
+            }
+            return p2 - p1;
+        }
+
+        /* Calculates relative distance (p2-p1) of two vectors, p1, p2, taking into account possible periodic
+         * boundary and returns virtual position of p1 as well as the relative distance */
+        std::array<vec3<double>, 2> relativePositionComplete(vec3<double> p1, vec3<double> p2) const {
+            if (boundaryActive and periodicBoundary) {
+                return msmrdtools::distancePeriodicBoxComplete(p1, p2, domainBoundary->boxsize);
+            }
+            return {p1, p2 - p1};
+        }
 
     };
 
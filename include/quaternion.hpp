@@ -61,7 +61,7 @@ public:
         };
     };
 
-    quaternion<double> conj() {
+    quaternion<double> conj() const {
         return {a, -b, -c, -d};
     }
 
@@ -2,33 +2,141 @@
 // Created by maojrs on 7/25/18.
 //
 #pragma once
+#include <array>
+#include <cstdint>
 #include <random>
+#include <string>
+#include <vector>
 #include "vec3.hpp"
 #include <chrono>
 
 namespace msmrd {
     /**
-     * Declares class to generate good random numbers (mt_19937_64 generator)
-     * and sample from common distirbutions
+     * Counter-based random number engine (Philox4x32-10, Salmon et al. 2011). Each output is a pure function
+     * of a key and a counter, so independent streams are obtained by fixing the key (seed) and choosing
+     * the counter (replica, particle, step) directly instead of advancing a shared state. Satisfies the
+     * UniformRandomBitGenerator requirements (64 bit outputs), so it can be used with std distributions.
+     */
+    class philox4x32 {
+    private:
+        std::array<uint32_t, 2> key = {{0, 0}};
+        std::array<uint32_t, 4> counter = {{0, 0, 0, 0}};
+        std::array<uint32_t, 4> block = {{0, 0, 0, 0}};
+        int blockPosition = 4;
+
+        void generateBlock();
+    public:
+        /**
+         * @param key 64 bit key given by the seed
+         * @param counter 128 bit counter: (draw index, particle id, step, replica id). The draw index is
+         * increased every time a block of four 32 bit words is generated.
+         * @param block last generated block, @param blockPosition next unused word of the block
+         */
+        using result_type = uint64_t;
+
+        philox4x32() = default;
+
+        explicit philox4x32(uint64_t seed) { setKey(seed); };
+
+        void setKey(uint64_t seed);
+
+        void setCounter(uint32_t replicaID, uint32_t particleID, uint32_t step);
+
+        static std::array<uint32_t, 4> bijection(std::array<uint32_t, 4> ctr, std::array<uint32_t, 2> k);
+
+        static constexpr result_type min() { return 0; }
+
+        static constexpr result_type max() { return UINT64_MAX; }
+
+        result_type operator()();
+    };
+
+
+    /**
+     * Declares class to generate good random numbers and sample from common distirbutions. Two generators
+     * (backends) are available:
+     * "mt19937": mt_19937_64 generator, one sequential stream (default).
+     * "philox": counter-based generator. The stream is selected by the keys (seed, replica id, particle id,
+     * step) through setReplicaID and setSubstream, so the numbers drawn for a given particle at a given step
+     * don't depend on the order (or thread) in which particles are processed.
+     * Uniform and normal samples are drawn directly from the random bits (Box-Muller transform for normal
+     * samples); fillUniform and fillNormal fill a whole buffer at once.
      */
     class randomgen {
     private:
         long seed = -1;
-        std::random_device rd;
+        std::string backend = "mt19937";
+        bool counterBased = false;
+        long replicaID = 0;
         std::mt19937_64 mt_rand;  // random number generator
+        philox4x32 philox_rand; // counter-based random number generator
+        bool hasSpareNormal = false;
+        double spareNormal = 0.0;
+
+        uint64_t randomBits() { return counterBased ? philox_rand() : mt_rand(); }
+
+        // Uniform in [0,1) with 53 random bits
+        double uniform01() { return (randomBits() >> 11) * (1.0/9007199254740992.0); }
+
+        void fillUniform01(double *buffer, size_t numSamples);
+
+        double standardNormal();
+
+        void seedEngines(uint64_t engineSeed);
     public:
-        randomgen() { mt_rand = std::mt19937_64(rd()); };
+        /**
+         * @param seed seed of the generator. seed >= 0 is deterministic. seed = -1 (default) uses a
+         * random device seed, and seed < -1 uses a random device seed multiplied by -seed; both are
+         * different in every run.
+         * @param backend name of the random number generator in use ("mt19937" or "philox")
+         * @param replicaID replica key of the counter-based generator (e.g. index of a simulation in an ensemble)
+         * @param hasSpareNormal/spareNormal the Box-Muller transform yields normal samples in pairs, the second
+         * one is kept for the next draw (discarded when the seed or substream changes).
+         *
+         * Copies of a generator with a given seed (>= 0) are exact copies, they continue the same sequence.
+         * Copies of a generator with a random device seed (seed < 0) are reseeded with a new random device
+         * seed, so they remain independent.
+         */
+        randomgen() { seedEngines(std::random_device()()); };
 
-        randomgen(const randomgen &) { mt_rand = std::mt19937_64(rd()); };
+        randomgen(const randomgen &other);
+
+        randomgen &operator=(const randomgen &other);
 
         void setSeed(long newseed);
 
+        void setBackend(std::string newbackend);
+
+        void setReplicaID(long newreplicaID);
+
+        void setSubstream(long particleID, long step);
+
+        long getSeed() const { return seed; }
+
+        std::string getBackend() const { return backend; }
+
+        bool isCounterBased() const { return counterBased; }
+
         double uniformRange(double rmin, double rmax);
 
         int uniformInteger(int imin, int imax);
 
         double normal(double mean, double stddev);
 
+        double exponential(double rate);
+
+        void fillUniform(double *buffer, size_t numSamples, double rmin, double rmax);
+
+        void fillUniform(std::vector<double> &buffer, double rmin, double rmax) {
+            fillUniform(buffer.data(), buffer.size(), rmin, rmax);
+        };
+
+        void fillNormal(double *buffer, size_t numSamples, double mean, double stddev);
+
+        void fillNormal(std::vector<double> &buffer, double mean, double stddev) {
+            fillNormal(buffer.data(), buffer.size(), mean, stddev);
+        };
+
         vec3<double> normal3D(double mean, double stddev);
 
         vec3<double> uniformSphere(double maxrad);
@@ -68,13 +68,39 @@ namespace msmrdtools {
     // Calculate minimum rotation angle along some axis to reach q2 from q1.
     double quaternionAngleDistance(quaternion<double> q1, quaternion<double> q2);
 
-    // Calculates relative distance of two vectors (p1, p2) in a periodic box
-    vec3<double> distancePeriodicBox(const vec3<double> p1, const vec3<double> p2, const vec3<double> edgeslength);
+    /* Calculates relative distance (p2-p1) of two vectors (p1, p2) in a periodic box. Implemented in header
+     * (inline), since the pair potentials call it for every pair. */
+    inline vec3<double> distancePeriodicBox(const vec3<double> p1, const vec3<double> p2,
+                                            const vec3<double> edgeslength) {
+        vec3<double> p1Periodic = 1.0*p1;
+        // Loop over three coordinates (x,y,z)
+        for (int i = 0; i < 3; i++){
+            if ( (p2[i] - p1[i]) > 0.5*edgeslength[i]) {
+                p1Periodic[i] += edgeslength[i];
+            }
+            if ( (p2[i] - p1[i]) < -0.5*edgeslength[i]) {
+                p1Periodic[i] -= edgeslength[i];
+            }
+        }
+        return p2 - p1Periodic;
+    }
 
     /* Calculates relative distance of two vectors (p1, p2) in a periodic box and returns
-     * virtual position of p1 + relative distance */
-    std::array<vec3<double>, 2> distancePeriodicBoxComplete(const vec3<double> p1, const vec3<double> p2,
-                                                            const vec3<double> edgeslength);
+     * virtual position of p1 + relative distance (inline, see distancePeriodicBox) */
+    inline std::array<vec3<double>, 2> distancePeriodicBoxComplete(const vec3<double> p1, const vec3<double> p2,
+                                                                   const vec3<double> edgeslength) {
+        vec3<double> p1Periodic = 1.0*p1;
+        // Loop over three coordinates (x,y,z)
+        for (int i = 0; i < 3; i++){
+            if (p2[i] - p1[i] > 0.5*edgeslength[i]) {
+                p1Periodic[i] += edgeslength[i];
+            }
+            if (p2[i] - p1[i] < -0.5*edgeslength[i]) {
+                p1Periodic[i] -= edgeslength[i];
+            }
+        }
+        return {p1Periodic, p2 - p1Periodic};
+    }
 
     // Calculates relative position between two particles taking into account possible periodic boundary
     vec3<double> calculateRelativePosition(const vec3<double> pos1, const vec3<double> pos2, const bool boundaryActive,
@@ -3,6 +3,8 @@
 //
 
 #pragma once
+#include <cstdint>
+#include <exception>
 #include <memory>
 #include <cmath>
 #include "trajectories/trajectoryPositionOrientation.hpp"
@@ -16,7 +18,8 @@ namespace msmrd {
      * specific for the application. In short words, it chooses how to discretize the full
      * trajectory of two particles into a discretized trajectory to be analyzed and extracted into
      * a Markov state model. In general the discretizations will follow the core MSM approach. It
-     * also implements functionality to discretize trajectories directly loaded from a python array.
+     * also implements functionality to discretize trajectories directly loaded from a python array, or
+     * in batches from contiguous (timesteps, particles, columns) arrays using several threads.
      *
      * @tparam numBoundStates number of bound states in current trajectory discretization. Note
      * the max number of bound states is calculated from this value (8 bound states = 10 max
@@ -39,6 +42,10 @@ namespace msmrd {
         double tolerancePosition = 0.12;
         double toleranceOrientation = 0.12*2*M_PI;
         int prevsample = 0;
+        int numThreads = 1;
+
+        int sampleDiscreteStateRows(const double *row1, const double *row2, int numColumns);
+
     public:
         /*
          * @positionOrientationPart full six dimensional partition of phase space of relative position and orientation.
@@ -77,6 +84,7 @@ namespace msmrd {
          * CoreMSM approach. The CoreMSM approach chooses how to discretize the region r<rLowerBound that
          * is not a bound state. CoreMSM uses the value of the previous known bound or transition state until a new
          * bound or transition state is reached.
+         * @param numThreads number of OpenMP threads used by discretizeTrajectoryBatch (default 1)
          */
 
         discreteTrajectory(unsigned long Nparticles, int bufferSize);
@@ -85,7 +93,12 @@ namespace msmrd {
 
         void sampleDiscreteTrajectory(double time, std::vector<particle> &particleList) override;
 
-        virtual int sampleDiscreteState(particle part1, particle part2); // virtual since it is likely to be overriden.
+        // Virtual since it is likely to be overriden.
+        virtual int sampleDiscreteState(const particle &part1, const particle &part2);
+
+        virtual int sampleDiscreteStateRelative(const vec3<double> &relativePosition,
+                                                const quaternion<double> &relativeOrientation,
+                                                int state1, int state2);
 
         int getBoundState(vec3<double> relativePosition, quaternion<double> relativeOrientation);
 
@@ -95,6 +108,8 @@ namespace msmrd {
 
         int getFlippedBoundStateIndex(int boundStateIndex);
 
+        double getRLowerBound() const { return rLowerBound; }
+
 
 
 
@@ -105,6 +120,15 @@ namespace msmrd {
         // Load H5 directly and discretizes it
         std::vector<double> discretizeTrajectoryH5(std::string filename);
 
+        std::vector<std::int32_t> discretizeTrajectoryBatch(const double *trajectory, long numTimesteps,
+                                                            int numParticles, int numColumns);
+
+        std::vector<std::int32_t> discretizeTrajectoryBatchH5(std::string filename, int numParticles);
+
+        void setNumThreads(int nthreads);
+
+        int getNumThreads() const { return numThreads; }
+
         // Setter functions so child classes can modify default values of parameters
 
         void setRadialBounds(double rlower, double rupper);
@@ -161,24 +185,35 @@ namespace msmrd {
      * bound state, transition state or unbound state (0). In the bound region (r< rLowerBound), it can
      * also return -1 when not in any bound state. In this case, one would normally apply the coreMSM
      * approach and choose the previous value. However, this is done directly on sampleDiscreteTrajectory or
-     * in discretizeTrajectoryH5 and discretizeTrajectory if discretizing directly a python array. This function
-     * is set a svirtual since it is likely the one that needs to be modified in child classes. */
+     * in discretizeTrajectoryH5 and discretizeTrajectory if discretizing directly a python array. The
+     * discretization itself is done by sampleDiscreteStateRelative, which is the one to modify in child classes. */
     template<int numBoundStates>
-    int discreteTrajectory<numBoundStates>::sampleDiscreteState(particle part1, particle part2) {
-        // Initialize sample with value zero (unbound state)
-        int discreteState = 0;
-
+    int discreteTrajectory<numBoundStates>::sampleDiscreteState(const particle &part1, const particle &part2) {
         /* Calculate relative position taking into account periodic boundary measured
          * from i to j (gets you from i to j). */
         auto relativePosition = calculateRelativePosition(part1.position, part2.position);
 
         // Rotate relative position to match the reference orientation of particle 1. (VERY IMPORTANT)
         relativePosition = msmrdtools::rotateVec(relativePosition, part1.orientation.conj());
-        quaternion<double> quatReference = {1,0,0,0}; // we can then define reference quaternion as identity.
 
         // Calculate relative orientation (rotation particle 1 needs to make to reach the orientation of particle 2)
         auto relativeOrientation =  part2.orientation * part1.orientation.conj();
 
+        // Use "this->" to make sure it calls the virtual overriden method in child classes
+        return this->sampleDiscreteStateRelative(relativePosition, relativeOrientation, part1.state, part2.state);
+    };
+
+    /* Samples the discrete state from the relative position (already rotated to the reference orientation of
+     * particle 1) and relative orientation of two particles, and from their states. Returns the same values
+     * as sampleDiscreteState. This function is set as virtual since it is likely the one that needs to be
+     * modified in child classes. */
+    template<int numBoundStates>
+    int discreteTrajectory<numBoundStates>::sampleDiscreteStateRelative(const vec3<double> &relativePosition,
+                                                                        const quaternion<double> &relativeOrientation,
+                                                                        int state1, int state2) {
+        // Initialize sample with value zero (unbound state)
+        int discreteState = 0;
+        quaternion<double> quatReference = {1,0,0,0}; // Relative position is in the frame of particle 1.
 
         // Extract current state, save into sample and return sample
         if (relativePosition.norm() < rLowerBound) {
@@ -195,7 +230,28 @@ namespace msmrd {
         return discreteState;
     };
 
-
+    /* Samples the discrete state of two particles directly from two rows of a trajectory array of the form
+     * (timestep, position, orientation) or (timestep, position, orientation, state), without creating
+     * particles. Used to discretize trajectories loaded from python or H5 files. */
+    template<int numBoundStates>
+    int discreteTrajectory<numBoundStates>::sampleDiscreteStateRows(const double *row1, const double *row2,
+                                                                    int numColumns) {
+        vec3<double> position1 = {row1[1], row1[2], row1[3]};
+        vec3<double> position2 = {row2[1], row2[2], row2[3]};
+        quaternion<double> orientation1 = {row1[4], row1[5], row1[6], row1[7]};
+        quaternion<double> orientation2 = {row2[4], row2[5], row2[6], row2[7]};
+        // If state of particle is included in trajectory, load it as well (for backward compatibility).
+        int state1 = 0;
+        int state2 = 0;
+        if (numColumns > 8) {
+            state1 = static_cast<int>(row1[8]);
+            state2 = static_cast<int>(row2[8]);
+        }
+        auto relativePosition = calculateRelativePosition(position1, position2);
+        relativePosition = msmrdtools::rotateVec(relativePosition, orientation1.conj());
+        auto relativeOrientation = orientation2 * orientation1.conj();
+        return this->sampleDiscreteStateRelative(relativePosition, relativeOrientation, state1, state2);
+    };
 
 
     /* Auxiliary function used by sampleDiscreteState. Given two particles, use their positions and
@@ -258,31 +314,14 @@ namespace msmrd {
         // Set output trajectory
         std::vector<double> discreteTrajectory(timesteps);
 
-        vec3<double> position1;
-        vec3<double> position2;
-        quaternion<double> orientation1;
-        quaternion<double> orientation2;
-        int state1 = 0;
-        int state2 = 0;
-
         int prevDiscreteState = 0;
         int discreteState = 0;
 
         for (int i = 0; i < timesteps; i++) {
-            auto part1Data = trajectory[numParticles*i];
-            auto part2Data = trajectory[numParticles*i + 1];
-            position1 = {part1Data[1], part1Data[2], part1Data[3]};
-            position2 = {part2Data[1], part2Data[2], part2Data[3]};
-            orientation1 = {part1Data[4], part1Data[5], part1Data[6], part1Data[7]};
-            orientation2 = {part2Data[4], part2Data[5], part2Data[6], part2Data[7]};
-            // If state of particle is included in trajectory, load it as well. (for backward compatibility)
-            if (trajectory[numParticles*i].size() > 8) {
-                state1 = static_cast<int>(part1Data[8]);
-                state2 = static_cast<int>(part2Data[8]);
-            }
-            auto dummyParticle1 = particle(0, state1, 0, 0, position1, orientation1);
-            auto dummyParticle2 = particle(0, state2, 0, 0, position2, orientation2);
-            discreteState = this->sampleDiscreteState(dummyParticle1, dummyParticle2);
+            const auto &part1Data = trajectory[numParticles*i];
+            const auto &part2Data = trajectory[numParticles*i + 1];
+            discreteState = sampleDiscreteStateRows(part1Data.data(), part2Data.data(),
+                                                    static_cast<int>(part1Data.size()));
             // If sampleDiscreteState returned -1, return previous sample (CoreMSM approach).
             if (discreteState == -1) {
                 discreteState = 1 * prevDiscreteState;
@@ -299,20 +338,81 @@ namespace msmrd {
     /* From a given trajectory H5 file of the from (timestep, position, orientation) or (timestep, position,
      * orientation, state), where repeated timesteps mean different particles at same tieme step, obtain a
      * discrete trajectory using the discreteTrajectory discretization. This is the same as discretizeTrajectory,
-     * but loads the H5 file directly in c++ and later discretizes them.*/
+     * but loads the H5 file directly in c++ and later discretizes them (with discretizeTrajectoryBatch).*/
     template<int numBoundStates>
     std::vector<double> discreteTrajectory<numBoundStates>::discretizeTrajectoryH5(std::string filename) {
         int numParticles = 2; // Must be two to discretize trajectory (also it is a dimer)
-        vec3<double> position1;
-        vec3<double> position2;
-        quaternion<double> orientation1;
-        quaternion<double> orientation2;
-        int state1 = 0;
-        int state2 = 0;
+        auto discreteTrajectory = discretizeTrajectoryBatchH5(filename, numParticles);
+        return std::vector<double>(discreteTrajectory.begin(), discreteTrajectory.end());
+    }
 
-        int prevDiscreteState = 0;
-        int discreteState = 0;
 
+    /* Discretizes a whole trajectory of numParticles particles stored in a contiguous array of shape (numTimesteps,
+     * numParticles, numColumns), where each row is (timestep, position, orientation) or (timestep, position,
+     * orientation, state). Every pair of particles (i < j) is discretized as in discretizeTrajectory, so it
+     * returns an array of shape (numTimesteps, numPairs) with the pairs ordered as (0,1), (0,2), ..., (1,2), ...
+     * The timesteps are discretized in parallel with numThreads OpenMP threads. Then the CoreMSM approach is
+     * applied to each pair, which only depends on the previous state of the same pair. */
+    template<int numBoundStates>
+    std::vector<std::int32_t> discreteTrajectory<numBoundStates>::discretizeTrajectoryBatch(
+            const double *trajectory, long numTimesteps, int numParticles, int numColumns) {
+        if (numParticles < 2) {
+            throw std::invalid_argument("At least two particles are needed to discretize a trajectory");
+        }
+        if (numColumns < 8) {
+            throw std::invalid_argument("Trajectory rows must have at least 8 columns: timestep, position (3) "
+                                        "and orientation (4)");
+        }
+        int numPairs = numParticles * (numParticles - 1) / 2;
+        std::vector<std::int32_t> discreteTrajectories(numTimesteps * numPairs);
+        // Exceptions can't leave an OpenMP region, so the first one is kept and thrown after the loop.
+        std::exception_ptr exception = nullptr;
+        #pragma omp parallel for num_threads(numThreads) schedule(static) if(numThreads > 1)
+        for (long t = 0; t < numTimesteps; t++) {
+            const double *frame = trajectory + t * numParticles * numColumns;
+            auto *discreteStates = discreteTrajectories.data() + t * numPairs;
+            try {
+                for (int i = 0; i < numParticles; i++) {
+                    for (int j = i + 1; j < numParticles; j++) {
+                        *discreteStates++ = sampleDiscreteStateRows(frame + i * numColumns, frame + j * numColumns,
+                                                                    numColumns);
+                    }
+                }
+            } catch (...) {
+                #pragma omp critical
+                if (not exception) {
+                    exception = std::current_exception();
+                }
+            }
+        }
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        // If sampleDiscreteState returned -1, use previous state of the pair (CoreMSM approach).
+        #pragma omp parallel for num_threads(numThreads) schedule(static) if(numThreads > 1)
+        for (int pair = 0; pair < numPairs; pair++) {
+            std::int32_t prevDiscreteState = 0;
+            for (long t = 0; t < numTimesteps; t++) {
+                auto &discreteState = discreteTrajectories[t * numPairs + pair];
+                if (discreteState == -1) {
+                    discreteState = prevDiscreteState;
+                }
+                prevDiscreteState = discreteState;
+            }
+        }
+        return discreteTrajectories;
+    }
+
+
+    /* Loads a trajectory H5 file of numParticles particles, with rows of the form (timestep, position, orientation)
+     * or (timestep, position, orientation, state) and numParticles consecutive rows per timestep, and discretizes
+     * it with discretizeTrajectoryBatch. */
+    template<int numBoundStates>
+    std::vector<std::int32_t> discreteTrajectory<numBoundStates>::discretizeTrajectoryBatchH5(std::string filename,
+                                                                                            int numParticles) {
+        if (numParticles < 2) {
+            throw std::invalid_argument("At least two particles are needed to discretize a trajectory");
+        }
         // Read H5 file
         const H5std_string  FILE_NAME(filename);
         const H5std_string  DATASET_NAME("msmrd_data");
@@ -321,52 +421,28 @@ namespace msmrd {
 
         // Get dimensions of dataset
         DataSpace dataspace = dataset.getSpace();
+        if (dataspace.getSimpleExtentNdims() != 2) {
+            throw std::invalid_argument("Trajectory in " + filename + " must be a two dimensional dataset");
+        }
         hsize_t dims[2];
         int rank = dataspace.getSimpleExtentDims(dims);
+        if (dims[0] % numParticles != 0) {
+            throw std::invalid_argument("Number of rows of trajectory in " + filename + " must be a multiple "
+                                        "of numParticles (one row per particle and timestep)");
+        }
 
         // Define output of read data
-        int NX = dims[0];
-        int NY = dims[1];
-        double *trajectory = new double[NX*NY];
-
-        // Set output trajectory
-        int timesteps = static_cast<int>(dims[0] / numParticles);
-        std::vector<double> discreteTrajectory(timesteps);
+        std::vector<double> trajectory(dims[0] * dims[1]);
 
         // Define the memory space to read dataset.
         DataSpace mspace(rank, dims);
 
-        dataset.read(trajectory, PredType::NATIVE_DOUBLE, mspace, dataspace);
+        dataset.read(trajectory.data(), PredType::NATIVE_DOUBLE, mspace, dataspace);
 
         file.close();
 
-        for (int i = 0; i < timesteps; i++) {
-            /* 2D array indexes (row, col), with row = numParticles*i and col the column between 0 and 7. Its
-             * 1D version index should be row*NY + col*/
-            int jj = (numParticles * i)*NY;
-            int kk = (numParticles*i + 1)*NY;
-            position1 = {trajectory[jj+1], trajectory[jj+2], trajectory[jj+3]};
-            position2 = {trajectory[kk+1], trajectory[kk+2], trajectory[kk+3]};
-            orientation1 = {trajectory[jj+4], trajectory[jj+5], trajectory[jj+6], trajectory[jj+7]};
-            orientation2 = {trajectory[kk+4], trajectory[kk+5], trajectory[kk+6], trajectory[kk+7]};
-            // If state of particle is included in trajectory, load it as well (for backward compatibility).
-            if (NY > 8) {
-                state1 = static_cast<int>(trajectory[jj+8]);
-                state2 = static_cast<int>(trajectory[kk+8]);
-            }
-            auto dummyParticle1 = particle(0, state1, 0, 0, position1, orientation1);
-            auto dummyParticle2 = particle(0, state2, 0, 0, position2, orientation2);
-            discreteState = this->sampleDiscreteState(dummyParticle1, dummyParticle2);
-            // If sampleDiscreteState returned -1, return previous value (CoreMSM approach).
-            if (discreteState == -1) {
-                discreteState = 1 * prevDiscreteState;
-            }
-            prevDiscreteState = 1*discreteState;
-
-            discreteTrajectory[i] = discreteState;
-        }
-        delete [] trajectory;
-        return discreteTrajectory;
+        long timesteps = static_cast<long>(dims[0] / numParticles);
+        return discretizeTrajectoryBatch(trajectory.data(), timesteps, numParticles, static_cast<int>(dims[1]));
     }
 
 
@@ -387,5 +463,19 @@ namespace msmrd {
         toleranceOrientation = orientationTolerance;
     };
 
+    // Sets number of OpenMP threads used by discretizeTrajectoryBatch
+    template<int numBoundStates>
+    void discreteTrajectory<numBoundStates>::setNumThreads(int nthreads) {
+        if (nthreads < 1) {
+            throw std::invalid_argument("Number of threads must be at least one");
+        }
+#ifndef _OPENMP
+        if (nthreads > 1) {
+            throw std::runtime_error("msmrd2 was compiled without OpenMP; only one thread is supported");
+        }
+#endif
+        numThreads = nthreads;
+    };
+
 
 }
@@ -38,7 +38,9 @@ namespace msmrd {
 
         using patchyProteinTrajectory::patchyProteinTrajectory;
 
-        int sampleDiscreteState(particle part1, particle part2) override;
+        int sampleDiscreteStateRelative(const vec3<double> &relativePosition,
+                                        const quaternion<double> &relativeOrientation,
+                                        int state1, int state2) override;
 
     };
 
@@ -127,29 +127,26 @@ def MSMRDsimulationFPT(trajectorynum):
     # Calculates the first passage times to a given bound state. Each trajectory is integrated until
     # a bound state is reached. The output in the files is the elapsed time.
     unbound = True
-    ii = 0
     while(unbound):
-        ii += 1
         integrator.integrate(partlist)
-        # Check status every 5000 timesteps (adds possible error of up to 5000*dt = 0.5), but
-        # speeds up simulations
-        if (ii % 5000 == 0):
-            ringFormations = integrator.findClosedBindingLoops(partlist)
-            if (3 in ringFormations):
+        # Binding events that close a loop are recorded by the integrator with their exact time
+        if (integrator.getNumberOfRingFormations() > 0):
+            ringFormation = integrator.popRingFormation()
+            if (ringFormation.loopSize == 3):
                 unbound = False
-                return 'trimeric-loop', integrator.clock
-            elif (4 in ringFormations):
+                return 'trimeric-loop', ringFormation.time
+            elif (ringFormation.loopSize == 4):
                 unbound = False
-                return 'tetrameric-loop', integrator.clock
-            elif (5 in ringFormations):
+                return 'tetrameric-loop', ringFormation.time
+            elif (ringFormation.loopSize == 5):
                 unbound = False
-                return "pentameric-loop", integrator.clock
-            elif integrator.clock >= 400.0:
-                unbound = False
-                return 'Failed at:', integrator.clock
-                #filenameLog = filename = "/run/media/maojrs/Mr300/Documents/Posdoc/projects/MSMRD2/" \
-                #                         "msmrd2/data/pentamer/debug/eventLog_" + str(trajectorynum)
-                #integrator.printEventLog(filenameLog)
+                return "pentameric-loop", ringFormation.time
+        if integrator.clock >= 400.0:
+            unbound = False
+            return 'Failed at:', integrator.clock
+            #filenameLog = filename = "/run/media/maojrs/Mr300/Documents/Posdoc/projects/MSMRD2/" \
+            #                         "msmrd2/data/pentamer/debug/eventLog_" + str(trajectorynum)
+            #integrator.printEventLog(filenameLog)
 
 
 
@@ -23,7 +23,9 @@ namespace msmrd {
                 .def("getPartition", &spherePartition::getPartition)
                 .def("getSectionNumber", &spherePartition::getSectionNumberPyBind)
                 .def("getAngles", &spherePartition::getAngles)
-                .def("setThetasOffset", &spherePartition::setThetasOffset);
+                .def("setThetasOffset", &spherePartition::setThetasOffset)
+                .def("setLookupTable", &spherePartition::setLookupTable)
+                .def("getLookupTableCoverage", &spherePartition::getLookupTableCoverage);
 
         py::class_<halfSpherePartition, spherePartition, std::shared_ptr<halfSpherePartition>>(m, "halfSpherePartition",
                                                                                    "Equal area partition of the"
@@ -38,7 +40,8 @@ namespace msmrd {
             .def("getPartition", &quaternionPartition::getPartition)
             .def("getSectionNumber", &quaternionPartition::getSectionNumberPyBind)
             .def("getSectionIntervals", &quaternionPartition::getSectionIntervals)
-            .def("setThetasOffset", &quaternionPartition::setThetasOffset);
+            .def("setThetasOffset", &quaternionPartition::setThetasOffset)
+            .def("setLookupTable", &quaternionPartition::setLookupTable);
 
         /* On binding of positionOrientationPartition, change default holder from unique_ptr to shared_ptr
          * to allow msmrdIntegrator to set positionOrientationPartition as shared pointer. This should also
@@ -53,7 +56,8 @@ namespace msmrd {
                 .def_property_readonly("numSections", &positionOrientationPartition::getNumSections)
                 .def("getSectionNumber", &positionOrientationPartition::getSectionNumberPyBind)
                 .def("getSectionNumbers", &positionOrientationPartition::getSectionNumbers)
-                .def("setThetasOffset", &positionOrientationPartition::setThetasOffset);
+                .def("setThetasOffset", &positionOrientationPartition::setThetasOffset)
+                .def("setLookupTable", &positionOrientationPartition::setLookupTable);
 
     };
 }
@@ -1,11 +1,15 @@
 #include "binding.hpp"
 #include "integrators/overdampedLangevin.hpp"
+#include "integrators/overdampedLangevinEngine.hpp"
+#include "integrators/overdampedLangevinMTS.hpp"
 #include "integrators/overdampedLangevinMarkovSwitch.hpp"
 #include "integrators/overdampedLangevinSelective.hpp"
 #include "integrators/msmrdIntegrator.hpp"
 #include "integrators/msmrdPatchyProtein.hpp"
 #include "integrators/msmrdMultiParticleIntegrator.hpp"
 #include "discretizations/positionOrientationPartition.hpp"
+#include "potentials/harmonicRepulsion.hpp"
+#include "potentials/patchyParticleAngular.hpp"
 
 
 namespace msmrd {
@@ -15,6 +19,16 @@ namespace msmrd {
     using msmrdMSM= msmrd::msmrdMarkovModel;
 
 
+    /* Binds one combination of the compile time specialized overdampedLangevinEngine, it is used in python
+     * as the generic overdampedLangevin */
+    template <typename ENGINE>
+    void bindOverdampedLangevinEngine(py::module &m, const char *name, const char *docstring) {
+        py::class_<ENGINE, overdampedLangevin>(m, name, docstring)
+                .def(py::init<double &, long &>())
+                .def("integrate", &ENGINE::integrate);
+    }
+
+
     /*
      * pyBinders for the c++ integrators classes
      */
@@ -23,7 +37,40 @@ namespace msmrd {
                                                                 "particlesbodytype (point, rod, rigidbody, "
                                                                 "pointmix, rodmix or rigidbodymix) )")
                 .def(py::init<double &, long &, std::string &>())
-                .def("integrate", &overdampedLangevin::integrate);
+                .def("integrate", &overdampedLangevin::integrate)
+                .def("setAdaptiveTimeStepping", &overdampedLangevin::setAdaptiveTimeStepping)
+                .def("disableAdaptiveTimeStepping", &overdampedLangevin::disableAdaptiveTimeStepping)
+                .def_property_readonly("adaptiveTimeStepping", &overdampedLangevin::isAdaptiveTimeStepping)
+                .def_property_readonly("numAcceptedSteps", &overdampedLangevin::getNumAcceptedSteps)
+                .def_property_readonly("numRejectedSteps", &overdampedLangevin::getNumRejectedSteps);
+
+        py::class_<overdampedLangevinMTS, overdampedLangevin>(m, "overdampedLangevinMTS", "multiple time step "
+                                                              "overdamped Langevin integrator, fast pair forces "
+                                                              "integrated in substeps (timestep, seed, "
+                                                              "particlesbodytype, numSubsteps)")
+                .def(py::init<double &, long &, std::string &, int &>())
+                .def("integrate", &overdampedLangevinMTS::integrate)
+                .def("setNumSubsteps", &overdampedLangevinMTS::setNumSubsteps)
+                .def_property_readonly("numSubsteps", &overdampedLangevinMTS::getNumSubsteps);
+
+        /* Pre-instantiated overdampedLangevinEngine combinations (potential, boundary, body type), the
+         * potential and boundary are set as usual with setPairPotential and setBoundary. */
+        bindOverdampedLangevinEngine<overdampedLangevinEngine<patchyParticleAngular2, periodicBoxPolicy, rigidBody>>(
+                m, "overdampedLangevinPatchyAngular2PeriodicBox", "overdamped Langevin integrator specialized for "
+                                                                  "patchyParticleAngular2, periodic box and rigid "
+                                                                  "bodies (timestep, seed)");
+        bindOverdampedLangevinEngine<overdampedLangevinEngine<patchyParticleAngular, periodicBoxPolicy, rigidBody>>(
+                m, "overdampedLangevinPatchyAngularPeriodicBox", "overdamped Langevin integrator specialized for "
+                                                                 "patchyParticleAngular, periodic box and rigid "
+                                                                 "bodies (timestep, seed)");
+        bindOverdampedLangevinEngine<overdampedLangevinEngine<harmonicRepulsion, periodicBoxPolicy, pointBody>>(
+                m, "overdampedLangevinHarmonicRepulsionPeriodicBox", "overdamped Langevin integrator specialized "
+                                                                     "for harmonicRepulsion, periodic box and point "
+                                                                     "particles (timestep, seed)");
+        bindOverdampedLangevinEngine<overdampedLangevinEngine<harmonicRepulsion, genericBoundaryPolicy, pointBody>>(
+                m, "overdampedLangevinHarmonicRepulsion", "overdamped Langevin integrator specialized for "
+                                                          "harmonicRepulsion and point particles, any boundary "
+                                                          "(timestep, seed)");
 
         py::class_<overdampedLangevinSelective, overdampedLangevin>(m, "overdampedLangevinSelective", "overdamped "
                                                                     "Langevin integrator with selective active patches."
@@ -35,7 +82,8 @@ namespace msmrd {
                 .def("integrate", &overdampedLangevinSelective::integrate)
                 .def("updateParticleCompounds", &overdampedLangevinSelective::updateParticleCompounds)
                 .def("findClosedBindingLoops", &overdampedLangevinSelective::findClosedBindingLoops)
-                .def("getCompoundSize", &overdampedLangevinSelective::getCompoundSize);
+                .def("getCompoundSize", &overdampedLangevinSelective::getCompoundSize)
+                .def("getParticleCompoundSize", &overdampedLangevinSelective::getParticleCompoundSize);
 
         py::class_<overdampedLangevinMarkovSwitch<ctmsm>, overdampedLangevin>(m, "overdampedLangevinMarkovSwitch",
                                                                               "overdamped Langevin integrator with "
@@ -45,7 +93,10 @@ namespace msmrd {
                                                                               "rigidbodymix) )")
                 .def(py::init<ctmsm &, double &, long &, std::string &>())
                 .def(py::init<std::vector<ctmsm> &, double &, long &, std::string &>())
-                .def("integrate", &overdampedLangevinMarkovSwitch<ctmsm>::integrate);
+                .def("integrate", &overdampedLangevinMarkovSwitch<ctmsm>::integrate)
+                .def("setEventDrivenSwitching", &overdampedLangevinMarkovSwitch<ctmsm>::setEventDrivenSwitching)
+                .def("isEventDrivenSwitching", &overdampedLangevinMarkovSwitch<ctmsm>::isEventDrivenSwitching)
+                .def("getNextSwitchTime", &overdampedLangevinMarkovSwitch<ctmsm>::getNextSwitchTime);
 
         /* Note this binding uses method overloading, and it therefore requires to explicitly state
          * the input arguments when functions are overloaded. */
@@ -67,6 +118,16 @@ namespace msmrd {
                         "Sets full position orientation discretization")
                 .def("setRecordEventLog", &msmrdIntegrator<ctmsm>::setRecordEventLog)
                 .def("printEventLog", &msmrdIntegrator<ctmsm>::printEventLog)
+                .def("setEventStream", &msmrdIntegrator<ctmsm>::setEventStream, py::arg("filename"),
+                     py::arg("bufferSize") = 4096, "records the applied events into the binary file filename.bin, "
+                     "read it with numpy.fromfile(filename, dtype=[('time', 'f8'), ('part1Index', 'i4'), "
+                     "('part2Index', 'i4'), ('originState', 'i4'), ('endState', 'i4'), ('type', 'i4'), "
+                     "('replicaID', 'i4')]), types: binding = 1, unbinding = 2, bound2bound = 3. Copies of "
+                     "the integrator (e.g. ensemble replicas) share the file, records are told apart by replicaID")
+                .def("closeEventStream", &msmrdIntegrator<ctmsm>::closeEventStream,
+                     "writes all the recorded events and closes the binary event stream")
+                .def("setCandidatePairsSkin", &msmrdIntegrator<ctmsm>::setCandidatePairsSkin,
+                     "sets the skin of the Verlet list of pairs that can be in the transition region")
                 .def("integrate", &msmrdIntegrator<ctmsm>::integrate);
 
 
@@ -111,11 +172,61 @@ namespace msmrd {
                 .def("getBindingsInCompound", &msmrdMultiParticleIntegrator<ctmsm>::getBindingsInCompound,
                      "gets bindings in a give compound")
                 .def("getCompoundSize", &msmrdMultiParticleIntegrator<ctmsm>::getCompoundSize,
-                     "gets compound size");
+                     "gets compound size")
+                .def("getNumberOfRingFormations", &msmrdMultiParticleIntegrator<ctmsm>::getNumberOfRingFormations,
+                     "gets number of binding events that closed a loop and were not popped yet")
+                .def("popRingFormation", &msmrdMultiParticleIntegrator<ctmsm>::popRingFormation,
+                     "removes and returns the oldest binding event that closed a loop")
+                .def("clearRingFormations", &msmrdMultiParticleIntegrator<ctmsm>::clearRingFormations,
+                     "clears the queue of binding events that closed a loop");
+
+        py::class_<ringFormationEvent>(m, "ringFormationEvent", "binding event that closed a loop in "
+                                                                "multiparticle MSM/RD")
+                .def_readonly("time", &ringFormationEvent::time)
+                .def_readonly("loopSize", &ringFormationEvent::loopSize)
+                .def_readonly("iIndex", &ringFormationEvent::iIndex)
+                .def_readonly("jIndex", &ringFormationEvent::jIndex)
+                .def_readonly("compoundIndex", &ringFormationEvent::compoundIndex);
 
 
         // Created c++ compatible particle list/vector/array of particles in python
-        py::bind_vector<std::vector<particle>>(m, "particleList", py::module_local());
+        py::bind_vector<std::vector<particle>>(m, "particleList", py::module_local())
+                /* Numpy views of all the particles, without copies. The views are only valid until the list is
+                 * resized. Positions, orientations and active flags can be written through the views; states
+                 * are read only views, since setting a state also resets the bound state (see setState). All of
+                 * them can be set in bulk by assigning an array of the same shape. */
+                .def_property("positions", [](py::object self) {
+                    return particleListView<double>(self, [](particle &part) { return part.position.data.data(); }, 3);
+                }, [](std::vector<particle> &self, py::array_t<double, py::array::c_style | py::array::forcecast> v) {
+                    setParticleListVariable<double>(self, [](particle &part, const double *value) {
+                        part.position = vec3<double>(value[0], value[1], value[2]); }, 3, v);
+                }, "(N,3) view of particle positions")
+                .def_property("orientations", [](py::object self) {
+                    return particleListView<double>(self, [](particle &part) {
+                        return part.orientation.data.data(); }, 4);
+                }, [](std::vector<particle> &self, py::array_t<double, py::array::c_style | py::array::forcecast> v) {
+                    setParticleListVariable<double>(self, [](particle &part, const double *value) {
+                        part.orientation = quaternion<double>(value[0], value[1], value[2], value[3]); }, 4, v);
+                }, "(N,4) view of particle orientations (quaternions)")
+                .def_property("orientvectors", [](py::object self) {
+                    return particleListView<double>(self, [](particle &part) {
+                        return part.orientvector.data.data(); }, 3);
+                }, [](std::vector<particle> &self, py::array_t<double, py::array::c_style | py::array::forcecast> v) {
+                    setParticleListVariable<double>(self, [](particle &part, const double *value) {
+                        part.orientvector = vec3<double>(value[0], value[1], value[2]); }, 3, v);
+                }, "(N,3) view of particle orientation vectors")
+                .def_property("states", [](py::object self) {
+                    return particleListView<int>(self, [](particle &part) { return &part.state; }, 1, false);
+                }, [](std::vector<particle> &self, py::array_t<int, py::array::c_style | py::array::forcecast> v) {
+                    setParticleListVariable<int>(self, [](particle &part, const int *value) {
+                        part.setState(value[0]); }, 1, v);
+                }, "(N) read only view of particle states")
+                .def_property("active", [](py::object self) {
+                    return particleListView<bool>(self, [](particle &part) { return &part.active; }, 1);
+                }, [](std::vector<particle> &self, py::array_t<bool, py::array::c_style | py::array::forcecast> v) {
+                    setParticleListVariable<bool>(self, [](particle &part, const bool *value) {
+                        part.active = value[0]; }, 1, v);
+                }, "(N) view of particle active flags");
 
     }
 
@@ -1,6 +1,7 @@
 //
 // Created by maojrs on 10/8/18.
 //
+#include <pybind11/functional.h>
 #include "binding.hpp"
 #include "boundaries/boundary.hpp"
 #include "integrators/integrator.hpp"
@@ -28,7 +29,23 @@ namespace msmrd {
                 .def("setKbT", &integrator::setKbT)
                 .def("setBoundary", &integrator::setBoundary)
                 .def("setExternalPotential", &integrator::setExternalPotential)
-                .def("setPairPotential", &integrator::setPairPotential);
+                .def("setPairPotential", &integrator::setPairPotential)
+                .def("setNeighborList", &integrator::setNeighborList, "activates cell list neighbor search for "
+                                                                      "pair potentials with finite cut off (skin),"
+                                                                      " skin > 0 uses a Verlet list")
+                .def("disableNeighborList", &integrator::disableNeighborList)
+                .def("setNumThreads", &integrator::setNumThreads, "number of threads to calculate forces and "
+                                                                  "torques (requires OpenMP)")
+                .def_property_readonly("numThreads", &integrator::getNumThreads)
+                .def("integrateSteps", &integrator::integrateSteps, "integrates nsteps time steps with the GIL "
+                                                                    "released, stops early if stopCondition(partlist,"
+                                                                    " clock) returns true; returns number of steps",
+                     py::arg("partlist"), py::arg("nsteps"), py::arg("stopCondition") = nullptr,
+                     py::call_guard<py::gil_scoped_release>())
+                .def("setRandomGenerator", &integrator::setRandomGenerator, "random number generator: mt19937 "
+                                                                            "(default) or philox (counter-based)")
+                .def("setReplicaID", &integrator::setReplicaID, "replica key of the counter-based generator")
+                .def_property_readonly("randomGenerator", &integrator::getRandomGenerator);
 
         /* Bind Markov models parent class*/
         pybind11::class_<markovModel>(m, "markovModel")
@@ -63,7 +80,8 @@ namespace msmrd {
         /* Bind pair potential parent class */
         pybind11::class_<pairPotential>(m, "pairPotential")
                 .def("evaluate", &pairPotential::evaluate)
-                .def("forceTorque", &pairPotential::forceTorquePyBind);
+                .def("forceTorque", &pairPotential::forceTorquePyBind)
+                .def_property_readonly("cutOff", &pairPotential::getCutOff);
     }
 
 }
@@ -39,7 +39,16 @@ namespace msmrd {
                                         "seed")
                 .def(py::init<unsigned int &, unsigned int &, std::vector<std::vector<double>> &,
                         std::vector<int> &, float &, long &>())
+                .def(py::init<unsigned int &, unsigned int &, std::vector<int> &, std::vector<int> &,
+                        std::vector<double> &, std::vector<int> &, float &, long &>(),
+                     "sparse transition matrix in CSR format (indptr, indices, data of a scipy csr_matrix)")
                 .def("calculateTransition", &msmrdMSM::calculateTransition)
+                .def("getMSMindex", &msmrdMSM::getMSMindex)
+                .def("getActiveSetIndex", &msmrdMSM::getActiveSetIndex)
+                .def("getTransitionProbability", &msmrdMSM::getTransitionProbability)
+                .def_property_readonly("rowOffsets", &msmrdMSM::getRowOffsets)
+                .def_property_readonly("columns", &msmrdMSM::getColumns)
+                .def_property_readonly("values", &msmrdMSM::getValues)
                 .def("setDbound", &msmrdMSM::setDbound)
                 .def("setMaxNumberBoundStates", &msmrdMSM::setMaxNumberBoundStates);
 
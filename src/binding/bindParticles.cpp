@@ -2,11 +2,21 @@
 // Created by maojrs on 9/7/18.
 //
 #include "binding.hpp"
+#include "bondGraph.hpp"
 #include "particle.hpp"
 #include "particleCompound.hpp"
+#include "particleSoA.hpp"
 
 
 namespace msmrd {
+    /* Numpy view (no copy) of one of the arrays of a particleSoA container, writing into the view writes into
+     * the container. The view keeps the container alive, but it is only valid until the container is resized. */
+    template <typename T>
+    py::array_t<T> particleSoAView(py::object container, std::vector<T> particleSoA::*variable) {
+        auto &values = container.cast<particleSoA &>().*variable;
+        return py::array_t<T>(static_cast<py::ssize_t>(values.size()), values.data(), container);
+    }
+
     /*
      * pyBinders for the c++ particles classes
      */
@@ -72,6 +82,41 @@ namespace msmrd {
                 .def(py::init<std::vector<double> &>())
                 .def(py::init<std::map<std::tuple<int,int>, int> &>())
                 .def(py::init<std::vector<double> &, std::map<std::tuple<int,int>, int> &>());
+
+        py::class_<bondGraph>(m, "bondGraph", "graph of the bonds between particles that keeps track of the "
+                                              "compounds and rings incrementally, bondGraph (numParticles)")
+                .def(py::init<int>())
+                .def("reset", &bondGraph::reset)
+                .def("addBond", &bondGraph::addBond)
+                .def("removeBond", &bondGraph::removeBond)
+                .def("isBound", &bondGraph::isBound)
+                .def("getCompoundSize", &bondGraph::getCompoundSize)
+                .def("getCompoundBonds", &bondGraph::getCompoundBonds)
+                .def("isInRing", &bondGraph::isInRing)
+                .def("getRingSizes", &bondGraph::getRingSizes)
+                .def_property_readonly("numParticles", &bondGraph::getNumberOfParticles)
+                .def_property_readonly("numBonds", &bondGraph::getNumberOfBonds)
+                .def_property_readonly("numRings", &bondGraph::getNumberOfRings);
+
+        py::class_<particleSoA>(m, "particleSoA", "structure of arrays container for particles, "
+                                                  "particleSoA (particleList)")
+                .def(py::init<>())
+                .def(py::init<std::vector<particle> &>())
+                .def_property_readonly("size", &particleSoA::size)
+                .def("getParticle", &particleSoA::getParticle)
+                .def("setParticle", &particleSoA::setParticle)
+                .def("fromParticleList", &particleSoA::fromParticleList)
+                .def("toParticleList", &particleSoA::toParticleList)
+                .def("copyToParticleList", &particleSoA::copyToParticleList)
+                .def_property_readonly("x", [](py::object self) { return particleSoAView(self, &particleSoA::x); })
+                .def_property_readonly("y", [](py::object self) { return particleSoAView(self, &particleSoA::y); })
+                .def_property_readonly("z", [](py::object self) { return particleSoAView(self, &particleSoA::z); })
+                .def_property_readonly("q0", [](py::object self) { return particleSoAView(self, &particleSoA::q0); })
+                .def_property_readonly("q1", [](py::object self) { return particleSoAView(self, &particleSoA::q1); })
+                .def_property_readonly("q2", [](py::object self) { return particleSoAView(self, &particleSoA::q2); })
+                .def_property_readonly("q3", [](py::object self) { return particleSoAView(self, &particleSoA::q3); })
+                .def_property_readonly("state", [](py::object self) {
+                    return particleSoAView(self, &particleSoA::state); });
     }
 
 }
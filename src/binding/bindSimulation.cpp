@@ -1,14 +1,131 @@
+#include <limits>
+#include <pybind11/functional.h>
 #include "binding.hpp"
+#include "ensembleRunner.hpp"
+#include "firstPassage.hpp"
 #include "simulation.hpp"
+#include "integrators/msmrdIntegrator.hpp"
+#include "integrators/msmrdMultiParticleIntegrator.hpp"
+#include "integrators/overdampedLangevin.hpp"
+#include "integrators/overdampedLangevinSelective.hpp"
+#include "trajectories/discrete/patchyDimerTrajectory.hpp"
+#include "trajectories/discrete/patchyProteinTrajectory.hpp"
 
 namespace msmrd {
+    using ctmsm = msmrd::continuousTimeMarkovStateModel;
+
+    /* Binds the ensemble runner for one integrator class. The particle generator, stop condition and callback
+     * are python functions (pybind acquires the GIL to call them); the GIL is released while running. The
+     * random number generator of each replica is not bound, so the python generator is called as
+     * generator(replica, replicaSeed), with a seed drawn from it. The seeds are reproducible for a given runner
+     * seed (>= 0) and independent between replicas, e.g. to use with numpy.random.default_rng(replicaSeed). */
+    template <typename INTEGRATOR>
+    void bindEnsembleRunner(py::module &m, const char *name, const char *docstring) {
+        using runner = ensembleRunner<INTEGRATOR>;
+        py::class_<runner>(m, name, docstring)
+                .def(py::init([](const INTEGRATOR &integ, std::function<std::vector<particle>(int, long)> generator,
+                                 long seed) {
+                    auto replicaGenerator = [generator](int replica, randomgen &randg) {
+                        long replicaSeed = randg.uniformInteger(0, std::numeric_limits<int>::max());
+                        return generator(replica, replicaSeed);
+                    };
+                    return std::make_unique<runner>(integ, replicaGenerator, seed);
+                }), py::arg("integrator"), py::arg("generator"), py::arg("seed"))
+                .def("setStopCondition", &runner::setStopCondition)
+                .def("setNumThreads", &runner::setNumThreads)
+                .def_property_readonly("numThreads", &runner::getNumThreads)
+                .def("run", &runner::run, py::arg("numReplicas"), py::arg("maxSteps"),
+                     py::arg("callback") = nullptr, py::call_guard<py::gil_scoped_release>());
+    }
+
+    /* Binds the first passage driver for one integrator class. The conditions are evaluated in c++, so the GIL
+     * is released while running. */
+    template <typename INTEGRATOR>
+    void bindFirstPassage(py::module &m, const char *name, const char *docstring) {
+        using driver = firstPassage<INTEGRATOR>;
+        py::class_<driver>(m, name, docstring)
+                .def(py::init<INTEGRATOR &>(), py::keep_alive<1, 2>())
+                .def("addCondition", &driver::addCondition)
+                .def("clearConditions", &driver::clearConditions)
+                .def_property_readonly("numConditions", &driver::getNumberOfConditions)
+                .def("run", &driver::run, py::arg("partlist"), py::arg("maxSteps") = -1,
+                     py::call_guard<py::gil_scoped_release>());
+    }
+
     /*
-     * pyBinders for the c++ integrators classes
+     * pyBinders for the c++ simulation classes
      */
-
-void bindSimulation(py::module &m) {
+    void bindSimulation(py::module &m) {
         py::class_<simulation>(m, "simulation")
                 .def(py::init<integrator &>())
-                .def("run", &simulation::run);
-        }
+                .def("run", &simulation::run, py::call_guard<py::gil_scoped_release>());
+
+        py::class_<replicaResult>(m, "replicaResult", "result of one replica of an ensemble run")
+                .def_readonly("replica", &replicaResult::replica)
+                .def_readonly("time", &replicaResult::time)
+                .def_readonly("numSteps", &replicaResult::numSteps)
+                .def_readonly("stopped", &replicaResult::stopped)
+                .def_readonly("particles", &replicaResult::particles);
+
+        /* Ensemble runners (prototype integrator, particle list generator(replica, replicaSeed), seed); the
+         * prototype integrator is copied when the runner is created. */
+        bindEnsembleRunner<overdampedLangevin>(m, "ensembleRunner", "runs independent replicas of an "
+                                                                    "overdampedLangevin simulation in parallel");
+        bindEnsembleRunner<overdampedLangevinSelective>(m, "ensembleRunnerSelective", "runs independent replicas "
+                                                                                      "of an overdampedLangevin"
+                                                                                      "Selective simulation in "
+                                                                                      "parallel");
+        bindEnsembleRunner<msmrdIntegrator<ctmsm>>(m, "ensembleRunnerMSMRD", "runs independent replicas of an "
+                                                                             "MSM/RD simulation in parallel");
+
+        /* Stopping conditions of first passage time simulations, composable with &, | and ~. The discrete
+         * trajectory of discreteStates is kept alive by the condition. */
+        py::class_<passageCondition>(m, "passageCondition", "stopping condition of first passage time simulation")
+                .def_static("boundStates", &passageCondition::boundStates, py::arg("states"),
+                            py::arg("iIndex") = 0, py::arg("jIndex") = 1)
+                .def_static("discreteStates", &passageCondition::discreteStates<patchyDimerTrajectory>,
+                            py::arg("discreteTraj"), py::arg("states"), py::arg("iIndex") = 0,
+                            py::arg("jIndex") = 1, py::keep_alive<0, 1>())
+                .def_static("discreteStates", &passageCondition::discreteStates<patchyDimerTrajectory2>,
+                            py::arg("discreteTraj"), py::arg("states"), py::arg("iIndex") = 0,
+                            py::arg("jIndex") = 1, py::keep_alive<0, 1>())
+                .def_static("discreteStates", &passageCondition::discreteStates<patchyProteinTrajectory>,
+                            py::arg("discreteTraj"), py::arg("states"), py::arg("iIndex") = 0,
+                            py::arg("jIndex") = 1, py::keep_alive<0, 1>())
+                .def_static("unbound", &passageCondition::unbound, py::arg("distance"),
+                            py::arg("iIndex") = 0, py::arg("jIndex") = 1)
+                .def_static("ringFormationSelective", &passageCondition::ringFormation<overdampedLangevinSelective>)
+                .def_static("ringFormationMSMRD", &passageCondition::ringFormation<msmrdMultiParticleIntegrator<ctmsm>>)
+                .def_static("clockLimit", &passageCondition::clockLimit)
+                .def_static("allOf", &passageCondition::allOf)
+                .def_static("anyOf", &passageCondition::anyOf)
+                .def_static("negation", &passageCondition::negation)
+                .def("__and__", [](const passageCondition &self, const passageCondition &other) {
+                    return passageCondition::allOf({self, other}); })
+                .def("__or__", [](const passageCondition &self, const passageCondition &other) {
+                    return passageCondition::anyOf({self, other}); })
+                .def("__invert__", &passageCondition::negation);
+
+        py::class_<passageResult>(m, "passageResult", "result of first passage time simulation")
+                .def_readonly("time", &passageResult::time)
+                .def_readonly("numSteps", &passageResult::numSteps)
+                .def_readonly("condition", &passageResult::condition)
+                .def_readonly("conditionName", &passageResult::conditionName);
+
+        /* First passage time drivers (integrator); the integrator is referenced, so the particle list is
+         * integrated from the current clock of the integrator. */
+        bindFirstPassage<overdampedLangevin>(m, "firstPassage", "first passage time driver of overdamped"
+                                                                "Langevin simulation");
+        bindFirstPassage<overdampedLangevinSelective>(m, "firstPassageSelective", "first passage time driver of "
+                                                                                  "overdampedLangevinSelective "
+                                                                                  "simulation");
+        bindFirstPassage<msmrdIntegrator<ctmsm>>(m, "firstPassageMSMRD", "first passage time driver of MSM/RD "
+                                                                         "simulation");
+        bindFirstPassage<msmrdMultiParticleIntegrator<ctmsm>>(m, "firstPassageMSMRDMultiParticle",
+                                                              "first passage time driver of multi-particle "
+                                                              "MSM/RD simulation");
+        bindEnsembleRunner<msmrdMultiParticleIntegrator<ctmsm>>(m, "ensembleRunnerMSMRDMultiParticle",
+                                                                "runs independent replicas of a multi-particle "
+                                                                "MSM/RD simulation in parallel");
+    }
 }
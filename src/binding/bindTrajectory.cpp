@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "binding.hpp"
 #include "trajectories/trajectoryPosition.hpp"
 #include "trajectories/trajectoryPositionOrientation.hpp"
@@ -7,6 +8,46 @@
 
 
 namespace msmrd {
+    /* Discretizes a numpy trajectory array of shape (timesteps, particles, columns) with
+     * discretizeTrajectoryBatch, without holding the GIL. Returns int32 array of shape (timesteps, pairs). */
+    template<typename DISCRETETRAJECTORY>
+    py::array_t<std::int32_t> discretizeTrajectoryBatch(
+            DISCRETETRAJECTORY &discreteTraj,
+            py::array_t<double, py::array::c_style | py::array::forcecast> trajectory) {
+        if (trajectory.ndim() != 3) {
+            throw std::invalid_argument("Trajectory array must have shape (timesteps, particles, columns)");
+        }
+        auto numTimesteps = static_cast<long>(trajectory.shape(0));
+        auto numParticles = static_cast<int>(trajectory.shape(1));
+        auto numColumns = static_cast<int>(trajectory.shape(2));
+        std::vector<std::int32_t> discreteTrajectories;
+        {
+            py::gil_scoped_release release;
+            discreteTrajectories = discreteTraj.discretizeTrajectoryBatch(trajectory.data(), numTimesteps,
+                                                                          numParticles, numColumns);
+        }
+        py::ssize_t numPairs = numParticles * (numParticles - 1) / 2;
+        auto result = py::array_t<std::int32_t>(std::vector<py::ssize_t>{numTimesteps, numPairs});
+        std::copy(discreteTrajectories.begin(), discreteTrajectories.end(), result.mutable_data());
+        return result;
+    }
+
+    // Same as discretizeTrajectoryBatch but loading the trajectory from an H5 file
+    template<typename DISCRETETRAJECTORY>
+    py::array_t<std::int32_t> discretizeTrajectoryBatchH5(DISCRETETRAJECTORY &discreteTraj, std::string filename,
+                                                          int numParticles) {
+        std::vector<std::int32_t> discreteTrajectories;
+        {
+            py::gil_scoped_release release;
+            discreteTrajectories = discreteTraj.discretizeTrajectoryBatchH5(filename, numParticles);
+        }
+        py::ssize_t numPairs = numParticles * (numParticles - 1) / 2;
+        auto numTimesteps = static_cast<py::ssize_t>(discreteTrajectories.size()) / numPairs;
+        auto result = py::array_t<std::int32_t>(std::vector<py::ssize_t>{numTimesteps, numPairs});
+        std::copy(discreteTrajectories.begin(), discreteTrajectories.end(), result.mutable_data());
+        return result;
+    }
+
     /*
      * pyBinders for the c++ trajectories classes
      */
@@ -56,6 +97,11 @@ namespace msmrd {
                 .def("getState", &patchyDimerTrajectory::sampleDiscreteState)
                 .def("discretizeTrajectory", &patchyDimerTrajectory::discretizeTrajectory)
                 .def("discretizeTrajectoryH5", &patchyDimerTrajectory::discretizeTrajectoryH5)
+                .def("discretizeTrajectoryBatch", &discretizeTrajectoryBatch<patchyDimerTrajectory>,
+                     py::arg("trajectory"))
+                .def("discretizeTrajectoryBatchH5", &discretizeTrajectoryBatchH5<patchyDimerTrajectory>,
+                     py::arg("filename"), py::arg("numParticles") = 2)
+                .def("setNumThreads", &patchyDimerTrajectory::setNumThreads)
                 .def("write2H5file", &patchyDimerTrajectory::write2H5file<double, 8>)
                 .def("writeChunk2H5file", &patchyDimerTrajectory::writeChunk2H5file<double, 8>);
 
@@ -76,6 +122,11 @@ namespace msmrd {
                 .def("getState", &patchyDimerTrajectory2::sampleDiscreteState)
                 .def("discretizeTrajectory", &patchyDimerTrajectory2::discretizeTrajectory)
                 .def("discretizeTrajectoryH5", &patchyDimerTrajectory2::discretizeTrajectoryH5)
+                .def("discretizeTrajectoryBatch", &discretizeTrajectoryBatch<patchyDimerTrajectory2>,
+                     py::arg("trajectory"))
+                .def("discretizeTrajectoryBatchH5", &discretizeTrajectoryBatchH5<patchyDimerTrajectory2>,
+                     py::arg("filename"), py::arg("numParticles") = 2)
+                .def("setNumThreads", &patchyDimerTrajectory2::setNumThreads)
                 .def("write2H5file", &patchyDimerTrajectory2::write2H5file<double, 8>)
                 .def("writeChunk2H5file", &patchyDimerTrajectory2::writeChunk2H5file<double, 8>);
 
@@ -98,6 +149,11 @@ namespace msmrd {
                 .def("getState", &patchyProteinTrajectory::sampleDiscreteState)
                 .def("discretizeTrajectory", &patchyProteinTrajectory::discretizeTrajectory)
                 .def("discretizeTrajectoryH5", &patchyProteinTrajectory::discretizeTrajectoryH5)
+                .def("discretizeTrajectoryBatch", &discretizeTrajectoryBatch<patchyProteinTrajectory>,
+                     py::arg("trajectory"))
+                .def("discretizeTrajectoryBatchH5", &discretizeTrajectoryBatchH5<patchyProteinTrajectory>,
+                     py::arg("filename"), py::arg("numParticles") = 2)
+                .def("setNumThreads", &patchyProteinTrajectory::setNumThreads)
                 .def("write2H5file", &patchyProteinTrajectory::write2H5file<double, 8>)
                 .def("writeChunk2H5file", &patchyProteinTrajectory::writeChunk2H5file<double, 8>);
 
@@ -42,4 +42,50 @@ namespace msmrd {
             ptr[idx] = v[idx];
         return result;
     }
+
+    // The active flags are viewed as numpy booleans, which are one byte (see particleListView)
+    static_assert(sizeof(bool) == 1, "Numpy views of boolean particle variables require one byte booleans");
+
+    /* Function template to get a numpy view (no copy) of one variable of all the particles in a particle list,
+     * with shape (N) or (N, numComponents). The stride between rows is the size of the particle class, so writing
+     * into the view writes directly into the particles. The view keeps the python particle list alive, but it is
+     * only valid while the particle list is not resized (e.g. by append). */
+    template<typename T>
+    py::array_t<T> particleListView(py::object partlist, T *(*variable)(particle &), py::ssize_t numComponents,
+                                    bool writeable = true) {
+        auto &parts = partlist.cast<std::vector<particle> &>();
+        auto numParticles = static_cast<py::ssize_t>(parts.size());
+        std::vector<py::ssize_t> shape = {numParticles};
+        std::vector<py::ssize_t> strides = {static_cast<py::ssize_t>(sizeof(particle))};
+        if (numComponents > 1) {
+            shape.push_back(numComponents);
+            strides.push_back(static_cast<py::ssize_t>(sizeof(T)));
+        }
+        if (numParticles == 0) {
+            return py::array_t<T>(shape);
+        }
+        auto result = py::array_t<T>(shape, strides, variable(parts[0]), partlist);
+        if (not writeable) {
+            result.attr("setflags")(py::arg("write") = false);
+        }
+        return result;
+    }
+
+    /* Function template to set one variable of all the particles in a particle list from a numpy array of shape
+     * (N) or (N, numComponents), used to set initial conditions in bulk. */
+    template<typename T>
+    void setParticleListVariable(std::vector<particle> &parts, void (*setVariable)(particle &, const T *),
+                                 py::ssize_t numComponents,
+                                 py::array_t<T, py::array::c_style | py::array::forcecast> values) {
+        auto numParticles = static_cast<py::ssize_t>(parts.size());
+        bool validShape = (numComponents > 1 and values.ndim() == 2 and values.shape(1) == numComponents) or
+                          (numComponents == 1 and values.ndim() == 1);
+        if (not validShape or values.shape(0) != numParticles) {
+            throw std::invalid_argument("Array shape doesn't match the number of particles and components");
+        }
+        const T *data = values.data();
+        for (py::ssize_t i = 0; i < numParticles; i++) {
+            setVariable(parts[i], data + i * numComponents);
+        }
+    }
 }
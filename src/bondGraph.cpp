@@ -0,0 +1,157 @@
+//
+// Created by maojrs on 4/16/20.
+//
+
+#include <algorithm>
+#include <stdexcept>
+#include "bondGraph.hpp"
+
+namespace msmrd {
+    /**
+     * Implementation of the bond graph class
+     * @param numParticles number of particles, initially all unbound
+     */
+    bondGraph::bondGraph(int numParticles) {
+        reset(numParticles);
+    }
+
+    // Removes all the bonds and sets the number of particles
+    void bondGraph::reset(int numParticles) {
+        if (numParticles < 0) {
+            throw std::invalid_argument("Number of particles must be non-negative");
+        }
+        parent.resize(numParticles);
+        for (int i = 0; i < numParticles; i++) {
+            parent[i] = i;
+        }
+        compoundSize.assign(numParticles, 1);
+        compoundBonds.assign(numParticles, 0);
+        bonds.assign(numParticles, std::vector<int>());
+        ringRoots.clear();
+        numBonds = 0;
+    }
+
+    /* Binds particles iIndex and jIndex. Returns true if the bond closes a loop, i.e. both particles were already
+     * in the same compound. Binding two particles that are already bound doesn't change the graph. */
+    bool bondGraph::addBond(int iIndex, int jIndex) {
+        if (iIndex == jIndex) {
+            throw std::invalid_argument("A particle can't be bound to itself");
+        }
+        if (isBound(iIndex, jIndex)) {
+            return false;
+        }
+        bonds[iIndex].push_back(jIndex);
+        bonds[jIndex].push_back(iIndex);
+        numBonds++;
+        int iRoot = findRoot(iIndex);
+        int jRoot = findRoot(jIndex);
+        if (iRoot == jRoot) {
+            compoundBonds[iRoot]++;
+            updateRing(iRoot);
+            return true;
+        }
+        // Union by size, the root of the larger compound becomes the root of the joint compound
+        if (compoundSize[iRoot] < compoundSize[jRoot]) {
+            std::swap(iRoot, jRoot);
+        }
+        parent[jRoot] = iRoot;
+        compoundSize[iRoot] += compoundSize[jRoot];
+        compoundBonds[iRoot] += compoundBonds[jRoot] + 1;
+        ringRoots.erase(jRoot);
+        updateRing(iRoot);
+        return false;
+    }
+
+    /* Unbinds particles iIndex and jIndex. If they are no longer connected, the compound is split in two. Returns
+     * false if the particles were not bound. */
+    bool bondGraph::removeBond(int iIndex, int jIndex) {
+        if (not isBound(iIndex, jIndex)) {
+            return false;
+        }
+        bonds[iIndex].erase(std::find(bonds[iIndex].begin(), bonds[iIndex].end(), jIndex));
+        bonds[jIndex].erase(std::find(bonds[jIndex].begin(), bonds[jIndex].end(), iIndex));
+        numBonds--;
+        ringRoots.erase(findRoot(iIndex));
+        relabelCompound(iIndex);
+        // If jIndex is not in the compound of iIndex anymore, the rest of the old compound forms a new compound
+        if (std::find(members.begin(), members.end(), jIndex) == members.end()) {
+            relabelCompound(jIndex);
+        }
+        return true;
+    }
+
+    bool bondGraph::isBound(int iIndex, int jIndex) const {
+        auto &iBonds = bonds[iIndex];
+        return std::find(iBonds.begin(), iBonds.end(), jIndex) != iBonds.end();
+    }
+
+    // Number of particles in the compound of the particle index
+    int bondGraph::getCompoundSize(int index) {
+        return compoundSize[findRoot(index)];
+    }
+
+    // Number of bonds in the compound of the particle index
+    int bondGraph::getCompoundBonds(int index) {
+        return compoundBonds[findRoot(index)];
+    }
+
+    bool bondGraph::isInRing(int index) {
+        return ringRoots.count(findRoot(index)) > 0;
+    }
+
+    // Returns the sizes of all the rings, sorted by the index of the root particle of each ring
+    std::vector<int> bondGraph::getRingSizes() const {
+        std::vector<int> ringSizes;
+        ringSizes.reserve(ringRoots.size());
+        for (auto root : ringRoots) {
+            ringSizes.push_back(compoundSize[root]);
+        }
+        return ringSizes;
+    }
+
+    // Finds the root of the compound of a particle, halving the path to the root on the way
+    int bondGraph::findRoot(int index) {
+        while (parent[index] != index) {
+            parent[index] = parent[parent[index]];
+            index = parent[index];
+        }
+        return index;
+    }
+
+    // Updates the ring status of the compound with the given root
+    void bondGraph::updateRing(int root) {
+        if (compoundSize[root] > 2 and compoundBonds[root] == compoundSize[root]) {
+            ringRoots.insert(root);
+        } else {
+            ringRoots.erase(root);
+        }
+    }
+
+    /* Finds all the particles connected to index (depth first search over the bonds) and makes them a compound
+     * with index as root. */
+    void bondGraph::relabelCompound(int index) {
+        members.clear();
+        stack.assign(1, index);
+        parent[index] = -1;
+        int degreeSum = 0;
+        while (not stack.empty()) {
+            int current = stack.back();
+            stack.pop_back();
+            members.push_back(current);
+            degreeSum += static_cast<int>(bonds[current].size());
+            for (auto neighbor : bonds[current]) {
+                if (parent[neighbor] != -1) {
+                    parent[neighbor] = -1;
+                    stack.push_back(neighbor);
+                }
+            }
+        }
+        for (auto member : members) {
+            parent[member] = index;
+        }
+        compoundSize[index] = static_cast<int>(members.size());
+        compoundBonds[index] = degreeSum / 2;
+        updateRing(index);
+    }
+
+}
@@ -64,6 +64,13 @@ namespace msmrd {
         quatPartition->setThetasOffset(offset);
     };
 
+    /* Enables the cube map lookup tables of the spherical partitions of the relative position and of the
+     * relative orientation, see spherePartition::setLookupTable. A zero resolution disables them. */
+    void positionOrientationPartition::setLookupTable(int resolution) {
+        sphericalPartition->setLookupTable(resolution);
+        quatPartition->setLookupTable(resolution);
+    };
+
 
 
     /* Gets other two section numbers corresponding to the positionOrientationPartition section number.
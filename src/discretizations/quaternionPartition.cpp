@@ -2,6 +2,8 @@
 // Created by maojrs on 3/27/19.
 //
 
+#include <algorithm>
+#include <cmath>
 #include "discretizations/quaternionPartition.hpp"
 
 namespace msmrd {
@@ -23,6 +25,12 @@ namespace msmrd {
         sphericalPartition->setThetasOffset(offset);
     };
 
+    /* Enables the cube map lookup table of the spherical partition (used in every shell), see
+     * spherePartition::setLookupTable. A zero resolution disables it. */
+    void quaternionPartition::setLookupTable(int resolution) {
+        sphericalPartition->setLookupTable(resolution);
+    };
+
     // Defines the location of the radial cuts between the origin and r=1.
     void quaternionPartition::makeRadialPartition() {
         double dr = 1.0/numRadialSections;
@@ -58,24 +66,19 @@ namespace msmrd {
         if (rReduced > 1) {
         	rReduced = 1.0;
         }
-		bool foundSectionNumber = false;
-        for (int i = 0; i < numRadialSections; i++){
-            if (rReduced <= radialSections[i+1]){
-                if (i == 0) {
-                    sectionNumber = 1;
-                    foundSectionNumber = true;
-                    break;
-                } else {
-                    sectionNumber = numSphericalSections*(i-1) + 1;
-                    sectionNumber += sphericalPartition->getSectionNumber(reducedCoordinate);
-                    foundSectionNumber = true;
-                    break;
-                }
-            }
+        // Find radial shell, the first one with rReduced <= radialSections[i+1]
+        auto shellEnd = std::lower_bound(std::next(radialSections.begin()), radialSections.end(), rReduced);
+        if (shellEnd == radialSections.end() or std::isnan(rReduced)) {
+            throw std::invalid_argument("Couldn't get section number. See getSectionNumber function of "
+                                        "quaternionPartition");
+        }
+        int i = static_cast<int>(shellEnd - radialSections.begin()) - 1;
+        if (i == 0) {
+            sectionNumber = 1;
+        } else {
+            sectionNumber = numSphericalSections*(i-1) + 1;
+            sectionNumber += sphericalPartition->getSectionNumber(reducedCoordinate);
         }
-        if (not foundSectionNumber) {
-			throw std::invalid_argument("Couldn't get section number. See getSectionNumber function of quaternionPartition");
-		}
         return sectionNumber;
     };
 
@@ -1,6 +1,8 @@
 //
 // Created by maojrs on 1/31/19.
 //
+#include <algorithm>
+#include <cmath>
 #include "discretizations/spherePartition.hpp"
 
 namespace msmrd{
@@ -93,6 +95,40 @@ namespace msmrd{
         // Adds one at the beginning and end of the array for caps at top and bottom
         regionsPerCollar[0] = 1;
         regionsPerCollar[num_collars + 1] = 1;
+        setSectionOffsets();
+    }
+
+    /* Precomputes the number of sections before each collar and the theta cuts compensated for the offset, so
+     * getSectionNumber and getAngles don't need to sum the regions per collar or shift the cuts on every call. */
+    void spherePartition::setSectionOffsets() {
+        collarOffsets.resize(regionsPerCollar.size() + 1);
+        collarOffsets[0] = 0;
+        for (int i = 0; i < regionsPerCollar.size(); i++) {
+            collarOffsets[i + 1] = collarOffsets[i] + regionsPerCollar[i];
+        }
+        collarThetas = thetas;
+        for (auto &thetaList : collarThetas) {
+            for (auto &theta : thetaList) {
+                // Compensate for the offset and ensure non-negative values
+                theta -= thetasOffset;
+                if (theta < 0) {
+                    theta += 2 * M_PI;
+                }
+            }
+        }
+    }
+
+    // Returns index of the collar that contains the polar angle phi (the last one with phis[index] <= phi).
+    int spherePartition::getCollarIndex(double phi) const {
+        auto collar = std::upper_bound(phis.begin(), phis.end(), phi) - phis.begin() - 1;
+        return std::max(static_cast<int>(collar), 0);
+    }
+
+    /* Returns index of the section in the collar that contains the azimuthal angle theta (already compensated for
+     * the offset), or -1 if theta is below the first cut. */
+    int spherePartition::getThetaIndex(int collarIndex, double theta) const {
+        const auto &cuts = collarThetas[collarIndex - 1];
+        return static_cast<int>(std::upper_bound(cuts.begin(), cuts.end(), theta) - cuts.begin()) - 1;
     }
 
 
@@ -108,6 +144,10 @@ namespace msmrd{
                  theta += offset;
              }
          }
+        setSectionOffsets();
+        if (lookupResolution > 0) {
+            buildLookupTable();
+        }
      };
 
 
@@ -117,6 +157,12 @@ namespace msmrd{
         if (scaling == 2 and coordinate[1] < 0) {
             throw std::invalid_argument("Error: y coordinate must be positive in half sphere discretization");
         }
+        if (lookupResolution > 0) {
+            int sectionNum = lookupSectionNumber(coordinate);
+            if (sectionNum > 0) {
+                return sectionNum;
+            }
+        }
         // Calculate theta and phi of coordinate
         double theta = std::atan2(coordinate[1], coordinate[0]) - thetasOffset;
         if (theta < 0) {
@@ -124,48 +170,19 @@ namespace msmrd{
         }
         double r = coordinate.norm();
         double phi = std::acos(coordinate[2] / r);
-        int currentCollarIndex;
-        int currentThetaIndex;
         // Find intersection of coordinate with section
-        int sectionNum;
-        int numCollars = phis.size();
-        for (int i = 0; i < numCollars; i++){
-            if (phi >= phis[numCollars - 1 - i]){
-                currentCollarIndex = numCollars-1-i;
-                break;
-            }
-        }
+        int currentCollarIndex = getCollarIndex(phi);
         if (currentCollarIndex == 0) {
-            sectionNum = 1;
-            return sectionNum;
+            return 1;
         }
         if (currentCollarIndex == regionsPerCollar.size()-1) {
-            sectionNum = numSections;
-            return sectionNum;
-        }
-        std::vector<double> collarThetas = thetas[currentCollarIndex - 1];
-        int numThetaCuts = collarThetas.size();
-        double newTheta;
-        bool foundThetaIndex = false;
-        for (int i = 0; i < numThetaCuts; i++){
-            // Compensate for the offset and ensure non-negative values
-            newTheta = collarThetas[numThetaCuts - 1 - i] - thetasOffset;
-            if (newTheta < 0) {
-            	newTheta += 2*M_PI;
-            } 
-            if(theta >= newTheta){
-                currentThetaIndex = numThetaCuts - 1 - i;
-                foundThetaIndex = true;
-                break;
-            }
+            return numSections;
         }
-        if (not foundThetaIndex) {
+        int currentThetaIndex = getThetaIndex(currentCollarIndex, theta);
+        if (currentThetaIndex < 0) {
         	throw std::invalid_argument("Error w/sphere discretization. Cant get section number (see getSectionNumber function)");
         }
-        sectionNum = std::accumulate(std::begin(regionsPerCollar), std::next(std::begin(regionsPerCollar),
-                                     currentCollarIndex), 0) + currentThetaIndex + 1;
-
-        return sectionNum;
+        return collarOffsets[currentCollarIndex] + currentThetaIndex + 1;
     }
 
     /* Returns phi-angles (polar) and theta-angles (azimuthal) that correspond to the sectionnumber
@@ -175,14 +192,9 @@ namespace msmrd{
         if (secNumber > numSections) {
             throw std::invalid_argument("Error: section number is larger than number of partitions");
         }
-        // Get collar
-        int collar = 0;
-        int sections = 1;
-        while (sections < secNumber) {
-            collar += 1;
-            sections = std::accumulate(std::begin(regionsPerCollar),
-                                       std::next(std::begin(regionsPerCollar), collar+1), 0);
-        }
+        // Get collar (the first one such that the sections up to it include secNumber)
+        auto collarEnd = std::lower_bound(std::next(collarOffsets.begin()), collarOffsets.end(), secNumber);
+        int collar = static_cast<int>(collarEnd - collarOffsets.begin()) - 1;
         // Find phis
         double phi1 = phis[collar];
         double phi2;
@@ -194,15 +206,13 @@ namespace msmrd{
         // Find thetas
         double theta1;
         double theta2;
-        std::vector<double> thetasCollar;
         int statesInCollar;
-        int prevStates = std::accumulate(std::begin(regionsPerCollar),
-                                         std::next(std::begin(regionsPerCollar), collar), 0);
+        int prevStates = collarOffsets[collar];
         if ((prevStates == 0) or (prevStates == numSections - 1)) {
             theta1 = 0;
             theta2 = 2 * M_PI / scaling;
         } else {
-            thetasCollar = thetas[collar - 1];
+            const auto &thetasCollar = thetas[collar - 1];
             statesInCollar = secNumber - prevStates;
             theta1 = thetasCollar[statesInCollar - 1];
             if (statesInCollar == thetasCollar.size()) {
@@ -216,6 +226,142 @@ namespace msmrd{
         return std::make_tuple(phiInterval, thetaInterval);
     }
 
+    /* Enables the cube map lookup table in getSectionNumber with resolution x resolution cells on each face of the
+     * cube, or disables it if resolution is zero. Memory used is 6 * resolution^2 integers. */
+    void spherePartition::setLookupTable(int resolution) {
+        if (resolution < 0) {
+            throw std::invalid_argument("Resolution of lookup table must be non-negative");
+        }
+        lookupResolution = resolution;
+        if (lookupResolution > 0) {
+            buildLookupTable();
+        } else {
+            lookupTable.clear();
+        }
+    }
+
+    // Returns fraction of the cells of the lookup table that contain only one section (zero if disabled).
+    double spherePartition::getLookupTableCoverage() const {
+        if (lookupTable.empty()) {
+            return 0.0;
+        }
+        auto resolvedCells = std::count_if(lookupTable.begin(), lookupTable.end(),
+                                           [](int sectionNum) { return sectionNum > 0; });
+        return static_cast<double>(resolvedCells) / lookupTable.size();
+    }
+
+    /* Fills the cube map lookup table. Face f of the cube is normal to the axis f/2, at +1 (f even) or -1 (f odd),
+     * and its cells are indexed by the other two coordinates (in cyclic order) on a regular grid over [-1,1]. */
+    void spherePartition::buildLookupTable() {
+        lookupTable.resize(6 * lookupResolution * lookupResolution);
+        double cellSize = 2.0 / lookupResolution;
+        for (int face = 0; face < 6; face++) {
+            for (int i = 0; i < lookupResolution; i++) {
+                for (int j = 0; j < lookupResolution; j++) {
+                    double a0 = -1.0 + i * cellSize;
+                    double b0 = -1.0 + j * cellSize;
+                    lookupTable[(face * lookupResolution + i) * lookupResolution + j] =
+                            getCellSectionNumber(face, a0, a0 + cellSize, b0, b0 + cellSize);
+                }
+            }
+        }
+    }
+
+    /* Returns section number that contains all the directions through the cell [a0,a1]x[b0,b1] in a face of the
+     * cube map, or zero if the cell is cut by a section boundary. It bounds the polar and azimuthal angles of the
+     * cell exactly and widens them by a small margin, so it never disagrees with the direct calculation. */
+    int spherePartition::getCellSectionNumber(int face, double a0, double a1, double b0, double b1) const {
+        const double margin = 1e-9;
+        int axis = face / 2;
+        double sign = (face % 2 == 0) ? 1.0 : -1.0;
+        // Smallest and largest absolute values in an interval
+        auto minAbs = [](double x0, double x1) {
+            return (x0 <= 0 and x1 >= 0) ? 0.0 : std::min(std::abs(x0), std::abs(x1)); };
+        auto maxAbs = [](double x0, double x1) { return std::max(std::abs(x0), std::abs(x1)); };
+        /* Bound cos(phi) = z/r in the cell. In the faces normal to z, it only depends on the distance to the center
+         * of the face. Otherwise z is one of the cell coordinates (w), so cos(phi) = w/sqrt(1 + o^2 + w^2) increases
+         * with w and its extremes are in the edges with the smallest or largest |o| (the other coordinate). */
+        double cosMin, cosMax;
+        if (axis == 2) {
+            double minNorm = std::sqrt(1.0 + std::pow(minAbs(a0, a1), 2) + std::pow(minAbs(b0, b1), 2));
+            double maxNorm = std::sqrt(1.0 + std::pow(maxAbs(a0, a1), 2) + std::pow(maxAbs(b0, b1), 2));
+            cosMin = (sign > 0) ? 1.0 / maxNorm : -1.0 / minNorm;
+            cosMax = (sign > 0) ? 1.0 / minNorm : -1.0 / maxNorm;
+        } else {
+            double w0 = (axis == 0) ? b0 : a0;
+            double w1 = (axis == 0) ? b1 : a1;
+            double oMin = (axis == 0) ? minAbs(a0, a1) : minAbs(b0, b1);
+            double oMax = (axis == 0) ? maxAbs(a0, a1) : maxAbs(b0, b1);
+            double oAtMax = (w1 > 0) ? oMin : oMax;
+            double oAtMin = (w0 > 0) ? oMax : oMin;
+            cosMax = w1 / std::sqrt(1.0 + oAtMax * oAtMax + w1 * w1);
+            cosMin = w0 / std::sqrt(1.0 + oAtMin * oAtMin + w0 * w0);
+        }
+        double phiMin = std::acos(std::min(cosMax, 1.0));
+        double phiMax = std::acos(std::max(cosMin, -1.0));
+        int collar = getCollarIndex(phiMin - margin);
+        if (collar != getCollarIndex(phiMax + margin)) {
+            return 0;
+        }
+        if (collar == 0) {
+            return 1;
+        }
+        if (collar == regionsPerCollar.size() - 1) {
+            return numSections;
+        }
+        // All azimuthal angles meet in the center of the faces normal to z
+        if (axis == 2 and a0 <= 0 and a1 >= 0 and b0 <= 0 and b1 >= 0) {
+            return 0;
+        }
+        /* Otherwise the extremes of theta are in the corners of the cell. If they differ by more than pi, the cell
+         * crosses the cut where theta goes back to zero. */
+        double thetaMin = 2 * M_PI;
+        double thetaMax = 0.0;
+        for (double a : {a0, a1}) {
+            for (double b : {b0, b1}) {
+                vec3<double> corner;
+                corner[axis] = sign;
+                corner[(axis + 1) % 3] = a;
+                corner[(axis + 2) % 3] = b;
+                double theta = std::atan2(corner[1], corner[0]) - thetasOffset;
+                if (theta < 0) {
+                    theta += 2 * M_PI;
+                }
+                thetaMin = std::min(thetaMin, theta);
+                thetaMax = std::max(thetaMax, theta);
+            }
+        }
+        if (thetaMax - thetaMin > M_PI) {
+            return 0;
+        }
+        int thetaIndex = getThetaIndex(collar, thetaMin - margin);
+        if (thetaIndex < 0 or thetaIndex != getThetaIndex(collar, thetaMax + margin)) {
+            return 0;
+        }
+        return collarOffsets[collar] + thetaIndex + 1;
+    }
+
+    /* Returns section number of the direction of coordinate from the cube map lookup table, or zero if its cell is
+     * cut by a section boundary (or the coordinate is zero or not finite). */
+    int spherePartition::lookupSectionNumber(const vec3<double> &coordinate) const {
+        int axis = 0;
+        for (int k = 1; k < 3; k++) {
+            if (std::abs(coordinate[k]) > std::abs(coordinate[axis])) {
+                axis = k;
+            }
+        }
+        double maxComponent = std::abs(coordinate[axis]);
+        double a = coordinate[(axis + 1) % 3] / maxComponent;
+        double b = coordinate[(axis + 2) % 3] / maxComponent;
+        if (not (std::abs(a) <= 1.0 and std::abs(b) <= 1.0)) {
+            return 0;
+        }
+        int face = 2 * axis + ((coordinate[axis] < 0) ? 1 : 0);
+        int i = std::min(static_cast<int>(0.5 * (a + 1.0) * lookupResolution), lookupResolution - 1);
+        int j = std::min(static_cast<int>(0.5 * (b + 1.0) * lookupResolution), lookupResolution - 1);
+        return lookupTable[(face * lookupResolution + i) * lookupResolution + j];
+    }
+
     /*  Returns list of three vectors that define the partition and calculate with partionSphere functions.
      * The first vector indicates number of sections in each collar (int). The second one indicates location
      * of cuts that define collars in the polar angle std::vector<double>. The third one denotes the location
@@ -0,0 +1,107 @@
+//
+// Created by maojrs on 4/2/20.
+//
+
+#include <exception>
+#include <thread>
+#include "ensembleRunner.hpp"
+
+namespace msmrd {
+    /**
+     * Implementation of work stealing thread pool (the ensembleRunner class is a template, so it is implemented
+     * in the header file)
+     * @param numThreads number of threads used to run the tasks
+     */
+    workStealingPool::workStealingPool(int numThreads) : numThreads(numThreads) {
+        if (numThreads < 1) {
+            throw std::invalid_argument("Number of threads must be at least one");
+        }
+        for (int thread = 0; thread < numThreads; thread++) {
+            queueMutex.push_back(std::make_unique<std::mutex>());
+        }
+    }
+
+    /* Runs function(task) for task = 0, ..., numTasks-1 in the pool threads and waits until all of them are done.
+     * If any task throws, the remaining tasks are skipped and the first exception is rethrown. */
+    void workStealingPool::run(int numTasks, const std::function<void(int task)> &function) {
+        // Distribute tasks in contiguous blocks
+        queues.assign(numThreads, std::vector<int>());
+        queueFront.assign(numThreads, 0);
+        for (int task = 0; task < numTasks; task++) {
+            queues[static_cast<long>(task) * numThreads / numTasks].push_back(task);
+        }
+        numSteals = 0;
+
+        std::exception_ptr firstException = nullptr;
+        std::mutex exceptionMutex;
+        auto worker = [&](int thread) {
+            int task;
+            while (popTask(thread, task) or stealTask(thread, task)) {
+                try {
+                    function(task);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(exceptionMutex);
+                    if (not firstException) {
+                        firstException = std::current_exception();
+                    }
+                    // Discard pending tasks of all the queues
+                    for (int other = 0; other < numThreads; other++) {
+                        std::lock_guard<std::mutex> queueLock(*queueMutex[other]);
+                        queueFront[other] = queues[other].size();
+                    }
+                }
+            }
+        };
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < numThreads; thread++) {
+            threads.emplace_back(worker, thread);
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        if (firstException) {
+            std::rethrow_exception(firstException);
+        }
+    }
+
+    // Takes next task from the front of the own queue
+    bool workStealingPool::popTask(int thread, int &task) {
+        std::lock_guard<std::mutex> lock(*queueMutex[thread]);
+        if (queueFront[thread] == queues[thread].size()) {
+            return false;
+        }
+        task = queues[thread][queueFront[thread]++];
+        return true;
+    }
+
+    // Takes a task from the back of the queue with most pending tasks
+    bool workStealingPool::stealTask(int thread, int &task) {
+        while (true) {
+            int victim = -1;
+            size_t maxPending = 0;
+            for (int other = 0; other < numThreads; other++) {
+                if (other == thread) {
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(*queueMutex[other]);
+                size_t pending = queues[other].size() - queueFront[other];
+                if (pending > maxPending) {
+                    maxPending = pending;
+                    victim = other;
+                }
+            }
+            if (victim < 0) {
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(*queueMutex[victim]);
+            // The victim queue may have been emptied since it was checked, then search again
+            if (queues[victim].size() > queueFront[victim]) {
+                task = queues[victim].back();
+                queues[victim].pop_back();
+                numSteals++;
+                return true;
+            }
+        }
+    }
+
+}
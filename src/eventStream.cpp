@@ -0,0 +1,164 @@
+//
+// Created by maojrs on 4/28/20.
+//
+
+#include <stdexcept>
+#include "eventStream.hpp"
+
+namespace msmrd {
+    /**
+     * Implementation of the binary event stream class
+     * @param filename name of the binary file, overwritten if it exists
+     * @param bufferSize number of records in the ring buffer
+     * @param flushIntervalMs maximum time in milliseconds that a record waits in the buffer before it is written
+     */
+    eventStream::eventStream(const std::string &filename, int bufferSize, int flushIntervalMs)
+            : flushInterval(flushIntervalMs) {
+        if (bufferSize < 2) {
+            throw std::invalid_argument("Buffer of the event stream must hold at least two records");
+        }
+        if (flushIntervalMs <= 0) {
+            throw std::invalid_argument("Flush interval of the event stream must be positive");
+        }
+        outputFile.open(filename, std::ios::binary | std::ios::trunc);
+        if (not outputFile.is_open()) {
+            throw std::runtime_error("Could not open event stream file " + filename);
+        }
+        buffer.resize(bufferSize);
+        writeBuffer.reserve(bufferSize);
+        writer = std::thread(&eventStream::writeRecords, this);
+    }
+
+    eventStream::~eventStream() {
+        stop();
+    }
+
+    /* Copies a record into the ring buffer. If the buffer is full, it waits until the writer thread takes
+     * records out of it. */
+    void eventStream::record(const eventRecord &event) {
+        std::unique_lock<std::mutex> lock(bufferMutex);
+        if (stopWriter) {
+            throw std::runtime_error("Event stream is closed");
+        }
+        auto bufferSize = static_cast<long>(buffer.size());
+        recorderCondition.wait(lock, [this, bufferSize] {
+            return stopWriter or numRecorded - numTaken < bufferSize; });
+        if (stopWriter) {
+            throw std::runtime_error("Event stream was closed while recording");
+        }
+        buffer[numRecorded % bufferSize] = event;
+        numRecorded++;
+        if (2 * (numRecorded - numTaken) >= bufferSize) {
+            writerCondition.notify_one();
+        }
+    }
+
+    // Records an applied event of the event manager, which happened at the given time in the given replica
+    void eventStream::record(double time, const pairEvent &event, std::int32_t replicaID) {
+        record(eventRecord{time, event.part1Index, event.part2Index, event.originState, event.endState,
+                           static_cast<std::int32_t>(event.type), replicaID});
+    }
+
+    // Waits until all the records recorded so far are written and the file is flushed.
+    void eventStream::flush() {
+        std::unique_lock<std::mutex> lock(bufferMutex);
+        if (stopWriter) {
+            return;
+        }
+        auto target = numRecorded;
+        flushRequested = true;
+        writerCondition.notify_one();
+        recorderCondition.wait(lock, [this, target] { return numWritten >= target and not flushRequested; });
+        if (writeFailed) {
+            throw std::runtime_error("Writing into the event stream file failed");
+        }
+    }
+
+    // Writes all the records, stops the writer thread and closes the file.
+    void eventStream::close() {
+        stop();
+        if (writeFailed) {
+            throw std::runtime_error("Writing into the event stream file failed");
+        }
+    }
+
+    long eventStream::getNumRecorded() {
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        return numRecorded;
+    }
+
+    long eventStream::getNumWritten() {
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        return numWritten;
+    }
+
+    // Reads all the records of a binary event stream file
+    std::vector<eventRecord> eventStream::readEventStream(const std::string &filename) {
+        std::ifstream inputFile(filename, std::ios::binary | std::ios::ate);
+        if (not inputFile.is_open()) {
+            throw std::runtime_error("Could not open event stream file " + filename);
+        }
+        auto fileSize = static_cast<size_t>(inputFile.tellg());
+        if (fileSize % sizeof(eventRecord) != 0) {
+            throw std::runtime_error("Size of event stream file " + filename +
+                                     " is not a multiple of the record size");
+        }
+        std::vector<eventRecord> records(fileSize / sizeof(eventRecord));
+        inputFile.seekg(0);
+        inputFile.read(reinterpret_cast<char *>(records.data()), fileSize);
+        return records;
+    }
+
+    /* Loop of the writer thread. It takes the records out of the ring buffer when it is half full, when the flush
+     * interval passed, or when requested, and writes them into the file without holding the lock. */
+    void eventStream::writeRecords() {
+        std::unique_lock<std::mutex> lock(bufferMutex);
+        auto bufferSize = static_cast<long>(buffer.size());
+        while (true) {
+            writerCondition.wait_for(lock, flushInterval, [this, bufferSize] {
+                return stopWriter or flushRequested or 2 * (numRecorded - numTaken) >= bufferSize; });
+            auto numPending = numRecorded - numTaken;
+            if (numPending == 0) {
+                if (flushRequested) {
+                    outputFile.flush();
+                    writeFailed = writeFailed or outputFile.fail();
+                    flushRequested = false;
+                    recorderCondition.notify_all();
+                }
+                if (stopWriter) {
+                    break;
+                }
+                continue;
+            }
+            // Take the pending records out of the ring buffer, so recording can continue while they are written
+            writeBuffer.clear();
+            for (long n = numTaken; n < numRecorded; n++) {
+                writeBuffer.push_back(buffer[n % bufferSize]);
+            }
+            numTaken = numRecorded;
+            recorderCondition.notify_all();
+            lock.unlock();
+            outputFile.write(reinterpret_cast<const char *>(writeBuffer.data()),
+                             writeBuffer.size() * sizeof(eventRecord));
+            lock.lock();
+            writeFailed = writeFailed or outputFile.fail();
+            numWritten += numPending;
+        }
+    }
+
+    // Stops the writer thread once it wrote all the records, and closes the file (does nothing if already stopped)
+    void eventStream::stop() {
+        {
+            std::lock_guard<std::mutex> lock(bufferMutex);
+            if (stopWriter) {
+                return;
+            }
+            stopWriter = true;
+        }
+        writerCondition.notify_one();
+        writer.join();
+        outputFile.close();
+        recorderCondition.notify_all();
+    }
+
+}
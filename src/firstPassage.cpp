@@ -0,0 +1,87 @@
+//
+// Created by maojrs on 4/9/20.
+//
+
+#include <algorithm>
+#include "firstPassage.hpp"
+
+namespace msmrd {
+    /* Returns the state in which particles iIndex and jIndex are bound with each other, or -1 if they are not
+     * bound. Checks both the two-particle (boundTo/boundState) and the multiparticle (boundList/boundStates)
+     * MSM/RD bindings. */
+    static int pairBoundState(std::vector<particle> &parts, int iIndex, int jIndex) {
+        auto &part = parts[iIndex];
+        if (part.boundTo == jIndex) {
+            return part.boundState;
+        }
+        for (int k = 0; k < part.boundList.size(); k++) {
+            if (part.boundList[k] == jIndex) {
+                return part.boundStates[k];
+            }
+        }
+        return -1;
+    }
+
+    /* Condition fulfilled when particles iIndex and jIndex are bound (MSM/RD integrators) in any of the bound
+     * states. If states is empty, any bound state fulfills the condition. */
+    passageCondition passageCondition::boundStates(std::vector<int> states, int iIndex, int jIndex) {
+        return passageCondition([states, iIndex, jIndex](integrator &integ, std::vector<particle> &parts) {
+            int boundState = pairBoundState(parts, iIndex, jIndex);
+            if (boundState < 0) {
+                return false;
+            }
+            return states.empty() or std::find(states.begin(), states.end(), boundState) != states.end();
+        });
+    }
+
+    /* Condition fulfilled when particles iIndex and jIndex are not bound to each other and their relative
+     * distance (taking into account periodic boundaries) is at least distance. */
+    passageCondition passageCondition::unbound(double distance, int iIndex, int jIndex) {
+        return passageCondition([distance, iIndex, jIndex](integrator &integ, std::vector<particle> &parts) {
+            if (pairBoundState(parts, iIndex, jIndex) >= 0) {
+                return false;
+            }
+            auto relativePosition = integ.calculateRelativePosition(parts[iIndex].position, parts[jIndex].position);
+            return relativePosition.normSquared() >= distance * distance;
+        });
+    }
+
+    // Condition fulfilled once the clock of the integrator reaches maxTime
+    passageCondition passageCondition::clockLimit(double maxTime) {
+        return passageCondition([maxTime](integrator &integ, std::vector<particle> &parts) {
+            return integ.getClock() >= maxTime;
+        });
+    }
+
+    // Condition fulfilled when all the conditions are fulfilled (evaluated in order until one is not)
+    passageCondition passageCondition::allOf(std::vector<passageCondition> conditions) {
+        return passageCondition([conditions](integrator &integ, std::vector<particle> &parts) {
+            for (auto &condition : conditions) {
+                if (not condition(integ, parts)) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    }
+
+    // Condition fulfilled when any of the conditions is fulfilled (evaluated in order until one is)
+    passageCondition passageCondition::anyOf(std::vector<passageCondition> conditions) {
+        return passageCondition([conditions](integrator &integ, std::vector<particle> &parts) {
+            for (auto &condition : conditions) {
+                if (condition(integ, parts)) {
+                    return true;
+                }
+            }
+            return false;
+        });
+    }
+
+    // Condition fulfilled when the condition is not fulfilled
+    passageCondition passageCondition::negation(passageCondition condition) {
+        return passageCondition([condition](integrator &integ, std::vector<particle> &parts) {
+            return not condition(integ, parts);
+        });
+    }
+
+}
@@ -0,0 +1,145 @@
+//
+// Created by maojrs on 4/23/20.
+//
+
+#include <stdexcept>
+#include "indexedPriorityQueue.hpp"
+
+namespace msmrd {
+    /**
+     * Implementation of the indexed priority queue class
+     * @param maxIndex indexes in the queue go from zero to maxIndex - 1
+     */
+    indexedPriorityQueue::indexedPriorityQueue(int maxIndex) {
+        reset(maxIndex);
+    }
+
+    // Empties the queue and sets the range of indexes. The memory is reserved, so pushing doesn't allocate.
+    void indexedPriorityQueue::reset(int maxIndex) {
+        if (maxIndex < 0) {
+            throw std::invalid_argument("Maximum index of the priority queue must be non-negative");
+        }
+        heap.clear();
+        heap.reserve(maxIndex);
+        heapPosition.assign(maxIndex, -1);
+    }
+
+    // Increases the range of indexes to maxIndex, keeping the entries in the queue (it never shrinks the range).
+    void indexedPriorityQueue::extend(int maxIndex) {
+        if (maxIndex > static_cast<int>(heapPosition.size())) {
+            heap.reserve(maxIndex);
+            heapPosition.resize(maxIndex, -1);
+        }
+    }
+
+    // Inserts index with the given key, or changes its key if it is already in the queue.
+    void indexedPriorityQueue::push(int index, double key) {
+        if (index < 0 or index >= static_cast<int>(heapPosition.size())) {
+            throw std::out_of_range("Index out of the range of the priority queue");
+        }
+        int position = heapPosition[index];
+        if (position < 0) {
+            heap.push_back(std::make_pair(key, index));
+            heapPosition[index] = static_cast<int>(heap.size() - 1);
+            siftUp(static_cast<int>(heap.size() - 1));
+        } else {
+            heap[position].first = key;
+            siftUp(position);
+            siftDown(heapPosition[index]);
+        }
+    }
+
+    // Removes index from the queue (does nothing if it is not in the queue).
+    void indexedPriorityQueue::remove(int index) {
+        if (not contains(index)) {
+            return;
+        }
+        int position = heapPosition[index];
+        int lastPosition = static_cast<int>(heap.size() - 1);
+        swapEntries(position, lastPosition);
+        heap.pop_back();
+        heapPosition[index] = -1;
+        // The last entry was moved into position, restore the heap order
+        if (position < lastPosition) {
+            int movedIndex = heap[position].second;
+            siftUp(position);
+            siftDown(heapPosition[movedIndex]);
+        }
+    }
+
+    // Adds shift to the keys of all the entries, which doesn't change their order (O(n)).
+    void indexedPriorityQueue::shiftKeys(double shift) {
+        for (auto &entry : heap) {
+            entry.first += shift;
+        }
+    }
+
+    // Removes the index with the smallest key from the queue and returns it.
+    int indexedPriorityQueue::pop() {
+        int index = top();
+        remove(index);
+        return index;
+    }
+
+    double indexedPriorityQueue::getKey(int index) const {
+        if (not contains(index)) {
+            throw std::out_of_range("Index not in the priority queue");
+        }
+        return heap[heapPosition[index]].first;
+    }
+
+    int indexedPriorityQueue::top() const {
+        if (heap.empty()) {
+            throw std::out_of_range("Priority queue is empty");
+        }
+        return heap[0].second;
+    }
+
+    double indexedPriorityQueue::topKey() const {
+        if (heap.empty()) {
+            throw std::out_of_range("Priority queue is empty");
+        }
+        return heap[0].first;
+    }
+
+    // Moves the entry at position up the heap until its parent is smaller.
+    void indexedPriorityQueue::siftUp(int position) {
+        while (position > 0) {
+            int parent = (position - 1) / 2;
+            if (heap[position] < heap[parent]) {
+                swapEntries(position, parent);
+                position = parent;
+            } else {
+                break;
+            }
+        }
+    }
+
+    // Moves the entry at position down the heap until its children are larger.
+    void indexedPriorityQueue::siftDown(int position) {
+        int heapSize = static_cast<int>(heap.size());
+        while (true) {
+            int smallest = position;
+            int left = 2 * position + 1;
+            int right = left + 1;
+            if (left < heapSize and heap[left] < heap[smallest]) {
+                smallest = left;
+            }
+            if (right < heapSize and heap[right] < heap[smallest]) {
+                smallest = right;
+            }
+            if (smallest == position) {
+                break;
+            }
+            swapEntries(position, smallest);
+            position = smallest;
+        }
+    }
+
+    void indexedPriorityQueue::swapEntries(int position1, int position2) {
+        std::swap(heap[position1], heap[position2]);
+        heapPosition[heap[position1].second] = position1;
+        heapPosition[heap[position2].second] = position2;
+    }
+
+}
@@ -43,6 +43,7 @@ namespace msmrd {
         calculateForceTorqueFields(parts);
         // Integrate and save next positions/orientations in parts[i].next***
         for (int i = 0; i < parts.size(); i++) {
+            setRandomSubstream(i);
             integrateOne(i, parts, dt);
         }
 
@@ -56,6 +57,19 @@ namespace msmrd {
         clock += dt;
     }
 
+    /* Integrates nsteps time steps (calling the integrate function of the child class) in a single call. If
+     * stopCondition is given, it is evaluated after every step with the particle list and the clock, and the
+     * integration stops as soon as it returns true. Returns the number of steps integrated. */
+    long integrator::integrateSteps(std::vector<particle> &parts, long nsteps, const stepCondition &stopCondition) {
+        for (long step = 1; step <= nsteps; step++) {
+            integrate(parts);
+            if (stopCondition and stopCondition(parts, clock)) {
+                return step;
+            }
+        }
+        return nsteps > 0 ? nsteps : 0;
+    }
+
     // Calculates relative distance (p2-p1) of two vectors, p1, p2, taking into account possible periodic boundary
     vec3<double> integrator::calculateRelativePosition(vec3<double> p1, vec3<double> p2) {
         // Calculate relative distance. If box periodic boundary, take that into account.
@@ -72,6 +86,7 @@ namespace msmrd {
     void integrator::setBoundary(boundary *bndry) {
         boundaryActive = true;
         domainBoundary = bndry;
+        neighbors.setBoundary(bndry);
         if (pairPotentialActive) {
             pairPot->setBoundary(bndry);
         }
@@ -93,6 +108,30 @@ namespace msmrd {
         if (boundaryActive) {
             pairPot->setBoundary( domainBoundary );
         }
+        neighbors.reset();
+    }
+
+    /* Sets number of threads used to calculate the force and torque fields. Requires compiling with OpenMP,
+     * see integrator::calculatePairsForceTorquesThreaded. */
+    void integrator::setNumThreads(int nthreads) {
+        if (nthreads < 1) {
+            throw std::invalid_argument("Number of threads must be at least one");
+        }
+#ifndef _OPENMP
+        if (nthreads > 1) {
+            throw std::runtime_error("msmrd2 was compiled without OpenMP; only one thread is supported");
+        }
+#endif
+        numThreads = nthreads;
+    }
+
+    /* Activates neighbor search for pair interactions. With skin = 0 a cell list is rebuilt every time step,
+     * with skin > 0 a Verlet list of pairs within cutOff + skin is reused until a particle moves more than
+     * skin/2. It has no effect if the pair potential has no finite cut off (see pairPotential::getCutOff). */
+    void integrator::setNeighborList(double skin) {
+        neighbors.setSkin(skin);
+        neighbors.reset();
+        neighborListActive = true;
     }
 
 }
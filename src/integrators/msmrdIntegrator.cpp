@@ -18,8 +18,10 @@ namespace msmrd {
     void msmrdIntegrator<ctmsm>::integrateDiffusion(std::vector<particle> &parts, double dt) {
         /* Integrate only active particles and save next positions/orientations in parts[i].next.
          * Non-active particles will usually correspond to one of the particles of a bound pair of particles */
+        drawParticleNoise(static_cast<int>(parts.size()));
         for (int i = 0; i < parts.size(); i++) {
             if (parts[i].isActive()) {
+                selectParticleNoise(i);
                 /* Choose basic integration depending if particle MSM is
                  * active (this corresponds only to the MSM in the unbound state) */
                 if (parts[i].activeMSM) {
@@ -29,6 +31,7 @@ namespace msmrd {
                 }
             }
         }
+        noiseBuffer.clear();
     }
 
 
@@ -151,35 +154,36 @@ namespace msmrd {
         double transitionTime;
         int nextState;
         int index0 = msmrdMSM.getMaxNumberBoundStates();
-        // Loop over all pairs of particles without repetition with i < j
-        for (int i = 0; i < parts.size(); i++) {
-            for (int j = i + 1; j < parts.size(); j++) {
-                // Only compute transitions if both particles are in unbound state.
-                if (parts[i].boundTo == -1 and parts[j].boundTo == -1) {
-                    /* Computes new transition if particles drifted into transition region for
-                     * the first time, i.e. empty event and relativeDistance < radialBounds[1], or if
-                     * particles transitioned between transition states. */
-                    currentTransitionState = -1;
-                    auto previousEvent = eventMgr.getEvent(i, j);
-                    if (previousEvent.eventType == "empty") {
-                        // returns -1 if |relativePosition| > radialBounds[1]
-                        currentTransitionState = computeCurrentTransitionState(parts[i], parts[j]);
-                    } else if (previousEvent.eventType == "inTransition") {
-                        //previous endState is current starting state
-                        currentTransitionState = 1 * previousEvent.endState;
-                        eventMgr.removeEvent(i, j);
-                    }
-                    // If valid currentTransitionState (see computeCurrentTransitionState), calculate next transition.
-                    if (currentTransitionState != -1) {
-                        auto transition = msmrdMSM.calculateTransition(currentTransitionState);
-                        transitionTime = std::get<0>(transition);
-                        nextState = std::get<1>(transition);
-                        if (nextState <= index0) {
-                            eventMgr.addEvent(transitionTime, i, j, currentTransitionState, nextState, "binding");
-                        } else {
-                            eventMgr.addEvent(transitionTime, i, j, currentTransitionState,
-                                              nextState, "transition2transition");
-                        }
+        /* Loop over the pairs of particles (i < j) that can be in the transition region, in the same order as
+         * the loop over all pairs. Pairs further apart than radialBounds[1] can't transition. */
+        for (auto &pair : getCandidatePairs(parts)) {
+            int i = pair[0];
+            int j = pair[1];
+            // Only compute transitions if both particles are in unbound state.
+            if (parts[i].boundTo == -1 and parts[j].boundTo == -1) {
+                /* Computes new transition if particles drifted into transition region for
+                 * the first time, i.e. empty event and relativeDistance < radialBounds[1], or if
+                 * particles transitioned between transition states. */
+                currentTransitionState = -1;
+                auto previousEvent = eventMgr.getEvent(i, j);
+                if (previousEvent.type == eventType::empty) {
+                    // returns -1 if |relativePosition| > radialBounds[1]
+                    currentTransitionState = computeCurrentTransitionState(parts[i], parts[j]);
+                } else if (previousEvent.type == eventType::inTransition) {
+                    //previous endState is current starting state
+                    currentTransitionState = 1 * previousEvent.endState;
+                    eventMgr.removeEvent(i, j);
+                }
+                // If valid currentTransitionState (see computeCurrentTransitionState), calculate next transition.
+                if (currentTransitionState != -1) {
+                    auto transition = msmrdMSM.calculateTransition(currentTransitionState);
+                    transitionTime = std::get<0>(transition);
+                    nextState = std::get<1>(transition);
+                    if (nextState <= index0) {
+                        eventMgr.addEvent(transitionTime, i, j, currentTransitionState, nextState, eventType::binding);
+                    } else {
+                        eventMgr.addEvent(transitionTime, i, j, currentTransitionState,
+                                          nextState, eventType::transition2transition);
                     }
                 }
             }
@@ -202,17 +206,17 @@ namespace msmrd {
                 /* Only compute transition if particles switched into a given bound state for
                  * the first time, i.e. empty event */
                 auto previousEvent = eventMgr.getEvent(i, parts[i].boundTo);
-                if (previousEvent.eventType == "empty") {
+                if (previousEvent.type == eventType::empty) {
                     transition = msmrdMSM.calculateTransition(parts[i].boundState);
                     transitionTime = std::get<0>(transition);
                     nextState = std::get<1>(transition);
                     // Distinguish between events bound to bound transition and unbinding events
                     if (nextState <= index0) {
                         eventMgr.addEvent(transitionTime, i, parts[i].boundTo,
-                                          parts[i].boundState, nextState, "bound2bound");
+                                          parts[i].boundState, nextState, eventType::bound2bound);
                     } else {
                         eventMgr.addEvent(transitionTime, i, parts[i].boundTo,
-                                          parts[i].boundState, nextState, "unbinding");
+                                          parts[i].boundState, nextState, eventType::unbinding);
                     }
                 }
             }
@@ -301,7 +305,7 @@ namespace msmrd {
     void msmrdIntegrator<ctmsm>::transitionBetweenTransitionStates(int iIndex, int jIndex) {
         /* Change eventType label to indicate to computeTransitionsFromTransitionStates function that
          * a new event needs to be calculated, using previousEvent.endState as the initial state */
-        eventMgr.setEventType("inTransition", iIndex, jIndex);
+        eventMgr.setEventType(eventType::inTransition, iIndex, jIndex);
     }
 
 
@@ -309,69 +313,54 @@ namespace msmrd {
      * or when zero rates yielded infinite values. */
     template<>
     void msmrdIntegrator<ctmsm>::removeUnrealizedEvents(std::vector<particle> &parts) {
-        std::list<std::map<std::string, decltype(eventMgr.emptyEvent)>::const_iterator> iteratorList;
-        vec3<double> relativePosition;
-        // Loop over all events to flag events that should be erased (loop over iterator)
-        for (auto it = eventMgr.eventDictionary.cbegin(); it != eventMgr.eventDictionary.cend(); it++) {
-            auto transitionTime = it->second.waitTime;
-            auto iIndex = it->second.part1Index;
-            auto jIndex = it->second.part2Index;
-            // Flag event to be removed if transition time is infinity
-            if (std::isinf(transitionTime)) {
-                iteratorList.push_back(it);
+        eventMgr.removeEventsIf([this, &parts](const pairEvent &thisEvent) {
+            auto iIndex = thisEvent.part1Index;
+            auto jIndex = thisEvent.part2Index;
+            // Remove event if transition time is infinity
+            if (std::isinf(thisEvent.time)) {
+                return true;
             }
-            // If particles in unbound state and relative position larger than cutOff, flag event to be removed.
+            // If particles in unbound state and relative position larger than cutOff, remove event.
             if (parts[iIndex].boundTo == -1 and parts[jIndex].boundTo == -1) {
-                relativePosition = calculateRelativePosition(parts[iIndex].nextPosition, parts[jIndex].nextPosition);
+                auto relativePosition = calculateRelativePosition(parts[iIndex].nextPosition,
+                                                                  parts[jIndex].nextPosition);
                 // Remove event if particles drifted apart
-                if (relativePosition.norm() >= radialBounds[1]) {
-                    iteratorList.push_back(it);
-                }
+                return relativePosition.norm() >= radialBounds[1];
             }
-        }
-        // Erase events flagged to be erased
-        for (auto it : iteratorList) {
-            eventMgr.eventDictionary.erase(it);
-        }
+            return false;
+        });
     }
 
 
-    /* Apply events in event manager that should happen during the current time step. */
+    /* Apply events in event manager that should happen during the current time step, in the order they happen
+     * (the event manager only returns the events with time not after the current time). */
     template<>
     void msmrdIntegrator<ctmsm>::applyEvents(std::vector<particle> &parts) {
-        std::list<std::map<std::string, decltype(eventMgr.emptyEvent)>::const_iterator> iteratorList;
-        // Loop over dictionary using iterators
-        for (auto it = eventMgr.eventDictionary.cbegin(); it != eventMgr.eventDictionary.cend(); it++) {
-            auto transitionTime = it->second.waitTime;
-            /* Only apply events that should happen in during this
-             * timestep (they correspond to transitionTime < 0) */
-            if (transitionTime <= 0) {
-                // Load event data
-                auto iIndex = it->second.part1Index;
-                auto jIndex = it->second.part2Index;
-                auto endState = it->second.endState;
-                auto eventType = it->second.eventType;
-                // Make event happen (depending on event type) and remove event once it has happened
-                if (eventType == "binding") {
-                    transition2BoundState(parts, iIndex, jIndex, endState);
-                    iteratorList.push_back(it);
-                } else if (eventType == "unbinding") {
-                    transition2UnboundState(parts, iIndex, jIndex, endState);
-                    iteratorList.push_back(it);
-                } else if (eventType == "bound2bound") {
-                    transitionBetweenBoundStates(parts, iIndex, jIndex, endState);
-                    iteratorList.push_back(it);
-                } else if (eventType == "transition2transition") {
-                    /* Note event is not removed until a new event is computed later in
-                     * the computeTransitionsFromTransitionStates routine */
-                    transitionBetweenTransitionStates(iIndex, jIndex);
-                }
+        pairEvent dueEvent;
+        while (eventMgr.popDueEvent(dueEvent)) {
+            // Load event data
+            auto iIndex = dueEvent.part1Index;
+            auto jIndex = dueEvent.part2Index;
+            auto endState = dueEvent.endState;
+            // Make event happen (depending on event type) and remove event once it has happened
+            if (dueEvent.type == eventType::binding) {
+                transition2BoundState(parts, iIndex, jIndex, endState);
+                recordAppliedEvent(dueEvent);
+                eventMgr.removeEvent(iIndex, jIndex);
+            } else if (dueEvent.type == eventType::unbinding) {
+                transition2UnboundState(parts, iIndex, jIndex, endState);
+                recordAppliedEvent(dueEvent);
+                eventMgr.removeEvent(iIndex, jIndex);
+            } else if (dueEvent.type == eventType::bound2bound) {
+                transitionBetweenBoundStates(parts, iIndex, jIndex, endState);
+                recordAppliedEvent(dueEvent);
+                eventMgr.removeEvent(iIndex, jIndex);
+            } else if (dueEvent.type == eventType::transition2transition) {
+                /* Note event is not removed until a new event is computed later in
+                 * the computeTransitionsFromTransitionStates routine */
+                transitionBetweenTransitionStates(iIndex, jIndex);
             }
         }
-        // Erase events that just were applied
-        for (auto it : iteratorList) {
-            eventMgr.eventDictionary.erase(it);
-        }
     }
 
 
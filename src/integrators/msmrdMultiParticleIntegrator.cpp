@@ -85,43 +85,45 @@ namespace msmrd {
         double transitionTime;
         int nextState;
         int index0 = msmrdMSM.getMaxNumberBoundStates();
-        // Loop over all pairs of particles without repetition with i < j
-        for (int i = 0; i < parts.size() - 1; i++) {
-            for (int j = i + 1; j < parts.size(); j++) {
-                currentTransitionState = -1;
-                /* Only compute transitions if both particles have at least one bound site free (bound to one or zero
-                 * other particles). Note some transisitions might still be rejected by applyBindingEvent function. */
-                auto bindingPossible = parts[i].boundList.size() < 2 and parts[j].boundList.size() < 2;
-                /* Computes new transition if particles drifted into transition region for
-                 * the first time, i.e. empty event and relativeDistance < radialBounds[1], or if
-                 * particles transitioned between transition states. */
-                auto previousEvent = eventMgr.getEvent(i, j);
-                if (previousEvent.eventType == "empty") {
-                    if (bindingPossible) {
-                        // returns -1 if |relativePosition| > radialBounds[1]
-                        currentTransitionState = computeCurrentTransitionState(parts[i], parts[j]);
-                    }
-                } else if (previousEvent.eventType == "inTransition") {
-                    //previous endState is current starting state
-                    currentTransitionState = previousEvent.endState;
-                    eventMgr.removeEvent(i, j);
-                }
+        /* Loop over the pairs of particles (i < j) that can be in the transition region, in the same order as
+         * the loop over all pairs. Pairs further apart than radialBounds[1] can't transition. */
+        for (auto &pair : getCandidatePairs(parts)) {
+            int i = pair[0];
+            int j = pair[1];
+            currentTransitionState = -1;
+            /* Only compute transitions if both particles have at least one bound site free (bound to one or zero
+             * other particles). Note some transisitions might still be rejected by applyBindingEvent function. */
+            auto bindingPossible = parts[i].boundList.size() < 2 and parts[j].boundList.size() < 2;
+            /* Computes new transition if particles drifted into transition region for
+             * the first time, i.e. empty event and relativeDistance < radialBounds[1], or if
+             * particles transitioned between transition states. */
+            auto previousEvent = eventMgr.getEvent(i, j);
+            if (previousEvent.type == eventType::empty) {
                 if (bindingPossible) {
-                    // If valid currentTransitionState (see computeCurrentTransitionState), calculate next transition.
-                    if (currentTransitionState != -1) {
-                        auto transition = msmrdMSM.calculateTransition(currentTransitionState);
-                        transitionTime = std::get<0>(transition);
-                        nextState = std::get<1>(transition);
-                        // Add binding transition (with rejection sampling)
-                        if (nextState <= index0) {
-                            auto acceptBinding = acceptBindingEvent(parts, i, j, nextState);
-                            if (acceptBinding) {
-                                eventMgr.addEvent(transitionTime, i, j, currentTransitionState, nextState, "binding");
-                            }
-                        } else {
+                    // returns -1 if |relativePosition| > radialBounds[1]
+                    currentTransitionState = computeCurrentTransitionState(parts[i], parts[j]);
+                }
+            } else if (previousEvent.type == eventType::inTransition) {
+                //previous endState is current starting state
+                currentTransitionState = previousEvent.endState;
+                eventMgr.removeEvent(i, j);
+            }
+            if (bindingPossible) {
+                // If valid currentTransitionState (see computeCurrentTransitionState), calculate next transition.
+                if (currentTransitionState != -1) {
+                    auto transition = msmrdMSM.calculateTransition(currentTransitionState);
+                    transitionTime = std::get<0>(transition);
+                    nextState = std::get<1>(transition);
+                    // Add binding transition (with rejection sampling)
+                    if (nextState <= index0) {
+                        auto acceptBinding = acceptBindingEvent(parts, i, j, nextState);
+                        if (acceptBinding) {
                             eventMgr.addEvent(transitionTime, i, j, currentTransitionState,
-                                              nextState, "transition2transition");
+                                              nextState, eventType::binding);
                         }
+                    } else {
+                        eventMgr.addEvent(transitionTime, i, j, currentTransitionState,
+                                          nextState, eventType::transition2transition);
                     }
                 }
             }
@@ -165,39 +167,37 @@ namespace msmrd {
     /* Apply events in event manager that should happen during the current time step. */
     template<>
     void msmrdMultiParticleIntegrator<ctmsm>::applyEvents(std::vector<particle> &parts) {
-        std::list<std::map<std::string, decltype(eventMgr.emptyEvent)>::const_iterator> iteratorList;
-        // Loop over dictionary using iterators
-        for (auto it = eventMgr.eventDictionary.cbegin(); it != eventMgr.eventDictionary.cend(); it++) {
-            auto transitionTime = it->second.waitTime;
-            /* Only apply events that should happen in during this
-             * timestep (they correspond to transitionTime < 0) */
-            if (transitionTime <= 0) {
-                // Load event data
-                auto iIndex = it->second.part1Index;
-                auto jIndex = it->second.part2Index;
-                auto endState = it->second.endState;
-                auto eventType = it->second.eventType;
-                // Make event happen (depending on event type) and remove event once it has happened
-                if (eventType == "binding") {
-                    transition2BoundState(parts, iIndex, jIndex, endState);
-                    iteratorList.push_back(it);
-                } else if (eventType == "unbinding") {
-                    transition2UnboundState(parts, iIndex, jIndex, endState);
-                    iteratorList.push_back(it);
-                } else if (eventType == "bound2bound") {
-                    transitionBetweenBoundStates(parts, iIndex, jIndex, endState);
-                    iteratorList.push_back(it);
-                } else if (eventType == "transition2transition") {
-                    /* Note event is not removed until a new event is computed later in
-                     * the computeTransitionsFromTransitionStates routine */
-                    transitionBetweenTransitionStates(iIndex, jIndex);
+        pairEvent dueEvent;
+        while (eventMgr.popDueEvent(dueEvent)) {
+            // Load event data (the transition time is not positive, it is relative to the end of the time step)
+            auto transitionTime = dueEvent.time - eventMgr.getCurrentTime();
+            auto iIndex = dueEvent.part1Index;
+            auto jIndex = dueEvent.part2Index;
+            auto endState = dueEvent.endState;
+            // Make event happen (depending on event type) and remove event once it has happened
+            if (dueEvent.type == eventType::binding) {
+                auto numRingFormations = ringFormations.size();
+                transition2BoundState(parts, iIndex, jIndex, endState);
+                // Record the exact time of the binding if it closed a loop
+                if (ringFormations.size() > numRingFormations) {
+                    ringFormations.back().time = clock + transitionTime;
                 }
+                recordAppliedEvent(dueEvent);
+                eventMgr.removeEvent(iIndex, jIndex);
+            } else if (dueEvent.type == eventType::unbinding) {
+                transition2UnboundState(parts, iIndex, jIndex, endState);
+                recordAppliedEvent(dueEvent);
+                eventMgr.removeEvent(iIndex, jIndex);
+            } else if (dueEvent.type == eventType::bound2bound) {
+                transitionBetweenBoundStates(parts, iIndex, jIndex, endState);
+                recordAppliedEvent(dueEvent);
+                eventMgr.removeEvent(iIndex, jIndex);
+            } else if (dueEvent.type == eventType::transition2transition) {
+                /* Note event is not removed until a new event is computed later in
+                 * the computeTransitionsFromTransitionStates routine */
+                transitionBetweenTransitionStates(iIndex, jIndex);
             }
         }
-        // Erase events that just were applied
-        for (auto it : iteratorList) {
-            eventMgr.eventDictionary.erase(it);
-        }
     }
 
 
@@ -289,17 +289,17 @@ namespace msmrd {
 //                    /* Only compute transition if particles switched into a given bound state for
 //                     * the first time, i.e. empty event */
 //                    auto previousEvent = eventMgr.getEvent(i, parts[i].boundList[boundParticleIndex]);
-//                    if (previousEvent.eventType == "empty") {
+//                    if (previousEvent.type == eventType::empty) {
 //                        transition = msmrdMSM.calculateTransition(parts[i].boundStates[boundParticleIndex]);
 //                        transitionTime = std::get<0>(transition);
 //                        nextState = std::get<1>(transition);
 //                        // Distinguish between events bound to bound transition and unbinding events
 //                        if (nextState <= index0) {
 //                            eventMgr.addEvent(transitionTime, i, parts[i].boundList[boundParticleIndex],
-//                                              parts[i].boundStates[boundParticleIndex], nextState, "bound2bound");
+//                                              parts[i].boundStates[boundParticleIndex], nextState, eventType::bound2bound);
 //                        } else {
 //                            eventMgr.addEvent(transitionTime, i, parts[i].boundList[boundParticleIndex],
-//                                              parts[i].boundStates[boundParticleIndex], nextState, "unbinding");
+//                                              parts[i].boundStates[boundParticleIndex], nextState, eventType::unbinding);
 //                        }
 //                    }
 //                }
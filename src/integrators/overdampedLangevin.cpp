@@ -2,6 +2,8 @@
 // Created by maojrs on 8/16/18.
 //
 
+#include <algorithm>
+#include <stdexcept>
 #include "integrators/overdampedLangevin.hpp"
 #include "tools.hpp"
 
@@ -16,6 +18,197 @@ namespace msmrd {
             : integrator(dt, seed, particlesbodytype) {};
 
 
+    // Same as integrator::integrate, but drawing the noise for all the particles in one call
+    void overdampedLangevin::integrate(std::vector<particle> &parts) {
+        if (adaptiveTimeStepping) {
+            integrateAdaptive(parts);
+            return;
+        }
+        // Calculate forces and torques and save them into forceField and torqueField
+        calculateForceTorqueFields(parts);
+        // Integrate and save next positions/orientations in parts[i].next***
+        drawNoise(static_cast<int>(parts.size()));
+        for (int i = 0; i < parts.size(); i++) {
+            integrateOne(i, parts, dt);
+        }
+        noiseBuffer.clear();
+
+        // Enforce boundary; sets new positions into parts[i].nextPosition (only if particle is active)
+        enforceBoundary(parts);
+
+        // Update position/orientation based on parts[i].nextPosition, parts[i].nextOrientation
+        updatePositionOrientation(parts);
+
+        // Updates time
+        clock += dt;
+    }
+
+
+    /* Integrates one time step dt with internal steps of variable length (rejection with Brownian bridge
+     * refinement). Every internal step of length h with Brownian increments W is compared with two steps of
+     * length h/2, whose increments W1 and W2 = W - W1 are sampled from the Brownian bridge conditioned on W.
+     * Since the noise is additive, the difference between both is the drift difference, so the local error is
+     * estimated by h/2 D/KbTemp |F(x_half) - F(x)| (and the same for the rotation). If the error is below the
+     * tolerance, the two half steps are accepted; otherwise, both halves are pushed into the stack of pending
+     * subintervals and retried, so the Brownian path is refined but never resampled, which keeps the noise
+     * unbiased. The trial step grows again (up to dt) after accepted steps. */
+    void overdampedLangevin::integrateAdaptive(std::vector<particle> &parts) {
+        int numParticles = static_cast<int>(parts.size());
+        int noisePerParticle = rotation ? 6 : 3;
+        // The counter-based generator draws all the noise of the time step from one stream
+        setRandomSubstream(0);
+        if (trialTimestep <= 0 or trialTimestep > dt) {
+            trialTimestep = dt;
+        }
+        std::vector<double> bridgeNoise(noisePerParticle * numParticles);
+        std::vector<double> increments1(noisePerParticle * numParticles);
+        brownianIncrements.clear();
+        double elapsed = 0.0;
+        bool startStateSaved = false;
+        while (dt - elapsed > 1e-10 * dt) {
+            // Draw Brownian increments of a new internal step if there are no pending subintervals
+            if (brownianIncrements.empty()) {
+                double h = std::min(trialTimestep, dt - elapsed);
+                // Avoid a last tiny step due to round off
+                if (dt - elapsed - h <= 1e-10 * dt) {
+                    h = dt - elapsed;
+                }
+                std::vector<double> increments(noisePerParticle * numParticles);
+                randg.fillNormal(increments, 0, std::sqrt(h));
+                brownianIncrements.emplace_back(h, std::move(increments));
+            }
+            double h = brownianIncrements.back().first;
+            auto &increments = brownianIncrements.back().second;
+
+            // Forces and state at the beginning of the internal step (reused if the step is rejected)
+            if (not startStateSaved) {
+                calculateForceTorqueFields(parts);
+                startForceField = forceField;
+                startTorqueField = torqueField;
+                saveStartState(parts);
+                startStateSaved = true;
+            }
+
+            // Brownian bridge: increments of the first half step conditioned on the whole increment
+            randg.fillNormal(bridgeNoise, 0, 0.5 * std::sqrt(h));
+            for (size_t k = 0; k < increments.size(); k++) {
+                increments1[k] = 0.5 * increments[k] + bridgeNoise[k];
+            }
+
+            // First half step and local error estimate
+            integrateHalfStep(parts, 0.5 * h, startForceField, startTorqueField, increments1);
+            calculateForceTorqueFields(parts);
+            double error = 0.0;
+            for (int i = 0; i < numParticles; i++) {
+                if (not startActive[i]) {
+                    continue;
+                }
+                error = std::max(error, 0.5 * h * parts[i].D / KbTemp * (forceField[i] - startForceField[i]).norm());
+                if (rotation) {
+                    error = std::max(error, 0.5 * h * parts[i].Drot / KbTemp *
+                                            (torqueField[i] - startTorqueField[i]).norm());
+                }
+            }
+
+            // Reject: retry both halves of the subinterval with the refined Brownian path
+            if (error > errorTolerance and 0.5 * h >= minTimestep) {
+                restoreStartState(parts);
+                std::vector<double> increments2(increments.size());
+                for (size_t k = 0; k < increments.size(); k++) {
+                    increments2[k] = increments[k] - increments1[k];
+                }
+                brownianIncrements.pop_back();
+                brownianIncrements.emplace_back(0.5 * h, std::move(increments2));
+                brownianIncrements.emplace_back(0.5 * h, increments1);
+                trialTimestep = 0.5 * h;
+                numRejectedSteps++;
+                continue;
+            }
+
+            // Accept: second half step with the forces at the half step
+            for (size_t k = 0; k < increments.size(); k++) {
+                increments1[k] = increments[k] - increments1[k];
+            }
+            integrateHalfStep(parts, 0.5 * h, forceField, torqueField, increments1);
+            brownianIncrements.pop_back();
+            startStateSaved = false;
+            elapsed += h;
+            numAcceptedSteps++;
+            // Grow trial step for new internal steps (local error of the drift scales as h^2)
+            if (brownianIncrements.empty()) {
+                double growth = error > 0 ? 0.9 * std::sqrt(errorTolerance / error) : 2.0;
+                trialTimestep = std::min(dt, h * std::min(2.0, std::max(1.0, growth)));
+            }
+        }
+        clock += dt;
+    }
+
+    /* Moves all the particles with the given forces and torques over half an internal step, with the given
+     * Brownian increments (not normalized, they already have variance halfstep). */
+    void overdampedLangevin::integrateHalfStep(std::vector<particle> &parts, double halfstep,
+                                               const std::vector<vec3<double>> &forces,
+                                               const std::vector<vec3<double>> &torques,
+                                               const std::vector<double> &increments) {
+        int noisePerParticle = rotation ? 6 : 3;
+        for (int i = 0; i < parts.size(); i++) {
+            auto &part = parts[i];
+            const double *noise = &increments[noisePerParticle * i];
+            vec3<double> dW(noise[0], noise[1], noise[2]);
+            part.setNextPosition(part.position + forces[i] * halfstep * part.D / KbTemp + std::sqrt(2 * part.D) * dW);
+            if (rotation) {
+                vec3<double> dWrot(noise[3], noise[4], noise[5]);
+                vec3<double> dphi = torques[i] * halfstep * part.Drot / KbTemp + std::sqrt(2 * part.Drot) * dWrot;
+                quaternion<double> dquat = msmrdtools::axisangle2quaternion(dphi);
+                part.setNextOrientation(dquat * part.orientation);
+                if (particlesbodytype == "rod" || particlesbodytype == "rodMix") {
+                    part.setNextOrientVector(msmrdtools::rotateVec(part.orientvector, dquat));
+                }
+            }
+        }
+        enforceBoundary(parts);
+        updatePositionOrientation(parts);
+    }
+
+    void overdampedLangevin::saveStartState(const std::vector<particle> &parts) {
+        int numParticles = static_cast<int>(parts.size());
+        startPositions.resize(numParticles);
+        startOrientations.resize(numParticles);
+        startOrientvectors.resize(numParticles);
+        startActive.resize(numParticles);
+        for (int i = 0; i < numParticles; i++) {
+            startPositions[i] = parts[i].position;
+            startOrientations[i] = parts[i].orientation;
+            startOrientvectors[i] = parts[i].orientvector;
+            startActive[i] = parts[i].active;
+        }
+    }
+
+    void overdampedLangevin::restoreStartState(std::vector<particle> &parts) {
+        for (int i = 0; i < parts.size(); i++) {
+            parts[i].position = startPositions[i];
+            parts[i].orientation = startOrientations[i];
+            parts[i].orientvector = startOrientvectors[i];
+            parts[i].active = startActive[i] != 0;
+        }
+    }
+
+    /* Activates adaptive time stepping. The time step dt becomes the sampling interval (the clock advances dt
+     * per call to integrate) and the upper bound of the internal steps. Child classes that implement their own
+     * integrate function (e.g. overdampedLangevinSelective) don't support it, so they override it to throw.
+     * @param tolerance maximum local error of the internal steps (length units; radians for orientations)
+     * @param minimumTimestep lower bound of the internal steps */
+    void overdampedLangevin::setAdaptiveTimeStepping(double tolerance, double minimumTimestep) {
+        if (tolerance <= 0 or minimumTimestep < 0 or minimumTimestep > dt) {
+            throw std::invalid_argument("Adaptive time stepping requires a positive tolerance and a minimum time "
+                                        "step between zero and dt");
+        }
+        adaptiveTimeStepping = true;
+        errorTolerance = tolerance;
+        minTimestep = minimumTimestep;
+        trialTimestep = dt;
+    }
+
+
     // Integrate one particle from the particle list main routine (visible only inside the class)
     void overdampedLangevin::integrateOne(int partIndex, std::vector<particle> &parts, double timestep) {
         vec3<double> force;
@@ -28,16 +221,70 @@ namespace msmrd {
         }
     }
 
+    /* Draws all the normal random numbers required in one time step by the particles (integrated once each)
+     * into noiseBuffer. The counter-based generator draws them particle by particle from their own streams. */
+    void overdampedLangevin::drawNoise(int numParticles) {
+        int noisePerParticle = rotation ? 6 : 3;
+        noiseBuffer.resize(noisePerParticle * numParticles);
+        if (randg.isCounterBased()) {
+            for (int i = 0; i < numParticles; i++) {
+                setRandomSubstream(i);
+                randg.fillNormal(&noiseBuffer[noisePerParticle * i], noisePerParticle, 0, 1);
+            }
+        } else {
+            randg.fillNormal(noiseBuffer, 0, 1);
+        }
+        noiseIndex = 0;
+        noiseEnd = noiseBuffer.size();
+    }
+
+    /* Same as drawNoise for integrators that draw other random numbers for each particle (e.g. switching times)
+     * or integrate some particles more than once; the noise of each particle is then taken with
+     * selectParticleNoise. The counter-based generator draws the noise of a particle when it is selected, so the
+     * other draws of the particle continue its substream instead of repeating the noise. */
+    void overdampedLangevin::drawParticleNoise(int numParticles) {
+        if (randg.isCounterBased()) {
+            int noisePerParticle = rotation ? 6 : 3;
+            noiseBuffer.resize(noisePerParticle * numParticles);
+            noiseIndex = 0;
+            noiseEnd = 0;
+        } else {
+            drawNoise(numParticles);
+        }
+    }
+
+    /* Selects the random substream of a particle and limits getNoise to the noise drawn for it by
+     * drawParticleNoise. Once it is used, getNoise draws from randg directly. */
+    void overdampedLangevin::selectParticleNoise(int partIndex) {
+        int noisePerParticle = rotation ? 6 : 3;
+        setRandomSubstream(partIndex);
+        noiseIndex = noisePerParticle * partIndex;
+        noiseEnd = noiseIndex + noisePerParticle;
+        if (randg.isCounterBased()) {
+            randg.fillNormal(&noiseBuffer[noiseIndex], noisePerParticle, 0, 1);
+        }
+    }
+
+    // Returns next three normal random numbers from noiseBuffer (up to noiseEnd) or directly from randg if exhausted
+    vec3<double> overdampedLangevin::getNoise() {
+        if (noiseIndex + 3 <= std::min(noiseEnd, noiseBuffer.size())) {
+            vec3<double> noise(noiseBuffer[noiseIndex], noiseBuffer[noiseIndex + 1], noiseBuffer[noiseIndex + 2]);
+            noiseIndex += 3;
+            return noise;
+        }
+        return randg.normal3D(0, 1);
+    }
+
     void overdampedLangevin::translate(particle &part, vec3<double> force, double dt0) {
         vec3<double> dr;
-        dr = force * dt0 * part.D / KbTemp + std::sqrt(2 * dt0 * part.D) * randg.normal3D(0, 1);
+        dr = force * dt0 * part.D / KbTemp + std::sqrt(2 * dt0 * part.D) * getNoise();
         part.setNextPosition(part.position + dr);
     }
 
     void overdampedLangevin::rotate(particle &part, vec3<double> torque, double dt0) {
         vec3<double> dphi;
         quaternion<double> dquat;
-        dphi = torque * dt0 * part.Drot / KbTemp + std::sqrt(2 * dt0 * part.Drot) * randg.normal3D(0, 1);
+        dphi = torque * dt0 * part.Drot / KbTemp + std::sqrt(2 * dt0 * part.Drot) * getNoise();
         dquat = msmrdtools::axisangle2quaternion(dphi);
         part.setNextOrientation(dquat * part.orientation);
         // Updated orientation vector, useful with rodlike particles
@@ -0,0 +1,82 @@
+//
+// Created by maojrs on 3/30/20.
+//
+
+#include <stdexcept>
+#include "integrators/overdampedLangevinMTS.hpp"
+#include "tools.hpp"
+
+namespace msmrd {
+    /**
+     * Implementation of multiple time step over-damped Langevin integrator
+     * @param dt time step (outer step, used for the slow forces and the noise)
+     * @param seed random generator seed (Note seed = -1 corresponds to random device)
+     * @param particlesbodytype body type of particles (see integrator)
+     * @param numSubsteps number of substeps of length dt/numSubsteps used to integrate the fast forces
+     */
+    overdampedLangevinMTS::overdampedLangevinMTS(double dt, long seed, std::string particlesbodytype,
+                                                 int numSubsteps) : overdampedLangevin(dt, seed, particlesbodytype) {
+        setNumSubsteps(numSubsteps);
+    };
+
+
+    void overdampedLangevinMTS::integrate(std::vector<particle> &parts) {
+        // Slow forces and noise over the whole time step (same as overdampedLangevin::integrate)
+        calculateForceTorqueFields(parts, &pairPotential::forceTorqueSlow);
+        drawNoise(static_cast<int>(parts.size()));
+        for (int i = 0; i < parts.size(); i++) {
+            integrateOne(i, parts, dt);
+        }
+        noiseBuffer.clear();
+        enforceBoundary(parts);
+        updatePositionOrientation(parts);
+
+        // Fast forces integrated in substeps
+        if (pairPotentialActive) {
+            double substep = dt / numSubsteps;
+            for (int k = 0; k < numSubsteps; k++) {
+                integrateFastSubstep(parts, substep);
+            }
+        }
+
+        // Updates time
+        clock += dt;
+    }
+
+    // The substeps have a fixed length, adaptive time stepping is not supported
+    void overdampedLangevinMTS::setAdaptiveTimeStepping(double, double) {
+        throw std::invalid_argument("Adaptive time stepping is not supported by the multiple time step integrator");
+    }
+
+    void overdampedLangevinMTS::setNumSubsteps(int newNumSubsteps) {
+        if (newNumSubsteps < 1) {
+            throw std::invalid_argument("Number of substeps must be at least one");
+        }
+        numSubsteps = newNumSubsteps;
+    }
+
+
+    /* Deterministic substep with the fast pair forces and torques only (no external forces nor noise, already
+     * included in the outer step). The force fields are overwritten by the fast forces. */
+    void overdampedLangevinMTS::integrateFastSubstep(std::vector<particle> &parts, double substep) {
+        int numParticles = static_cast<int>(parts.size());
+        forceField.assign(numParticles, vec3<double>(0, 0, 0));
+        torqueField.assign(numParticles, vec3<double>(0, 0, 0));
+        calculatePairsForceTorques(parts, numParticles, &pairPotential::forceTorqueFast);
+        for (int i = 0; i < numParticles; i++) {
+            auto &part = parts[i];
+            part.setNextPosition(part.position + forceField[i] * substep * part.D / KbTemp);
+            if (rotation) {
+                vec3<double> dphi = torqueField[i] * substep * part.Drot / KbTemp;
+                quaternion<double> dquat = msmrdtools::axisangle2quaternion(dphi);
+                part.setNextOrientation(dquat * part.orientation);
+                if (particlesbodytype == "rod" || particlesbodytype == "rodMix") {
+                    part.setNextOrientVector(msmrdtools::rotateVec(part.orientvector, dquat));
+                }
+            }
+        }
+        enforceBoundary(parts);
+        updatePositionOrientation(parts);
+    }
+
+}
@@ -2,6 +2,7 @@
 // Created by maojrs on 8/16/18.
 //
 
+#include <algorithm>
 #include "integrators/overdampedLangevinMarkovSwitch.hpp"
 
 namespace msmrd {
@@ -16,11 +17,12 @@ namespace msmrd {
 
 
     /* Integrates rotation/translation and Markovian switch of one particle, with pair interactions
-     * (visible only inside the class) */
+     * (visible only inside the class). The MSM of the particle type is shared by all the particles (not copied),
+     * and the switching times are drawn from the random stream of the particle in the integrator. */
     template<>
     void overdampedLangevinMarkovSwitch<ctmsm>::integrateOneMS(int partIndex, std::vector<particle> &parts, double timestep) {
         auto &part = parts[partIndex];
-        auto tmsm = MSMlist[part.type];
+        const auto &tmsm = MSMlist[part.type];
         // Do diffusion/rotation propagation taking MSM/CTMSM into account
         double resdt;
         // propagate CTMSM when synchronized and update diffusion coefficients
@@ -31,7 +33,7 @@ namespace msmrd {
             while (part.timeCounter < timestep) {
                 // Propagates MSM only when diffusion and rotation are in sync
                 if (part.propagateTMSM) {
-                    tmsm.propagateNoUpdate(part, 1); // Diffusion coefficients don't need to be updated until dt reaches lagtime.
+                    tmsm.propagateNoUpdate(part, 1, randg); // Diffusion coefficients don't need to be updated until dt reaches lagtime.
                 }
                 // Integrates for one lagtime as long as integration is still under dt
                 if (part.timeCounter + part.lagtime < timestep) {
@@ -77,6 +79,113 @@ namespace msmrd {
     };
 
 
+    /* Draws the next switch of particle partIndex from its MSM (the state it switches to and when) and saves the
+     * switching time into the switching queue. Used by event driven switching. */
+    template<>
+    void overdampedLangevinMarkovSwitch<ctmsm>::scheduleSwitch(int partIndex, std::vector<particle> &parts) {
+        auto &part = parts[partIndex];
+        MSMlist[part.type].propagateNoUpdate(part, 1, randg);
+        part.propagateTMSM = false;
+        switchingQueue.push(partIndex, clock + part.lagtime);
+    }
+
+    /* Keeps the switching queue consistent with the particle list: it is built again for a different particle
+     * list, and particles whose MSM was activated or deactivated are added or removed. A particle that has not
+     * switched yet keeps its remaining lagtime. */
+    template<>
+    void overdampedLangevinMarkovSwitch<ctmsm>::updateSwitchingQueue(std::vector<particle> &parts) {
+        if (switchingParticles != parts.data() or numSwitchingParticles != parts.size()) {
+            switchingQueue.reset(static_cast<int>(parts.size()));
+            switchingParticles = parts.data();
+            numSwitchingParticles = parts.size();
+        }
+        for (int i = 0; i < parts.size(); i++) {
+            if (parts[i].activeMSM and not switchingQueue.contains(i)) {
+                if (parts[i].propagateTMSM) {
+                    setRandomSubstream(i);
+                    scheduleSwitch(i, parts);
+                } else {
+                    switchingQueue.push(i, clock + parts[i].lagtime);
+                }
+            } else if (not parts[i].activeMSM and switchingQueue.contains(i)) {
+                switchingQueue.remove(i);
+            }
+        }
+    }
+
+    /* Writes the remaining time until the next switch from the switching queue into the lagtime of the particles
+     * and empties the queue, so the step by step integration can continue after event driven switching. */
+    template<>
+    void overdampedLangevinMarkovSwitch<ctmsm>::synchronizeLagtimes(std::vector<particle> &parts) {
+        if (switchingParticles == parts.data() and numSwitchingParticles == parts.size()) {
+            while (not switchingQueue.empty()) {
+                auto switchTime = switchingQueue.topKey();
+                auto &part = parts[switchingQueue.pop()];
+                part.setLagtime(std::max(switchTime - clock, 0.0));
+                part.propagateTMSM = part.lagtime == 0;
+            }
+        }
+        switchingQueue.reset(0);
+        switchingParticles = nullptr;
+        numSwitchingParticles = 0;
+    }
+
+    /* Integrates one time step of a particle that switches (once or several times) during the time step. The
+     * diffusion coefficients change at the switching times, so the displacement in the time step is the sum of
+     * the displacements of each interval. The sum of these Gaussian displacements has the same distribution as
+     * a single displacement with the time average of the diffusion coefficients, so the particle is integrated
+     * once with the averaged coefficients (the force and torque are constant during the time step). */
+    template<>
+    void overdampedLangevinMarkovSwitch<ctmsm>::integrateOneSwitching(int partIndex, std::vector<particle> &parts,
+                                                                      double timestep) {
+        auto &part = parts[partIndex];
+        const auto &tmsm = MSMlist[part.type];
+        double endTime = clock + timestep;
+        double time = clock;
+        double switchTime = switchingQueue.getKey(partIndex);
+        double integratedD = 0;
+        double integratedDrot = 0;
+        while (switchTime <= endTime) {
+            integratedD += (switchTime - time) * part.D;
+            integratedDrot += (switchTime - time) * part.Drot;
+            time = switchTime;
+            // Switch to the state drawn at the previous switch and draw the next one
+            part.updateState();
+            part.setDs(tmsm.Dlist[part.state], tmsm.Drotlist[part.state]);
+            tmsm.propagateNoUpdate(part, 1, randg);
+            switchTime = time + part.lagtime;
+        }
+        integratedD += (endTime - time) * part.D;
+        integratedDrot += (endTime - time) * part.Drot;
+        switchingQueue.push(partIndex, switchTime);
+        // Integrate with the time averaged diffusion coefficients and restore the ones of the current state
+        double D = part.D;
+        double Drot = part.Drot;
+        part.setDs(integratedD / timestep, integratedDrot / timestep);
+        integrateOne(partIndex, parts, timestep);
+        part.setDs(D, Drot);
+    }
+
+    /* Event driven version of integrate. The particles whose next switch is later than the end of the time step
+     * are integrated without any MSM bookkeeping; their lagtime is not updated (see getNextSwitchTime). */
+    template<>
+    void overdampedLangevinMarkovSwitch<ctmsm>::integrateEventDriven(std::vector<particle> &parts) {
+        updateSwitchingQueue(parts);
+        double endTime = clock + dt;
+        bool switchInTimeStep = not switchingQueue.empty() and switchingQueue.topKey() <= endTime;
+        drawParticleNoise(static_cast<int>(parts.size()));
+        for (int i = 0; i < parts.size(); i++) {
+            selectParticleNoise(i);
+            if (switchInTimeStep and switchingQueue.contains(i) and switchingQueue.getKey(i) <= endTime) {
+                integrateOneSwitching(i, parts, dt);
+            } else {
+                integrateOne(i, parts, dt);
+            }
+        }
+        noiseBuffer.clear();
+    }
+
+
     /*
      * Next function should remain at end of file to avoid instantiation before specialization
      */
@@ -89,12 +198,22 @@ namespace msmrd {
         calculateForceTorqueFields<particle>(parts);
 
         // Integrate and save next positions/orientations in parts[i].next***
-        for (int i = 0; i < parts.size(); i++) {
-            if (parts[i].activeMSM) {
-                integrateOneMS(i, parts, dt);
-            } else {
-                integrateOne(i, parts, dt);
+        if (eventDrivenSwitching) {
+            integrateEventDriven(parts);
+        } else {
+            if (numSwitchingParticles > 0) {
+                synchronizeLagtimes(parts);
+            }
+            drawParticleNoise(static_cast<int>(parts.size()));
+            for (int i = 0; i < parts.size(); i++) {
+                selectParticleNoise(i);
+                if (parts[i].activeMSM) {
+                    integrateOneMS(i, parts, dt);
+                } else {
+                    integrateOne(i, parts, dt);
+                }
             }
+            noiseBuffer.clear();
         }
         // Enforce boundary and set new positions into parts[i].nextPosition
         enforceBoundary(parts);
@@ -3,6 +3,7 @@
 //
 
 
+#include <stdexcept>
 #include "integrators/overdampedLangevinSelective.hpp"
 
 namespace msmrd {
@@ -13,6 +14,11 @@ namespace msmrd {
         patchyTraj->setTolerances(0.50, 0.5*2*M_PI);
     }
 
+    // Adaptive time stepping is not supported, the selective integration uses fixed time steps
+    void overdampedLangevinSelective::setAdaptiveTimeStepping(double, double) {
+        throw std::invalid_argument("Adaptive time stepping is not supported by the selective integrator");
+    }
+
     /* Integrate list of particles with selective patch selection, see setActivePatches fucntion */
     void overdampedLangevinSelective::integrate(std::vector<particle> &parts) {
         vec3<double> force;
@@ -21,12 +27,16 @@ namespace msmrd {
         // Calculate forces and torques and save them into forceField and torqueField
         calculateForceTorqueFields(parts);
 
+        /* Sets active patches to calculate force-field avoiding triple bindings. The positions don't change
+         * until the end of the time step, so it is only done once per time step. */
+        setActivePatches(parts);
+
+        drawNoise(static_cast<int>(parts.size()));
         for (int i = 0; i < parts.size(); i++) {
-            // Sets active patches to calculate force-field avoind triple bindings
-            setActivePatches(parts);
             // Integrate and save next positions/orientations in parts[i].next***
             integrateOne(i, parts, dt);
         }
+        noiseBuffer.clear();
 
         // Enforce boundary; sets new positions into parts[i].nextPosition (only if particle is active)
         enforceBoundary(parts);
@@ -39,9 +49,75 @@ namespace msmrd {
     }
 
 
+    /* Finds the pairs of particles in a bound state (1 to 4) and saves them into newBoundPatchPairs, sorted by
+     * particle indexes. Only the pairs found by the cell list, closer than the bound region radius of patchyTraj,
+     * can be in a bound state, so the discrete state is only sampled for these pairs. */
+    void overdampedLangevinSelective::findBoundPatchPairs(std::vector<particle> &parts) {
+        newBoundPatchPairs.clear();
+        if (parts.size() < 2) {
+            return;
+        }
+        if (boundaryActive) {
+            boundPairsNeighbors.setBoundary(domainBoundary);
+        }
+        if (patchyTraj->getRLowerBound() != boundPairsNeighbors.getCutOff()) {
+            boundPairsNeighbors.setCutOff(patchyTraj->getRLowerBound());
+        }
+        for (auto &pair : boundPairsNeighbors.getNeighborPairs(parts)) {
+            int state = patchyTraj->sampleDiscreteState(parts[pair[0]], parts[pair[1]]);
+            if (state >= 1 and state <= 4) {
+                newBoundPatchPairs.push_back({pair[0], pair[1], state});
+            }
+        }
+    }
+
+    /* Updates boundPatchPairs with the pairs currently in a bound state. The graph of bonded particles is only
+     * updated with the pairs that bound or unbound since the last call, found by merging the two sorted lists of
+     * pairs. A pair that changes its bound state is bound in both lists, so it doesn't change the graph. */
+    void overdampedLangevinSelective::updateBoundPairs(std::vector<particle> &parts) {
+        findBoundPatchPairs(parts);
+        bool sameParticleList = boundPairsParticles == parts.data() and numBoundPairsParticles == parts.size();
+        if (sameParticleList and newBoundPatchPairs == boundPatchPairs) {
+            return;
+        }
+        if (not sameParticleList) {
+            bondedParticles.reset(static_cast<int>(parts.size()));
+            for (auto &boundPair : newBoundPatchPairs) {
+                bondedParticles.addBond(boundPair[0], boundPair[1]);
+            }
+        } else {
+            auto oldPair = boundPatchPairs.begin();
+            auto newPair = newBoundPatchPairs.begin();
+            while (oldPair != boundPatchPairs.end() or newPair != newBoundPatchPairs.end()) {
+                if (newPair == newBoundPatchPairs.end() or (oldPair != boundPatchPairs.end() and
+                    std::make_pair((*oldPair)[0], (*oldPair)[1]) < std::make_pair((*newPair)[0], (*newPair)[1]))) {
+                    bondedParticles.removeBond((*oldPair)[0], (*oldPair)[1]);
+                    ++oldPair;
+                } else if (oldPair == boundPatchPairs.end() or
+                    std::make_pair((*newPair)[0], (*newPair)[1]) < std::make_pair((*oldPair)[0], (*oldPair)[1])) {
+                    bondedParticles.addBond((*newPair)[0], (*newPair)[1]);
+                    ++newPair;
+                } else {
+                    ++oldPair;
+                    ++newPair;
+                }
+            }
+        }
+        boundPatchPairs.swap(newBoundPatchPairs);
+        boundPairsParticles = parts.data();
+        numBoundPairsParticles = parts.size();
+        activePatchesOutdated = true;
+    }
+
     /* Check and set which patches should be active or inactive. Any patch involved in a binding
-     * will be deactivated and only allowed to interact with the bound particle. */
+     * will be deactivated and only allowed to interact with the bound particle. The patches are only
+     * reassigned if the bound pairs changed since they were last assigned. */
     void overdampedLangevinSelective::setActivePatches(std::vector<particle> &parts) {
+        updateBoundPairs(parts);
+        if (not activePatchesOutdated) {
+            return;
+        }
+        activePatchesOutdated = false;
         // Set active patches to true and clear bound lists
         for (int i = 0; i < parts.size(); i++) {
             for (int j=0; j < parts[i].activePatchList.size(); j++) {
@@ -49,31 +125,31 @@ namespace msmrd {
             }
         }
          /* Deactivate patches and set bound lists depending if particles are bound by looping
-          * over all possible pairs */
-        for (int i = 0; i < parts.size() - 1; i++) {
-            for (int j = i+1; j < parts.size(); j++) {
-                // Only allow a new bound state if there is no previous bound state between
-                auto state = patchyTraj->sampleDiscreteState(parts[i], parts[j]);
-                if (state == 1) {
-                    if (parts[i].activePatchList[0] < 0 and parts[j].activePatchList[1] < 0) {
-                        parts[i].activePatchList[0] = j;
-                        parts[j].activePatchList[1] = i;
-                    }
-                } else if (state == 2) {
-                    if (parts[i].activePatchList[0] < 0 and parts[j].activePatchList[0] < 0) {
-                        parts[i].activePatchList[0] = j;
-                        parts[j].activePatchList[0] = i;
-                    }
-                } else if (state == 3) {
-                    if (parts[i].activePatchList[1] < 0 and parts[j].activePatchList[0] < 0) {
-                        parts[i].activePatchList[1] = j;
-                        parts[j].activePatchList[0] = i;
-                    }
-                } else if (state == 4) {
-                    if (parts[i].activePatchList[1] < 0 and parts[j].activePatchList[1] < 0) {
-                        parts[i].activePatchList[1] = j;
-                        parts[j].activePatchList[1] = i;
-                    }
+          * over the pairs in a bound state (in the same order as all possible pairs) */
+        for (auto &boundPair : boundPatchPairs) {
+            int i = boundPair[0];
+            int j = boundPair[1];
+            int state = boundPair[2];
+            // Only allow a new bound state if there is no previous bound state between
+            if (state == 1) {
+                if (parts[i].activePatchList[0] < 0 and parts[j].activePatchList[1] < 0) {
+                    parts[i].activePatchList[0] = j;
+                    parts[j].activePatchList[1] = i;
+                }
+            } else if (state == 2) {
+                if (parts[i].activePatchList[0] < 0 and parts[j].activePatchList[0] < 0) {
+                    parts[i].activePatchList[0] = j;
+                    parts[j].activePatchList[0] = i;
+                }
+            } else if (state == 3) {
+                if (parts[i].activePatchList[1] < 0 and parts[j].activePatchList[0] < 0) {
+                    parts[i].activePatchList[1] = j;
+                    parts[j].activePatchList[0] = i;
+                }
+            } else if (state == 4) {
+                if (parts[i].activePatchList[1] < 0 and parts[j].activePatchList[1] < 0) {
+                    parts[i].activePatchList[1] = j;
+                    parts[j].activePatchList[1] = i;
                 }
             }
         }
@@ -81,96 +157,87 @@ namespace msmrd {
 
     /* Updates the vector of particle compounds. Whenever it is calles, it erases the vector
      * of particleCompounds and repopulates it depending on the current configuration. Note it
-     * doesn't keep track of actual realtive positions nor orientations. It is only to track bindings. */
+     * doesn't keep track of actual realtive positions nor orientations. It is only to track bindings.
+     * The compound sizes and rings are also tracked by the bond graph (see findClosedBindingLoops), this
+     * function is only needed to get the bound pairs of each compound. */
     void overdampedLangevinSelective::updateParticleCompounds(std::vector<particle> &parts) {
         auto dummyRelPosition = vec3<double>(0,0,0);
         particleCompounds.clear();
         for (int i = 0; i < parts.size(); i++) {
             parts[i].compoundIndex = -1;
         }
-        for (int i = 0; i < parts.size() - 1; i++) {
-            for (int j = i+1; j < parts.size(); j++) {
-                // Only allow a new bound state if there is no previous bound state between
-                int state = patchyTraj->sampleDiscreteState(parts[i], parts[j]);
-                if (state == 1 or state == 2 or state == 3 or state == 4) {
-                    // Create compound
-                    if (parts[i].compoundIndex == -1 and parts[j].compoundIndex == -1) {
-                        std::tuple<int, int> pairIndices = std::make_tuple(i, j);
-                        std::map<std::tuple<int, int>, int> boundPairsDictionary = {{pairIndices, state}};
-                        particleCompound pComplex = particleCompound(boundPairsDictionary);
-                        pComplex.relativePositions.insert(std::pair<int, vec3<double>>(i, dummyRelPosition));
-                        pComplex.relativePositions.insert(std::pair<int, vec3<double>>(j, dummyRelPosition));
-                        particleCompounds.push_back(pComplex);
-                        parts[i].compoundIndex = static_cast<int>(particleCompounds.size() - 1);
-                        parts[j].compoundIndex = static_cast<int>(particleCompounds.size() - 1);
-                    }
-                    // Add particle to compound
-                    else if (parts[i].compoundIndex == -1 or parts[j].compoundIndex == -1) {
-                        if (parts[i].compoundIndex != -1){
-                            auto compIndex = parts[i].compoundIndex;
-                            std::tuple<int,int> pairIndices = std::make_tuple(i,j);
-                            particleCompounds[compIndex].boundPairsDictionary.insert (
-                                    std::pair<std::tuple<int,int>, int>(pairIndices, state));
-                            particleCompounds[compIndex].relativePositions.insert(
-                                    std::pair<int, vec3<double>>(j,1 * dummyRelPosition));
-                            parts[j].compoundIndex = 1 * parts[i].compoundIndex;
-                        }
-                        else{
-                            auto compIndex = parts[j].compoundIndex;
-                            std::tuple<int,int> pairIndices = std::make_tuple(j,i);
-                            particleCompounds[compIndex].boundPairsDictionary.insert (
-                                    std::pair<std::tuple<int,int>, int>(pairIndices, state));
-                            particleCompounds[compIndex].relativePositions.insert(
-                                    std::pair<int, vec3<double>>(i,1 * dummyRelPosition));
-                            parts[i].compoundIndex = 1 * parts[j].compoundIndex;
-                        }
-                    }
-                    // Join compounds
-                    else if (parts[i].compoundIndex != parts[j].compoundIndex) {
-                        auto compIndex = parts[i].compoundIndex;
-                        auto secondCompIndex = parts[j].compoundIndex;
-                        std::tuple<int,int> pairIndices = std::make_tuple(i, j);
-                        particleCompounds[compIndex].boundPairsDictionary.insert (
-                                std::pair<std::tuple<int,int>, int>(pairIndices, state));
-                        particleCompounds[compIndex].joinCompound(particleCompounds[secondCompIndex]);
-                        particleCompounds[compIndex].relativePositions.insert(
-                                particleCompounds[secondCompIndex].relativePositions.begin(),
-                                particleCompounds[secondCompIndex].relativePositions.end());
-                        particleCompounds[secondCompIndex].deactivateCompound();
-                        for (int k=0; k < parts.size(); k++) {
-                            if(parts[k].compoundIndex == parts[j].compoundIndex){
-                                parts[k].compoundIndex = compIndex;
-                            }
-                        }
-                    }
-                    // Close compound
-                    else{
-                        std::tuple<int,int> pairIndices = std::make_tuple(i, j);
-                        particleCompounds[parts[i].compoundIndex].boundPairsDictionary.insert (
-                                std::pair<std::tuple<int,int>, int>(pairIndices, state) );
+        // Loop over the pairs in a bound state (in the same order as all possible pairs)
+        updateBoundPairs(parts);
+        for (auto &boundPair : boundPatchPairs) {
+            int i = boundPair[0];
+            int j = boundPair[1];
+            int state = boundPair[2];
+            // Create compound
+            if (parts[i].compoundIndex == -1 and parts[j].compoundIndex == -1) {
+                std::tuple<int, int> pairIndices = std::make_tuple(i, j);
+                std::map<std::tuple<int, int>, int> boundPairsDictionary = {{pairIndices, state}};
+                particleCompound pComplex = particleCompound(boundPairsDictionary);
+                pComplex.relativePositions.insert(std::pair<int, vec3<double>>(i, dummyRelPosition));
+                pComplex.relativePositions.insert(std::pair<int, vec3<double>>(j, dummyRelPosition));
+                particleCompounds.push_back(pComplex);
+                parts[i].compoundIndex = static_cast<int>(particleCompounds.size() - 1);
+                parts[j].compoundIndex = static_cast<int>(particleCompounds.size() - 1);
+            }
+            // Add particle to compound
+            else if (parts[i].compoundIndex == -1 or parts[j].compoundIndex == -1) {
+                if (parts[i].compoundIndex != -1){
+                    auto compIndex = parts[i].compoundIndex;
+                    std::tuple<int,int> pairIndices = std::make_tuple(i,j);
+                    particleCompounds[compIndex].boundPairsDictionary.insert (
+                            std::pair<std::tuple<int,int>, int>(pairIndices, state));
+                    particleCompounds[compIndex].relativePositions.insert(
+                            std::pair<int, vec3<double>>(j,1 * dummyRelPosition));
+                    parts[j].compoundIndex = 1 * parts[i].compoundIndex;
+                }
+                else{
+                    auto compIndex = parts[j].compoundIndex;
+                    std::tuple<int,int> pairIndices = std::make_tuple(j,i);
+                    particleCompounds[compIndex].boundPairsDictionary.insert (
+                            std::pair<std::tuple<int,int>, int>(pairIndices, state));
+                    particleCompounds[compIndex].relativePositions.insert(
+                            std::pair<int, vec3<double>>(i,1 * dummyRelPosition));
+                    parts[i].compoundIndex = 1 * parts[j].compoundIndex;
+                }
+            }
+            // Join compounds
+            else if (parts[i].compoundIndex != parts[j].compoundIndex) {
+                auto compIndex = parts[i].compoundIndex;
+                auto secondCompIndex = parts[j].compoundIndex;
+                std::tuple<int,int> pairIndices = std::make_tuple(i, j);
+                particleCompounds[compIndex].boundPairsDictionary.insert (
+                        std::pair<std::tuple<int,int>, int>(pairIndices, state));
+                particleCompounds[compIndex].joinCompound(particleCompounds[secondCompIndex]);
+                particleCompounds[compIndex].relativePositions.insert(
+                        particleCompounds[secondCompIndex].relativePositions.begin(),
+                        particleCompounds[secondCompIndex].relativePositions.end());
+                particleCompounds[secondCompIndex].deactivateCompound();
+                for (int k=0; k < parts.size(); k++) {
+                    if(parts[k].compoundIndex == secondCompIndex){
+                        parts[k].compoundIndex = compIndex;
                     }
                 }
             }
+            // Close compound
+            else{
+                std::tuple<int,int> pairIndices = std::make_tuple(i, j);
+                particleCompounds[parts[i].compoundIndex].boundPairsDictionary.insert (
+                        std::pair<std::tuple<int,int>, int>(pairIndices, state) );
+            }
         }
     }
 
     /* Checks if there is any closed binding loop in any of the particle compounds. If so, it returns the size of
-     * the loops found in a vector of integers, which size is the number of loops */
+     * the loops found in a vector of integers, which size is the number of loops. The rings are tracked by the
+     * bond graph, which is only updated with the bindings/unbindings since the last call, so the compounds are not
+     * rebuilt (the loops are sorted by the index of the root particle of each ring in the graph). */
     std::vector<int> overdampedLangevinSelective::findClosedBindingLoops(std::vector<particle> &parts){
-        // Updates particle compounds array to keep track of bindings.
-        updateParticleCompounds(parts);
-        // Check for ring loops in updated particle compounds vector.
-        std::vector<int> boundLoops;
-        for (auto &particleCompound : particleCompounds) {
-            if (particleCompound.active) {
-                auto compoundSize = particleCompound.getSizeOfCompound();
-                auto numBindings = particleCompound.getNumberOfbindings();
-                if (compoundSize == numBindings) {
-                    boundLoops.push_back(numBindings);
-                }
-            }
-        }
-        return boundLoops;
+        updateBoundPairs(parts);
+        return bondedParticles.getRingSizes();
     };
 
 
@@ -183,6 +250,15 @@ namespace msmrd {
         }
     };
 
+    /* Returns the number of particles in the compound of the particle partIndex, as of the last update of the bound
+     * pairs (last time step or call to findClosedBindingLoops). Unbound particles are compounds of size one. */
+    int overdampedLangevinSelective::getParticleCompoundSize(int partIndex) {
+        if (partIndex < 0 or partIndex >= bondedParticles.getNumberOfParticles()) {
+            return -1;
+        }
+        return bondedParticles.getCompoundSize(partIndex);
+    };
+
 
 
 //    /* Check if ring molecule was formed. It returns 0 if it was not formed or it returns an
@@ -34,6 +34,7 @@ namespace msmrd {
 
     // Calculates parameters often used by ctmsm::propagate from transition matrix
     void continuousTimeMarkovStateModel::calculateParameters() {
+        transitionTables.clear();
         lambda0.resize(nstates);
         ratescumsum.resize(nstates, std::vector<double>(nstates - 1));
         if (nstates == 1) {
@@ -55,12 +56,14 @@ namespace msmrd {
                     }
                 }
                 // lambda 0  is the sum of all components of ratevector
-                lambda0[row] = std::accumulate(ratevector.begin(), ratevector.end(),0);
+                lambda0[row] = std::accumulate(ratevector.begin(), ratevector.end(), 0.0);
                 // Calculates ratescumsum (rate cumulative sum for current row)
                 std::copy_n(ratevector.begin(), nstates - 1, ratescumsum[row].begin());
                 for (int col = 1; col < nstates - 1; col++) {
                     ratescumsum[row][col] += ratescumsum[row][col - 1];
                 }
+                // Alias table to sample the next state (index of ratevector) with probability rate/lambda0
+                transitionTables.push_back(aliasTable(ratevector));
             }
         }
     };
@@ -68,30 +71,20 @@ namespace msmrd {
     /* Propagates CTMSM using the Gillespie algorithm without updating the state in the particle, useful for
      * integration with diffusion and rotation integrator */
     void continuousTimeMarkovStateModel::propagateNoUpdate(particle &part, int ksteps) {
+        propagateNoUpdate(part, ksteps, randg);
+        lagtime = part.lagtime;
+    }
+
+    /* Same as above, but draws the random numbers from randgen and doesn't modify the model, so several particles
+     * (or integrators) can share the model and use their own random number streams. */
+    void continuousTimeMarkovStateModel::propagateNoUpdate(particle &part, int ksteps, randomgen &randgen) const {
         if (nstates > 1) {
             double lagt = 0;
-            double r1, r2;
-            int state = 0;
             int currentState = 1 * part.state;
             for (int m = 0; m < ksteps; m++) {
-                // Begins Gillespie algorithm, calculates which transition and when will it occur.
-                r1 = randg.uniformRange(0, 1);
-                r2 = randg.uniformRange(0, 1);
-                lagt += std::log(1.0 / r1) / lambda0[currentState];
-                for (int col = 0; col < nstates; col++) {
-                    if (r2 * lambda0[currentState] <= ratescumsum[currentState][col]) {
-                        if (col < currentState) {
-                            state = col;
-                        } else {
-                            state = col + 1;
-                        }
-                        break;
-                    }
-                }
-                part.setNextState(state);
-                currentState = 1 * state;
+                currentState = sampleTransition(currentState, lagt, randgen);
+                part.setNextState(currentState);
                 part.setLagtime(lagt);
-                lagtime = lagt;
             }
         }
         else {
@@ -101,60 +94,19 @@ namespace msmrd {
 
     // Propagates CTMSM in particles using the Gillespie algorithm, updates state  of particles immediately.
     void continuousTimeMarkovStateModel::propagate(particle &part, int ksteps) {
-        if (nstates > 1) {
-            double lagt = 0;
-            double r1, r2;
-            int state = 0;
-            for (int m = 0; m < ksteps; m++) {
-                // Begins Gillespie algorithm, calculates which transition and when will it occur.
-                r1 = randg.uniformRange(0, 1);
-                r2 = randg.uniformRange(0, 1);
-                lagt += std::log(1.0 / r1) / lambda0[part.state];
-                for (int col = 0; col < nstates; col++) {
-                    if (r2 * lambda0[part.state] <= ratescumsum[part.state][col]) {
-                        if (col < part.state) {
-                            state = col;
-                        } else {
-                            state = col + 1;
-                        }
-                        break;
-                    }
-                }
-                part.setState(state);
-                part.setNextState(state);
-                part.setLagtime(lagt);
-                lagtime = lagt;
-            }
-        }
-        else {
-            throw std::invalid_argument("Nothing to propagate since the rate matrix is a scalar (0)");
-        }
+        propagateNoUpdate(part, ksteps, randg);
+        part.setState(part.nextState);
+        lagtime = part.lagtime;
     }
 
     /* Propagates CTMSM given an initial state for ksteps timesteps. Returns tuple with total lagtime
      * and final state. Unlike propagate fucntion, this function doesn't involve any particles.*/
     std::tuple<double, int> continuousTimeMarkovStateModel::propagateMSM(int initialState, int ksteps) {
         double lagt = 0;
-        double r1, r2;
         int state = initialState;
-        int newState;
         if (nstates > 1) {
             for (int m = 0; m < ksteps; m++) {
-                // Begins Gillespie algorithm, calculates which transition and when will it occur.
-                r1 = randg.uniformRange(0, 1);
-                r2 = randg.uniformRange(0, 1);
-                lagt += std::log(1.0 / r1) / lambda0[state];
-                for (int col = 0; col < nstates; col++) {
-                    if (r2 * lambda0[state] <= ratescumsum[state][col]) {
-                        if (col < state) {
-                            newState = col;
-                        } else {
-                            newState = col + 1;
-                        }
-                        break;
-                    }
-                }
-                state = newState;
+                state = sampleTransition(state, lagt, randg);
             }
             return std::make_tuple(lagt, state);
         } else {
@@ -162,6 +114,14 @@ namespace msmrd {
         }
     }
 
+    /* One step of the Gillespie algorithm: adds the exponential waiting time in state to lagt and returns the
+     * next state, sampled from the alias table of the outgoing rates in O(1). */
+    int continuousTimeMarkovStateModel::sampleTransition(int state, double &lagt, randomgen &randgen) const {
+        lagt += randgen.exponential(lambda0[state]);
+        int col = transitionTables[state].sample(randgen);
+        return col < state ? col : col + 1;
+    }
+
 
 }
 
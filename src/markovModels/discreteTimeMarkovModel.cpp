@@ -11,6 +11,7 @@ namespace msmrd{
     discreteTimeMarkovStateModel::discreteTimeMarkovStateModel(int msmid, double lagtime, long seed) :
             markovModel(msmid, 0.0, seed) {
         tmatrix = {{1.0}};
+        buildTransitionTables();
     };
 
     discreteTimeMarkovStateModel::discreteTimeMarkovStateModel(int msmid, std::vector<std::vector<double>> tmatrix,
@@ -30,64 +31,43 @@ namespace msmrd{
                 }
             }
         }
+        buildTransitionTables();
     };
 
+    // Builds the alias table of each row of the transition matrix to sample the next state in O(1)
+    void discreteTimeMarkovStateModel::buildTransitionTables() {
+        transitionTables.clear();
+        for (const auto &row : tmatrix) {
+            transitionTables.push_back(aliasTable(row));
+        }
+    }
+
     // Propagates the discrete Markov chain for ksteps
     void discreteTimeMarkovStateModel::propagate(particle &part, int ksteps) {
-        double r1;
-        double sum;
         int currentState = 1 * part.state;
         for (int m = 0; m < ksteps; m++){
-            sum = 0;
-            r1 = randg.uniformRange(0, 1);
-            for (int i = 0; i < nstates; i++ ){
-                sum += tmatrix[currentState][i];
-                if (r1 <= sum) {
-                    part.setState(i);
-                    part.setNextState(i);
-                    currentState = i;
-                    break;
-                }
-            }
+            currentState = transitionTables[currentState].sample(randg);
+            part.setState(currentState);
+            part.setNextState(currentState);
         }
     };
 
     /* Propagates the discrete Markov chain for ksteps, without any particles involved, returns
      * total lagtime and final state */
     std::tuple<double, int> discreteTimeMarkovStateModel::propagateMSM(int initialState, int ksteps) {
-        double r1;
-        double sum;
         int state = initialState;
         for (int m = 0; m < ksteps; m++){
-            sum = 0;
-            r1 = randg.uniformRange(0, 1);
-            for (int i = 0; i < nstates; i++ ){
-                sum += tmatrix[state][i];
-                if (r1 <= sum) {
-                    state = i;
-                    break;
-                }
-            }
+            state = transitionTables[state].sample(randg);
         }
         return std::make_tuple(lagtime*ksteps, state);
     };
 
     // Propagates the discrete Markov chain for ksteps without updating
     void discreteTimeMarkovStateModel::propagateNoUpdate(particle &part, int ksteps) {
-        double r1;
-        double sum;
         int currentState = 1 * part.state;
         for (int m = 0; m < ksteps; m++){
-            sum = 0;
-            r1 = randg.uniformRange(0, 1);
-            for (int i = 0; i < nstates; i++ ){
-                sum += tmatrix[currentState][i];
-                if (sum <= r1) {
-                    part.setNextState(i);
-                    currentState = i;
-                    break;
-                }
-            }
+            currentState = transitionTables[currentState].sample(randg);
+            part.setNextState(currentState);
         }
     };
 
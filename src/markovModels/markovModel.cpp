@@ -44,5 +44,64 @@ namespace msmrd {
 
     };
 
-}
 
+    /* Builds the alias table with Vose's algorithm: the weights are scaled to average one, and every column is
+     * filled by a weight smaller than one plus the remainder of a weight larger than one (its alias). */
+    aliasTable::aliasTable(const std::vector<double> &weights) {
+        auto numWeights = static_cast<int>(weights.size());
+        if (numWeights == 0) {
+            throw std::invalid_argument("Alias table requires at least one weight");
+        }
+        double totalWeight = 0;
+        for (auto weight : weights) {
+            if (weight < 0) {
+                throw std::invalid_argument("Weights of alias table must be non-negative");
+            }
+            totalWeight += weight;
+        }
+        probability.resize(numWeights);
+        alias.resize(numWeights);
+        std::vector<double> scaledWeights(numWeights, 1.0);
+        if (totalWeight > 0) {
+            for (int i = 0; i < numWeights; i++) {
+                scaledWeights[i] = weights[i] * numWeights / totalWeight;
+            }
+        }
+        std::vector<int> small;
+        std::vector<int> large;
+        for (int i = 0; i < numWeights; i++) {
+            alias[i] = i;
+            if (scaledWeights[i] < 1.0) {
+                small.push_back(i);
+            } else {
+                large.push_back(i);
+            }
+        }
+        while (not small.empty() and not large.empty()) {
+            int smallIndex = small.back();
+            small.pop_back();
+            int largeIndex = large.back();
+            probability[smallIndex] = scaledWeights[smallIndex];
+            alias[smallIndex] = largeIndex;
+            scaledWeights[largeIndex] -= 1.0 - scaledWeights[smallIndex];
+            if (scaledWeights[largeIndex] < 1.0) {
+                large.pop_back();
+                small.push_back(largeIndex);
+            }
+        }
+        // Remaining columns are full (up to round off errors)
+        for (auto index : large) {
+            probability[index] = 1.0;
+        }
+        for (auto index : small) {
+            probability[index] = 1.0;
+        }
+    }
+
+    int aliasTable::sample(randomgen &randg) const {
+        double value = randg.uniformRange(0, probability.size());
+        auto column = std::min(static_cast<int>(value), static_cast<int>(probability.size()) - 1);
+        return value - column < probability[column] ? column : alias[column];
+    }
+
+}
@@ -11,14 +11,137 @@ namespace msmrd {
     msmrdMarkovModel::msmrdMarkovModel(int numBoundStates, int maxNumberBoundStates,
                                                        std::vector<std::vector<double>> tmatrix,
                                                        std::vector<int> activeSet, double lagtime, long seed)
-            : numBoundStates(numBoundStates), maxNumberBoundStates(maxNumberBoundStates), activeSet(activeSet),
-              msm(-1, tmatrix, lagtime, seed){
+            : numBoundStates(numBoundStates), maxNumberBoundStates(maxNumberBoundStates),
+              msm(-1, lagtime, seed){
+        // Convert dense transition matrix into CSR format, only the non-zero probabilities are kept.
+        std::vector<int> newRowOffsets(1, 0);
+        std::vector<int> newColumns;
+        std::vector<double> newValues;
+        for (const auto &row : tmatrix) {
+            if (row.size() != tmatrix.size()) {
+                throw std::invalid_argument("Transition matrix must be square");
+            }
+            for (int j = 0; j < row.size(); j++) {
+                if (row[j] != 0) {
+                    newColumns.push_back(j);
+                    newValues.push_back(row[j]);
+                }
+            }
+            newRowOffsets.push_back(static_cast<int>(newValues.size()));
+        }
+        this->lagtime = lagtime;
+        setSparseTmatrix(std::move(newRowOffsets), std::move(newColumns), std::move(newValues));
+        setActiveSet(std::move(activeSet));
+        randg.setSeed(seed);
+        Dlist.resize(numBoundStates);
+        Drotlist.resize(numBoundStates);
+    };
+
+    /* Constructor from transition matrix in CSR format, the arrays correspond to indptr, indices and data
+     * of a scipy sparse matrix (csr_matrix), e.g. the sparse transition matrix of a pyemma MSM. */
+    msmrdMarkovModel::msmrdMarkovModel(int numBoundStates, int maxNumberBoundStates, std::vector<int> rowOffsets,
+                                       std::vector<int> columns, std::vector<double> values,
+                                       std::vector<int> activeSet, double lagtime, long seed)
+            : numBoundStates(numBoundStates), maxNumberBoundStates(maxNumberBoundStates),
+              msm(-1, lagtime, seed){
+        this->lagtime = lagtime;
+        setSparseTmatrix(std::move(rowOffsets), std::move(columns), std::move(values));
+        setActiveSet(std::move(activeSet));
         randg.setSeed(seed);
         Dlist.resize(numBoundStates);
         Drotlist.resize(numBoundStates);
     };
 
 
+    /* Verifies and sets the transition matrix in CSR format, and builds the alias tables of its rows over the
+     * non-zero probabilities. The dense tmatrix of the parent class is not used. */
+    void msmrdMarkovModel::setSparseTmatrix(std::vector<int> newRowOffsets, std::vector<int> newColumns,
+                                            std::vector<double> newValues) {
+        if (newRowOffsets.size() < 2 or newRowOffsets.front() != 0 or newRowOffsets.back() != newValues.size()
+            or newColumns.size() != newValues.size()) {
+            throw std::invalid_argument("Inconsistent sizes of the sparse (CSR) transition matrix arrays");
+        }
+        int numRows = static_cast<int>(newRowOffsets.size() - 1);
+        transitionTables.clear();
+        transitionTables.reserve(numRows);
+        for (int i = 0; i < numRows; i++) {
+            int rowBegin = newRowOffsets[i];
+            int rowEnd = newRowOffsets[i + 1];
+            if (rowEnd < rowBegin) {
+                throw std::invalid_argument("Row offsets of the sparse transition matrix must be non-decreasing");
+            }
+            // Verify MSM transition matrix rows sum to 1 and components between 0 and 1
+            double rowsum = 0;
+            for (int k = rowBegin; k < rowEnd; k++) {
+                if (newColumns[k] < 0 or newColumns[k] >= numRows) {
+                    throw std::invalid_argument("Column index of the sparse transition matrix out of range");
+                }
+                if (newValues[k] < 0 or newValues[k] > 1) {
+                    throw std::invalid_argument("Elements of transition matrix must be probabilities (between 0 and 1)");
+                }
+                rowsum += newValues[k];
+            }
+            if (std::abs(rowsum - 1) > tolerance) {
+                throw std::invalid_argument("Discrete-time MSM transition matrix rows should sum to 1");
+            }
+            transitionTables.push_back(aliasTable(std::vector<double>(newValues.begin() + rowBegin,
+                                                                      newValues.begin() + rowEnd)));
+        }
+        rowOffsets = std::move(newRowOffsets);
+        columns = std::move(newColumns);
+        values = std::move(newValues);
+        nstates = static_cast<unsigned int>(numRows);
+        tmatrix.clear();
+    }
+
+    /* Sets the active set and its reverse lookup table, so the MSM index of a discrete trajectory index is
+     * found in O(1) */
+    void msmrdMarkovModel::setActiveSet(std::vector<int> newActiveSet) {
+        int maxIndex = -1;
+        for (auto index : newActiveSet) {
+            if (index < 0) {
+                throw std::invalid_argument("Indexes of the active set must be non-negative");
+            }
+            maxIndex = std::max(maxIndex, index);
+        }
+        MSMindexes.assign(maxIndex + 1, -1);
+        for (int i = 0; i < newActiveSet.size(); i++) {
+            MSMindexes[newActiveSet[i]] = i;
+        }
+        activeSet = std::move(newActiveSet);
+    }
+
+
+    // Propagates the discrete Markov chain for ksteps
+    void msmrdMarkovModel::propagate(particle &part, int ksteps) {
+        int currentState = 1 * part.state;
+        for (int m = 0; m < ksteps; m++){
+            currentState = columns[rowOffsets[currentState] + transitionTables[currentState].sample(randg)];
+            part.setState(currentState);
+            part.setNextState(currentState);
+        }
+    };
+
+    /* Propagates the discrete Markov chain for ksteps, without any particles involved, returns
+     * total lagtime and final state (in MSM indexing) */
+    std::tuple<double, int> msmrdMarkovModel::propagateMSM(int initialState, int ksteps) {
+        int state = initialState;
+        for (int m = 0; m < ksteps; m++){
+            state = columns[rowOffsets[state] + transitionTables[state].sample(randg)];
+        }
+        return std::make_tuple(lagtime*ksteps, state);
+    };
+
+    // Propagates the discrete Markov chain for ksteps without updating
+    void msmrdMarkovModel::propagateNoUpdate(particle &part, int ksteps) {
+        int currentState = 1 * part.state;
+        for (int m = 0; m < ksteps; m++){
+            currentState = columns[rowOffsets[currentState] + transitionTables[currentState].sample(randg)];
+            part.setNextState(currentState);
+        }
+    };
+
+
     /* Calculates next transition (time and next state), given an initial state using the msmrdMSM.
      * Note it returns the state in the active set indexing (see activeSet class header)*/
     std::tuple<double, int> msmrdMarkovModel::calculateTransition(int initialState) {
@@ -55,18 +178,37 @@ namespace msmrd {
         return activeSet[MSMindex];
     };
 
+    // Find index (MSMindex) of initialState (MSMRDindex) in the transition matrix, -1 if it is not in the active set
     int msmrdMarkovModel::getMSMindex(int activeSetIndex){
-        // Find index (MSMindex) of initialState (MSMRDindex) in the transition matrix
-        std::vector<int>::iterator itr = std::find(activeSet.begin(), activeSet.end(), activeSetIndex);
-        if (itr != activeSet.cend()) {
-            // Element found, return corresponding MSM index
-            return std::distance(activeSet.begin(), itr);
-        }
-        else {
-            // Element not found, return -1
+        if (activeSetIndex < 0 or activeSetIndex >= static_cast<int>(MSMindexes.size())) {
             return -1;
         }
+        return MSMindexes[activeSetIndex];
+    }
+
+    // Builds the dense transition matrix from the sparse one
+    std::vector<std::vector<double>> msmrdMarkovModel::getTmatrix() const {
+        std::vector<std::vector<double>> denseTmatrix(nstates, std::vector<double>(nstates, 0.0));
+        for (int i = 0; i < nstates; i++) {
+            for (int k = rowOffsets[i]; k < rowOffsets[i + 1]; k++) {
+                denseTmatrix[i][columns[k]] += values[k];
+            }
+        }
+        return denseTmatrix;
     }
 
+    // Transition probability between two states in MSM indexing
+    double msmrdMarkovModel::getTransitionProbability(int MSMindex1, int MSMindex2) const {
+        if (MSMindex1 < 0 or MSMindex1 >= nstates or MSMindex2 < 0 or MSMindex2 >= nstates) {
+            throw std::out_of_range("MSM index out of range of the transition matrix");
+        }
+        double probability = 0.0;
+        for (int k = rowOffsets[MSMindex1]; k < rowOffsets[MSMindex1 + 1]; k++) {
+            if (columns[k] == MSMindex2) {
+                probability += values[k];
+            }
+        }
+        return probability;
+    }
 
 }
@@ -0,0 +1,199 @@
+//
+// Created by maojrs on 3/2/20.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "neighborList.hpp"
+#include "tools.hpp"
+
+namespace msmrd {
+    /**
+     * Implementation of neighbor list class
+     * @param cutOff interaction range of the pair potential
+     * @param skin additional distance for the Verlet list (zero means plain cell list rebuilt every call)
+     */
+    neighborList::neighborList(double cutOff, double skin) : cutOff(cutOff), skin(skin) {
+        if (cutOff <= 0 or skin < 0) {
+            throw std::invalid_argument("Neighbor list cut off must be positive and skin non-negative");
+        }
+    };
+
+    /* Main function, returns the sorted list of candidate pairs for the given positions. The list is only
+     * recalculated if required, so consecutive calls within the skin reuse the same list. */
+    const std::vector<std::array<int, 2>> &neighborList::update(const std::vector<vec3<double>> &newPositions) {
+        if (isRebuildRequired(newPositions)) {
+            buildNeighborPairs(newPositions);
+        }
+        return neighborPairs;
+    }
+
+    // Incorporates integrator's boundary into the neighbor search
+    void neighborList::setBoundary(boundary *bndry) {
+        boundaryActive = true;
+        domainBoundary = bndry;
+        rebuildRequired = true;
+    }
+
+    void neighborList::setCutOff(double newCutOff) {
+        if (newCutOff <= 0) {
+            throw std::invalid_argument("Neighbor list cut off must be positive");
+        }
+        cutOff = newCutOff;
+        rebuildRequired = true;
+    }
+
+    void neighborList::setSkin(double newSkin) {
+        if (newSkin < 0) {
+            throw std::invalid_argument("Neighbor list skin must be non-negative");
+        }
+        skin = newSkin;
+        rebuildRequired = true;
+    }
+
+
+    bool neighborList::isPeriodic() const {
+        return boundaryActive and domainBoundary->getBoundaryType() == "periodic";
+    }
+
+    // Relative position (p2-p1), uses minimum image convention if the box is periodic
+    vec3<double> neighborList::relativePosition(const vec3<double> &p1, const vec3<double> &p2) const {
+        if (isPeriodic()) {
+            return msmrdtools::distancePeriodicBox(p1, p2, domainBoundary->boxsize);
+        } else {
+            return p2 - p1;
+        }
+    }
+
+    /* Checks if the list needs to be rebuilt. Without skin it is always rebuilt. With skin, it is rebuilt if
+     * the number of particles changed or if any particle moved more than skin/2 since the last build, since
+     * then two particles could have approached each other by more than the skin. */
+    bool neighborList::isRebuildRequired(const std::vector<vec3<double>> &newPositions) {
+        if (rebuildRequired or skin == 0 or newPositions.size() != referencePositions.size()) {
+            return true;
+        }
+        double maxDisplacementSquared = 0.0;
+        for (size_t i = 0; i < newPositions.size(); i++) {
+            auto displacement = relativePosition(referencePositions[i], newPositions[i]);
+            maxDisplacementSquared = std::max(maxDisplacementSquared, displacement.normSquared());
+        }
+        return 4.0*maxDisplacementSquared > skin*skin;
+    }
+
+    /* Sets cell grid with cells of length at least listRadius. For periodic boxes the grid covers the box,
+     * otherwise it covers the bounding box of the particles. The number of cells is limited, so sparse systems
+     * don't allocate large empty grids. */
+    void neighborList::setCellGrid(const std::vector<vec3<double>> &newPositions, double listRadius) {
+        vec3<double> domainLength;
+        if (isPeriodic()) {
+            lowerCorner = -0.5*domainBoundary->boxsize;
+            domainLength = 1.0*domainBoundary->boxsize;
+        } else {
+            lowerCorner = 1.0*newPositions[0];
+            vec3<double> upperCorner = 1.0*newPositions[0];
+            for (auto &pos : newPositions) {
+                for (int k = 0; k < 3; k++) {
+                    lowerCorner[k] = std::min(lowerCorner[k], pos[k]);
+                    upperCorner[k] = std::max(upperCorner[k], pos[k]);
+                }
+            }
+            domainLength = upperCorner - lowerCorner;
+        }
+        long maxNumCells = std::max(27L, 2L*static_cast<long>(newPositions.size()));
+        for (int k = 0; k < 3; k++) {
+            double cellsAlongAxis = std::min(std::floor(domainLength[k]/listRadius), double(maxNumCells));
+            numCells[k] = std::max(1, static_cast<int>(cellsAlongAxis));
+        }
+        // Larger cells are always valid, so coarsen the grid until it has at most maxNumCells cells.
+        while (static_cast<long>(numCells[0])*numCells[1]*numCells[2] > maxNumCells) {
+            auto largest = std::max_element(numCells.begin(), numCells.end());
+            *largest = std::max(1, *largest/2);
+        }
+        for (int k = 0; k < 3; k++) {
+            cellLength[k] = domainLength[k] > 0 ? domainLength[k]/numCells[k] : listRadius;
+        }
+    }
+
+    // Returns cell coordinates of a given position (wrapped around if periodic, clamped otherwise)
+    std::array<int, 3> neighborList::getCellCoordinates(const vec3<double> &pos) const {
+        std::array<int, 3> cell{};
+        for (int k = 0; k < 3; k++) {
+            int index = static_cast<int>(std::floor((pos[k] - lowerCorner[k])/cellLength[k]));
+            if (isPeriodic()) {
+                index = ((index % numCells[k]) + numCells[k]) % numCells[k];
+            } else {
+                index = std::min(std::max(index, 0), numCells[k] - 1);
+            }
+            cell[k] = index;
+        }
+        return cell;
+    }
+
+    /* Builds list of pairs within cutOff + skin using the cell list. For each particle only the adjacent cells
+     * are searched; with less than three cells along a periodic axis the adjacent cells repeat, so they are
+     * made unique to avoid listing a pair twice. */
+    void neighborList::buildNeighborPairs(const std::vector<vec3<double>> &newPositions) {
+        int numParticles = static_cast<int>(newPositions.size());
+        neighborPairs.clear();
+        referencePositions = newPositions;
+        rebuildRequired = false;
+        numRebuilds++;
+        if (numParticles < 2) {
+            return;
+        }
+
+        double listRadius = cutOff + skin;
+        double listRadiusSquared = listRadius*listRadius;
+        setCellGrid(newPositions, listRadius);
+
+        // Fill linked lists of particles in each cell
+        cellHead.assign(numCells[0]*numCells[1]*numCells[2], -1);
+        cellNext.resize(numParticles);
+        cellCoordinates.resize(numParticles);
+        for (int i = 0; i < numParticles; i++) {
+            cellCoordinates[i] = getCellCoordinates(newPositions[i]);
+            int cellIndex = (cellCoordinates[i][0]*numCells[1] + cellCoordinates[i][1])*numCells[2] +
+                    cellCoordinates[i][2];
+            cellNext[i] = cellHead[cellIndex];
+            cellHead[cellIndex] = i;
+        }
+
+        // Search pairs (i,j) with i<j in adjacent cells
+        std::array<std::array<int, 3>, 3> adjacentCells{};
+        std::array<int, 3> numAdjacentCells{};
+        for (int i = 0; i < numParticles; i++) {
+            for (int k = 0; k < 3; k++) {
+                numAdjacentCells[k] = 0;
+                for (int offset = -1; offset <= 1; offset++) {
+                    int index = cellCoordinates[i][k] + offset;
+                    if (isPeriodic()) {
+                        index = (index + numCells[k]) % numCells[k];
+                    } else if (index < 0 or index >= numCells[k]) {
+                        continue;
+                    }
+                    auto last = adjacentCells[k].begin() + numAdjacentCells[k];
+                    if (std::find(adjacentCells[k].begin(), last, index) == last) {
+                        adjacentCells[k][numAdjacentCells[k]++] = index;
+                    }
+                }
+            }
+            for (int a = 0; a < numAdjacentCells[0]; a++) {
+                for (int b = 0; b < numAdjacentCells[1]; b++) {
+                    for (int c = 0; c < numAdjacentCells[2]; c++) {
+                        int cellIndex = (adjacentCells[0][a]*numCells[1] + adjacentCells[1][b])*numCells[2] +
+                                adjacentCells[2][c];
+                        for (int j = cellHead[cellIndex]; j != -1; j = cellNext[j]) {
+                            if (j > i and relativePosition(newPositions[i],
+                                                           newPositions[j]).normSquared() <= listRadiusSquared) {
+                                neighborPairs.push_back({i, j});
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        std::sort(neighborPairs.begin(), neighborPairs.end());
+    }
+
+}
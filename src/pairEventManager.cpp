@@ -0,0 +1,199 @@
+//
+// Created by maojrs on 4/27/20.
+//
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include "pairEventManager.hpp"
+
+namespace msmrd {
+
+    std::string eventTypeName(eventType type) {
+        switch (type) {
+            case eventType::binding:
+                return "binding";
+            case eventType::unbinding:
+                return "unbinding";
+            case eventType::bound2bound:
+                return "bound2bound";
+            case eventType::transition2transition:
+                return "transition2transition";
+            case eventType::inTransition:
+                return "inTransition";
+            default:
+                return "empty";
+        }
+    }
+
+    eventType eventTypeFromName(const std::string &name) {
+        for (auto type : {eventType::empty, eventType::binding, eventType::unbinding, eventType::bound2bound,
+                          eventType::transition2transition, eventType::inTransition}) {
+            if (eventTypeName(type) == name) {
+                return type;
+            }
+        }
+        throw std::invalid_argument("Events can only take 'binding', 'unbinding', 'bound2bound', "
+                                    "'transition2transition', 'inTransition' or 'empty' types");
+    }
+
+
+    /**
+     *  Implementation of class to manage events of pairs of particles in MSM/RD algorithm.
+     */
+
+    /* Adds an event that happens after waitTime. This requires specifying the end state for the event/transition,
+     * the indexes (in partList) of the particles involved (part1Index < part2Index) and the event type. If the pair
+     * already has an event, only the one that happens first is kept. */
+    void pairEventManager::addEvent(double waitTime, int part1Index, int part2Index,
+                                    int originState, int endState, eventType type) {
+        if (type == eventType::empty) {
+            throw std::invalid_argument("Empty events can't be added to the event manager");
+        }
+        pairEvent thisEvent = {currentTime + waitTime, part1Index, part2Index, originState, endState, type};
+        auto search = eventSlots.find(pairKey(part1Index, part2Index));
+        int slot;
+        if (search != eventSlots.end()) {
+            slot = search->second;
+            if (events[slot].time <= thisEvent.time) {
+                return;
+            }
+        } else {
+            slot = allocateSlot();
+            eventSlots.emplace(pairKey(part1Index, part2Index), slot);
+        }
+        events[slot] = thisEvent;
+        if (type == eventType::inTransition) {
+            eventQueue.remove(slot);
+        } else {
+            eventQueue.push(slot, thisEvent.time);
+        }
+    }
+
+    /* Removes event associated with particles with indexes: part1Index and part2Index (part1Index < part2Index).
+     * Does nothing if the pair has no event. */
+    void pairEventManager::removeEvent(int part1Index, int part2Index) {
+        int slot = findSlot(part1Index, part2Index);
+        if (slot >= 0) {
+            removeSlot(slot);
+        }
+    }
+
+    // Returns event of the pair of particles, or the empty event if they have no event.
+    pairEvent pairEventManager::getEvent(int part1Index, int part2Index) const {
+        int slot = findSlot(part1Index, part2Index);
+        if (slot >= 0) {
+            return events[slot];
+        }
+        return emptyEvent;
+    }
+
+    /* Changes the type of the event of the pair of particles (if there is one). In transition events are taken out
+     * of the queue, so they are not applied again. */
+    void pairEventManager::setEventType(eventType newType, int part1Index, int part2Index) {
+        int slot = findSlot(part1Index, part2Index);
+        if (slot < 0) {
+            return;
+        }
+        if (newType == eventType::empty) {
+            removeSlot(slot);
+            return;
+        }
+        events[slot].type = newType;
+        if (newType == eventType::inTransition) {
+            eventQueue.remove(slot);
+        } else {
+            eventQueue.push(slot, events[slot].time);
+        }
+    }
+
+    // Returns time left until the event of the pair of particles happens (infinity if there is no event).
+    double pairEventManager::getEventTime(int part1Index, int part2Index) const {
+        int slot = findSlot(part1Index, part2Index);
+        if (slot >= 0) {
+            return events[slot].time - currentTime;
+        }
+        return std::numeric_limits<double>::infinity();
+    }
+
+    /* If the next event in the queue is due (its time is not after the current time), takes it out of the queue,
+     * copies it into dueEvent and returns true. The event is still kept in the event manager, the caller should
+     * remove it or change its type after applying it. */
+    bool pairEventManager::popDueEvent(pairEvent &dueEvent) {
+        if (eventQueue.empty() or eventQueue.topKey() > currentTime) {
+            return false;
+        }
+        dueEvent = events[eventQueue.pop()];
+        return true;
+    }
+
+    // Removes all the events (the current time is not changed).
+    void pairEventManager::clear() {
+        events.clear();
+        freeSlots.clear();
+        eventSlots.clear();
+        eventQueue.reset(eventQueue.getMaxIndex());
+    }
+
+    int pairEventManager::findSlot(int part1Index, int part2Index) const {
+        auto search = eventSlots.find(pairKey(part1Index, part2Index));
+        if (search != eventSlots.end()) {
+            return search->second;
+        }
+        return -1;
+    }
+
+    // Returns a free slot for a new event, growing the storage (and the range of the queue) if needed.
+    int pairEventManager::allocateSlot() {
+        if (not freeSlots.empty()) {
+            int slot = freeSlots.back();
+            freeSlots.pop_back();
+            return slot;
+        }
+        events.push_back(emptyEvent);
+        int slot = static_cast<int>(events.size() - 1);
+        if (slot >= eventQueue.getMaxIndex()) {
+            eventQueue.extend(std::max(2 * eventQueue.getMaxIndex(), 16));
+        }
+        return slot;
+    }
+
+    void pairEventManager::removeSlot(int slot) {
+        eventSlots.erase(pairKey(events[slot].part1Index, events[slot].part2Index));
+        eventQueue.remove(slot);
+        events[slot] = emptyEvent;
+        freeSlots.push_back(slot);
+    }
+
+
+    // Writes current events to event logfile
+    void pairEventManager::write2EventLog(int timeIteration) {
+        eventLog.push_back(std::to_string(timeIteration));
+        if (not eventSlots.empty()) {
+            for (auto &thisEvent : events) {
+                if (thisEvent.type == eventType::empty) {
+                    continue;
+                }
+                auto event = std::to_string(thisEvent.time - currentTime) + " " +
+                             std::to_string(thisEvent.part1Index) + " " + std::to_string(thisEvent.part2Index) +
+                             " " + std::to_string(thisEvent.originState) + " " +
+                             std::to_string(thisEvent.endState) + " " + eventTypeName(thisEvent.type) + " \n";
+                eventLog.push_back(event);
+            }
+        } else{
+            eventLog.push_back("No events \n");
+        }
+    }
+
+    // Prints log into file
+    void pairEventManager::printEventLog(std::string baseFilename) {
+        std::ofstream outputfile;
+        outputfile.open (baseFilename + ".dat");
+        for (auto &thisLine : eventLog) {
+            outputfile << thisLine << " \n";
+        }
+        outputfile.close();
+        eventLog.clear();
+    }
+
+}
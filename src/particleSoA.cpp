@@ -0,0 +1,148 @@
+//
+// Created by maojrs on 3/9/20.
+//
+
+#include "particleSoA.hpp"
+
+namespace msmrd {
+
+    /**
+     * Implementation of structure of arrays particle container
+     */
+
+    // Constructs container from a particle list (e.g. one created in python)
+    particleSoA::particleSoA(const std::vector<particle> &parts) {
+        fromParticleList(parts);
+    }
+
+    // Resizes all the arrays, new entries are left to be filled by setParticle
+    void particleSoA::resize(int numParticles) {
+        pid.resize(numParticles);
+        active.resize(numParticles);
+        type.resize(numParticles);
+        D.resize(numParticles);
+        Drot.resize(numParticles);
+        x.resize(numParticles);
+        y.resize(numParticles);
+        z.resize(numParticles);
+        ux.resize(numParticles);
+        uy.resize(numParticles);
+        uz.resize(numParticles);
+        q0.resize(numParticles);
+        q1.resize(numParticles);
+        q2.resize(numParticles);
+        q3.resize(numParticles);
+        state.resize(numParticles);
+        nextState.resize(numParticles);
+        lagtime.resize(numParticles);
+        timeCounter.resize(numParticles);
+        propagateTMSM.resize(numParticles);
+        activeMSM.resize(numParticles);
+        boundTo.resize(numParticles);
+        boundState.resize(numParticles);
+        compoundIndex.resize(numParticles);
+    }
+
+    // Copies variables of particle into entry index of the container
+    void particleSoA::setParticle(int index, const particle &part) {
+        pid[index] = part.pid;
+        active[index] = part.active;
+        type[index] = part.type;
+        D[index] = part.D;
+        Drot[index] = part.Drot;
+        setPosition(index, part.position);
+        setOrientvector(index, part.orientvector);
+        setOrientation(index, part.orientation);
+        state[index] = part.state;
+        nextState[index] = part.nextState;
+        lagtime[index] = part.lagtime;
+        timeCounter[index] = part.timeCounter;
+        propagateTMSM[index] = part.propagateTMSM;
+        activeMSM[index] = part.activeMSM;
+        boundTo[index] = part.boundTo;
+        boundState[index] = part.boundState;
+        compoundIndex[index] = part.compoundIndex;
+    }
+
+    /* Copies entry index of the container into an existing particle. Variables not stored in the container
+     * (boundList, boundStates, activePatchList) are left untouched and next positions/orientations are
+     * set to the current ones. */
+    void particleSoA::copyToParticle(int index, particle &part) const {
+        part.pid = pid[index];
+        part.active = active[index] != 0;
+        part.type = type[index];
+        part.D = D[index];
+        part.Drot = Drot[index];
+        part.position = getPosition(index);
+        part.orientvector = getOrientvector(index);
+        part.orientation = getOrientation(index);
+        part.nextPosition = 1.0*part.position;
+        part.nextOrientvector = 1.0*part.orientvector;
+        part.nextOrientation = 1.0*part.orientation;
+        part.state = state[index];
+        part.nextState = nextState[index];
+        part.lagtime = lagtime[index];
+        part.timeCounter = timeCounter[index];
+        part.propagateTMSM = propagateTMSM[index] != 0;
+        part.activeMSM = activeMSM[index] != 0;
+        part.boundTo = boundTo[index];
+        part.boundState = boundState[index];
+        part.compoundIndex = compoundIndex[index];
+    }
+
+    particle particleSoA::getParticle(int index) const {
+        particle part(type[index], state[index], D[index], Drot[index], getPosition(index), getOrientation(index));
+        copyToParticle(index, part);
+        return part;
+    }
+
+    // Fills container from particle list (reuses memory if the number of particles is the same)
+    void particleSoA::fromParticleList(const std::vector<particle> &parts) {
+        resize(static_cast<int>(parts.size()));
+        for (int i = 0; i < size(); i++) {
+            setParticle(i, parts[i]);
+        }
+    }
+
+    std::vector<particle> particleSoA::toParticleList() const {
+        std::vector<particle> parts;
+        parts.reserve(size());
+        for (int i = 0; i < size(); i++) {
+            parts.push_back(getParticle(i));
+        }
+        return parts;
+    }
+
+    /* Copies container into an existing particle list. If the sizes match, the variables not stored in the
+     * container are kept, otherwise the particle list is recreated. */
+    void particleSoA::copyToParticleList(std::vector<particle> &parts) const {
+        if (static_cast<int>(parts.size()) != size()) {
+            parts = toParticleList();
+            return;
+        }
+        for (int i = 0; i < size(); i++) {
+            copyToParticle(i, parts[i]);
+        }
+    }
+
+
+    void particleSoA::setPosition(int index, const vec3<double> &pos) {
+        x[index] = pos[0];
+        y[index] = pos[1];
+        z[index] = pos[2];
+    }
+
+    void particleSoA::setOrientvector(int index, const vec3<double> &orientvec) {
+        ux[index] = orientvec[0];
+        uy[index] = orientvec[1];
+        uz[index] = orientvec[2];
+    }
+
+    void particleSoA::setOrientation(int index, const quaternion<double> &orient) {
+        q0[index] = orient[0];
+        q1[index] = orient[1];
+        q2[index] = orient[2];
+        q3[index] = orient[3];
+    }
+
+}
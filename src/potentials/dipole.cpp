@@ -15,12 +15,12 @@ namespace msmrd {
     dipole::dipole(double scalefactor, std::vector<double> &directionEField)
             : scalefactor(scalefactor), directionEField(directionEField) {};
 
-    double dipole::evaluate(particle &part) {
+    double dipole::evaluate(const particle &part) const {
         return part.position * part.orientvector;
     };
 
 // Calculates force and torque due to potential, output force is zero
-    std::array<vec3<double>, 2> dipole::forceTorque(particle &part) {
+    std::array<vec3<double>, 2> dipole::forceTorque(const particle &part) const {
         vec3<double> force = vec3<double>(0., 0., 0.);
         vec3<double> torque;
         torque = part.orientvector.cross(directionEField);
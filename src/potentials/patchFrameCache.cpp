@@ -0,0 +1,47 @@
+//
+// Created by maojrs on 3/23/20.
+//
+
+#include <functional>
+#include "potentials/patchFrameCache.hpp"
+
+namespace msmrd {
+
+    // Returns index of particle in the cache, or -1 if not cached or if it changed since the last update
+    int patchFrameCache::getIndex(const particle &part) const {
+        std::less<const particle *> less;
+        if (numParticles == 0 or less(&part, firstParticle) or not less(&part, firstParticle + numParticles)) {
+            return -1;
+        }
+        auto index = static_cast<int>(&part - firstParticle);
+        if (part.type != types[index] or not (part.orientation == orientations[index])) {
+            return -1;
+        }
+        return index;
+    }
+
+    /* Returns pointer to the rotated patches (unitary or not) of a particle. If the particle is not in the cache,
+     * they are calculated into buffer. */
+    const vec3<double> *patchFrameCache::getPatchNormals(const particle &part,
+                                                         const std::vector<vec3<double>> &patchesCoords,
+                                                         bool unitary, std::vector<vec3<double>> &buffer) const {
+        int index = getIndex(part);
+        if (index >= 0 and offsets[index + 1] - offsets[index] == static_cast<int>(patchesCoords.size())) {
+            return unitary ? unitNormals.data() + offsets[index] : normals.data() + offsets[index];
+        }
+        buffer.resize(patchesCoords.size());
+        for (size_t i = 0; i < patchesCoords.size(); i++) {
+            buffer[i] = msmrdtools::rotateVec(patchesCoords[i], part.orientation);
+            if (unitary) {
+                buffer[i] = buffer[i] / buffer[i].norm();
+            }
+        }
+        return buffer.data();
+    }
+
+    void patchFrameCache::clear() {
+        firstParticle = nullptr;
+        numParticles = 0;
+    }
+
+}
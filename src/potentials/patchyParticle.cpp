@@ -2,6 +2,7 @@
 // Created by maojrs on 9/10/18.
 //
 
+#include <algorithm>
 #include "potentials/patchyParticle.hpp"
 #include "quaternion.hpp"
 #include "tools.hpp"
@@ -80,7 +81,7 @@ namespace msmrd{ ;
     }
 
     // Evaluates potential at given positions and orientations of two particles
-    double patchyParticle::evaluate(particle &part1, particle &part2) {
+    double patchyParticle::evaluate(const particle &part1, const particle &part2) const {
         double repulsivePotential;
         double attractivePotential;
         double patchesPotential = 0.0;
@@ -99,12 +100,17 @@ namespace msmrd{ ;
         attractivePotential = quadraticPotential(rvec.norm(), sigma, epsAttractive, aAttractive, rstarAttractive);
 
         if (rvec.norm() <= 2*sigma and patchesActive) {
+            // Rotated patches (from cache if available)
+            std::vector<vec3<double>> buffer1;
+            std::vector<vec3<double>> buffer2;
+            auto patchNormals1 = patchFrames.getPatchNormals(part1, patchesCoordinates, false, buffer1);
+            auto patchNormals2 = patchFrames.getPatchNormals(part2, patchesCoordinates, false, buffer2);
             // Loop over all patches
             for (int i = 0; i < patchesCoordinates.size(); i++) {
-                patchNormal1 = msmrdtools::rotateVec(patchesCoordinates[i], part1.orientation);
+                patchNormal1 = patchNormals1[i];
                 patch1 = pos1virtual + 0.5*sigma*patchNormal1;
                 for (int j = 0; j < patchesCoordinates.size(); j++) {
-                    patchNormal2 = msmrdtools::rotateVec(patchesCoordinates[j], part2.orientation);
+                    patchNormal2 = patchNormals2[j];
                     patch2 = part2.position + 0.5*sigma*patchNormal2;
                     relpatch = patch2 - patch1; // Scale unit distance of patches by sigma
                     patchesPotential += patchPotentialScaling * quadraticPotential(relpatch.norm(), sigma,
@@ -118,7 +124,7 @@ namespace msmrd{ ;
 
     /* Calculate and return (force1, torque1, force2, torque2), which correspond to the force and torque
      * acting on particle1 and the force and torque acting on particle2, respectively. */
-    std::array<vec3<double>, 4> patchyParticle::forceTorque(particle &part1, particle &part2) {
+    std::array<vec3<double>, 4> patchyParticle::forceTorque(const particle &part1, const particle &part2) const {
         vec3<double> force;
         vec3<double> force1 = vec3<double> (0.0, 0.0, 0.0);
         vec3<double> force2 = vec3<double> (0.0, 0.0, 0.0);
@@ -148,11 +154,49 @@ namespace msmrd{ ;
     }
 
 
+    /* Returns the interaction range: the patches only interact for r <= 2 sigma and the isotropic parts
+     * vanish beyond their critical radius rcritical = sigma^2/(a rstar), so the cut off is the largest of them. */
+    double patchyParticle::getCutOff() const {
+        double rcriticalRepulsive = std::pow(sigma, 2)/(aRepulsive*rstarRepulsive);
+        double rcriticalAttractive = std::pow(sigma, 2)/(aAttractive*rstarAttractive);
+        return std::max({2*sigma, rcriticalRepulsive, rcriticalAttractive});
+    }
+
+
+    // Rotates the patches of all the particles once per time step (see patchFrameCache)
+    void patchyParticle::precompute(const std::vector<particle> &parts) {
+        patchFrames.update(parts, [this](const particle &part) -> const std::vector<vec3<double>> & {
+            return patchesCoordinates;
+        });
+    }
+
+
+    /* Slow part of the interaction: the soft isotropic repulsive and attractive potentials. Child classes
+     * with additional terms add them to the fast part. */
+    std::array<vec3<double>, 4> patchyParticle::forceTorqueSlow(const particle &part1, const particle &part2) const {
+        vec3<double> rvec = relativePosition(part1.position, part2.position);
+        auto forceNorm = derivativeQuadraticPotential(rvec.norm(), sigma, epsRepulsive, aRepulsive, rstarRepulsive) +
+                derivativeQuadraticPotential(rvec.norm(), sigma, epsAttractive, aAttractive, rstarAttractive);
+        return centralForceTorque(rvec, forceNorm);
+    }
+
+    // Fast part of the interaction: the stiff patches interactions only.
+    std::array<vec3<double>, 4> patchyParticle::forceTorqueFast(const particle &part1, const particle &part2) const {
+        std::array<vec3<double>, 2> relPos = relativePositionComplete(part1.position, part2.position);
+        auto zero = vec3<double> (0.0, 0.0, 0.0);
+        std::array<vec3<double>, 4> forctorq = {zero, zero, zero, zero};
+        if (relPos[1].norm() <= 2*sigma and patchesActive) {
+            std::tie(forctorq[0], forctorq[1], forctorq[2], forctorq[3]) = forceTorquePatches(part1, part2, relPos[0]);
+        }
+        return forctorq;
+    }
+
+
     /* Calculates forces and torques due to pacthes interactions, first two vectors returned are the force
      * and torque applied to particle 1 and the second two vectors are the force and torque applied to particle 2.
      * This function is called by main forceTorque function. */
     std::tuple<vec3<double>, vec3<double>, vec3<double>, vec3<double>> patchyParticle::forceTorquePatches(
-            particle &part1, particle &part2, const vec3<double> pos1virtual) {
+            const particle &part1, const particle &part2, const vec3<double> pos1virtual) const {
         vec3<double> patch1;
         vec3<double> patch2;
         vec3<double> relpatch;
@@ -166,15 +210,19 @@ namespace msmrd{ ;
         vec3<double> torque1 = vec3<double> (0.0, 0.0, 0.0);
         vec3<double> torque2 = vec3<double> (0.0, 0.0, 0.0);
 
+        // Unitary rotated patches (from cache if available)
+        std::vector<vec3<double>> buffer1;
+        std::vector<vec3<double>> buffer2;
+        auto patchNormals1 = patchFrames.getPatchNormals(part1, patchesCoordinates, true, buffer1);
+        auto patchNormals2 = patchFrames.getPatchNormals(part2, patchesCoordinates, true, buffer2);
+
         // Loop over all patches of particle 1
         for (int i = 0; i < patchesCoordinates.size(); i++) {
-            patchNormal1 = msmrdtools::rotateVec(patchesCoordinates[i], part1.orientation);
-            patchNormal1 = patchNormal1/patchNormal1.norm();
+            patchNormal1 = patchNormals1[i];
             patch1 = pos1virtual + 0.5*sigma*patchNormal1;
             // Loop over all patches of particle 2
             for (int j = 0; j < patchesCoordinates.size(); j++) {
-                patchNormal2 = msmrdtools::rotateVec(patchesCoordinates[j], part2.orientation);
-                patchNormal2 = patchNormal2/patchNormal2.norm();
+                patchNormal2 = patchNormals2[j];
                 patch2 = part2.position + 0.5*sigma*patchNormal2;
                 relpatch = patch2 - patch1;
 
@@ -205,7 +253,7 @@ namespace msmrd{ ;
      * @param eps strength of the potential
      * @param rstar distance to switch to second potential function
      * @param a the stiffness, together with rstar determines the range of the potential */
-    double patchyParticle::quadraticPotential(double r, double sig, double eps, double a, double rstar) {
+    double patchyParticle::quadraticPotential(double r, double sig, double eps, double a, double rstar) const {
         // Parameters to force continuity and continuous derivative
         double rcritical = std::pow(sig, 2)/(a*rstar);
         double b = (1.0 - a*std::pow(rstar/sig, 2))/std::pow(rcritical/sig - rstar/sig, 2);
@@ -222,7 +270,8 @@ namespace msmrd{ ;
     }
 
     // Derivative of patchyParticle::quadraticPotential
-    double patchyParticle::derivativeQuadraticPotential(double r, double sig, double eps, double a, double rstar) {
+    double patchyParticle::derivativeQuadraticPotential(double r, double sig, double eps, double a,
+                                                        double rstar) const {
         // Parameters to force continuity and continuous derivative
         double rcritical = std::pow(sig, 2)/(a*rstar);
         double b = (1.0 - a*std::pow(rstar/sig, 2))/std::pow(rcritical/sig - rstar/sig, 2);
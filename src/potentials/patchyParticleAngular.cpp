@@ -25,7 +25,7 @@ namespace msmrd {
 
 
     // Evaluates potential at given positions and orientations of two particles
-    double patchyParticleAngular::evaluate(particle &part1, particle &part2) {
+    double patchyParticleAngular::evaluate(const particle &part1, const particle &part2) const {
 
         // Get part of potential that is the same as for normal patchy particle from parent function.
         double patchyParticlePotential = patchyParticle::evaluate(part1, part2);
@@ -37,11 +37,15 @@ namespace msmrd {
          * but efficiency is not a problem in this example) */
         double angularPotential = 0.0;
         if (rvec.norm() <= 2*sigma and patchesActive) {
-            // Calculate all normal vectors to first two patches for both particles
-            vec3<double> part1PatchNormal1 = msmrdtools::rotateVec(patchesCoordinates[0], part1.orientation);
-            vec3<double> part1PatchNormal2 = msmrdtools::rotateVec(patchesCoordinates[1], part1.orientation);
-            vec3<double> part2PatchNormal1 = msmrdtools::rotateVec(patchesCoordinates[0], part2.orientation);
-            vec3<double> part2PatchNormal2 = msmrdtools::rotateVec(patchesCoordinates[1], part2.orientation);
+            // Calculate all normal vectors to first two patches for both particles (from cache if available)
+            std::vector<vec3<double>> buffer1;
+            std::vector<vec3<double>> buffer2;
+            auto patchNormals1 = patchFrames.getPatchNormals(part1, patchesCoordinates, false, buffer1);
+            auto patchNormals2 = patchFrames.getPatchNormals(part2, patchesCoordinates, false, buffer2);
+            vec3<double> part1PatchNormal1 = patchNormals1[0];
+            vec3<double> part1PatchNormal2 = patchNormals1[1];
+            vec3<double> part2PatchNormal1 = patchNormals2[0];
+            vec3<double> part2PatchNormal2 = patchNormals2[1];
 
             // Calculate unitary vectors describing planes where particle center and first two patches are
             vec3<double> plane1 = part1PatchNormal1.cross(part1PatchNormal2);
@@ -60,11 +64,20 @@ namespace msmrd {
     }
 
     /* Calculate and return (force1, torque1, force2, torque2), which correspond to the force and torque
-     * acting on particle1 and the force and torque acting on particle2, respectively. */
-    std::array<vec3<double>, 4> patchyParticleAngular::forceTorque(particle &part1, particle &part2) {
+     * acting on particle1 and the force and torque acting on particle2, respectively. It is the sum of the
+     * isotropic part (slow) and the patches and angular part (fast). */
+    std::array<vec3<double>, 4> patchyParticleAngular::forceTorque(const particle &part1,
+                                                                   const particle &part2) const {
+        return addForceTorques(forceTorqueSlow(part1, part2), patchyParticleAngular::forceTorqueFast(part1, part2));
+    }
+
+    /* Fast part of the interaction: the patches interactions (from parent class) and the explicit angular
+     * dependence. The slow isotropic part is the same as in the parent class. */
+    std::array<vec3<double>, 4> patchyParticleAngular::forceTorqueFast(const particle &part1,
+                                                                       const particle &part2) const {
 
         // Get part of force and torque that is the same as for normal patchy particle from parent function.
-        auto patchyParticleForceTorque = patchyParticle::forceTorque(part1, part2);
+        auto patchyParticleForceTorque = patchyParticle::forceTorqueFast(part1, part2);
 
         vec3<double> force1 = patchyParticleForceTorque[0];
         vec3<double> torque1 = patchyParticleForceTorque[1];
@@ -78,11 +91,15 @@ namespace msmrd {
         /* Explicit angular dependence based on first two patches of the two particles (not most efficient approach
          * but efficiency is not a problem in this example) */
         if (rvec.norm() <= 2*sigma and patchesActive) {
-            // Calculate all normal vectors to first two patches for both particles
-            vec3<double> part1PatchNormal1 = msmrdtools::rotateVec(patchesCoordinates[0], part1.orientation);
-            vec3<double> part1PatchNormal2 = msmrdtools::rotateVec(patchesCoordinates[1], part1.orientation);
-            vec3<double> part2PatchNormal1 = msmrdtools::rotateVec(patchesCoordinates[0], part2.orientation);
-            vec3<double> part2PatchNormal2 = msmrdtools::rotateVec(patchesCoordinates[1], part2.orientation);
+            // Calculate all normal vectors to first two patches for both particles (from cache if available)
+            std::vector<vec3<double>> buffer1;
+            std::vector<vec3<double>> buffer2;
+            auto patchNormals1 = patchFrames.getPatchNormals(part1, patchesCoordinates, false, buffer1);
+            auto patchNormals2 = patchFrames.getPatchNormals(part2, patchesCoordinates, false, buffer2);
+            vec3<double> part1PatchNormal1 = patchNormals1[0];
+            vec3<double> part1PatchNormal2 = patchNormals1[1];
+            vec3<double> part2PatchNormal1 = patchNormals2[0];
+            vec3<double> part2PatchNormal2 = patchNormals2[1];
 
             // Calculate unitary vectors describing planes where particle center and first two patches are
             vec3<double> plane1 = part1PatchNormal1.cross(part1PatchNormal2);
@@ -110,7 +127,7 @@ namespace msmrd {
      */
 
     // Evaluates potential at given positions and orientations of two particles
-    double patchyParticleAngular2::evaluate(particle &part1, particle &part2) {
+    double patchyParticleAngular2::evaluate(const particle &part1, const particle &part2) const {
 
         // Get part of potential that is the same as for normal patchy particle from parent function.
         double patchyParticlePotential = patchyParticle::evaluate(part1, part2);
@@ -136,25 +153,30 @@ namespace msmrd {
     }
 
     /* Calculate and return (force1, torque1, force2, torque2), which correspond to the force and torque
-     * acting on particle1 and the force and torque acting on particle2, respectively. */
-    std::array<vec3<double>, 4> patchyParticleAngular2::forceTorque(particle &part1, particle &part2) {
-
-        /* Get part of force and torque that is the same as for normal patchy particle from parent function,
-         * Note this function is different than the one used by patchyParticleAngular above*/
-        auto patchyParticleForceTorque = normalForceTorque(part1, part2);
+     * acting on particle1 and the force and torque acting on particle2, respectively. It is the sum of the
+     * isotropic part (slow) and the selective patches and angular part (fast). */
+    std::array<vec3<double>, 4> patchyParticleAngular2::forceTorque(const particle &part1,
+                                                                    const particle &part2) const {
+        return addForceTorques(forceTorqueSlow(part1, part2), patchyParticleAngular2::forceTorqueFast(part1, part2));
+    }
 
-        vec3<double> force1 = patchyParticleForceTorque[0];
-        vec3<double> torque1 = patchyParticleForceTorque[1];
-        vec3<double> force2 = patchyParticleForceTorque[2];
-        vec3<double> torque2 = patchyParticleForceTorque[3];
+    /* Fast part of the interaction: the selective patches interactions (see forceTorquePatchesSelective) and
+     * the explicit angular dependence. The slow isotropic part is the same as for normal patchy particles. */
+    std::array<vec3<double>, 4> patchyParticleAngular2::forceTorqueFast(const particle &part1,
+                                                                        const particle &part2) const {
+        vec3<double> force1 = vec3<double> (0.0, 0.0, 0.0);
+        vec3<double> force2 = vec3<double> (0.0, 0.0, 0.0);
+        vec3<double> torque1 = vec3<double> (0.0, 0.0, 0.0);
+        vec3<double> torque2 = vec3<double> (0.0, 0.0, 0.0);
 
         std::array<vec3<double>, 2> relPos = relativePositionComplete(part1.position, part2.position);
         vec3<double> pos1virtual = relPos[0]; // virtual pos1 if periodic boundary; otherwise pos1.
         vec3<double> rvec = relPos[1]; //pos2 - pos1;
 
-        /* Explicit angular dependence. */
+        // Calculate forces and torque due to patches interaction and explicit angular dependence.
         vec3<double> derivativeAngluarPotential = vec3<double> (0.0, 0.0, 0.0);
         if (rvec.norm() <= 2.0 * sigma and patchesActive) {
+            std::tie(force1, torque1, force2, torque2) = forceTorquePatchesSelective(part1, part2, pos1virtual);
             // Get planes needed to be aligned by torque
             vec3<double> plane1;
             vec3<double> plane2;
@@ -171,44 +193,13 @@ namespace msmrd {
         return {force1, torque1, force2, torque2};
     }
 
-    /* Calculate and return (force1, torque1, force2, torque2), which correspond to the force and torque
-     * acting on particle1 and the force and torque acting on particle2, respectively. Function is the same
-     * as in patchyParticle, but it calls a different function for forceTorquePatches.*/
-    std::array<vec3<double>, 4> patchyParticleAngular2::normalForceTorque(particle &part1, particle &part2) {
-        vec3<double> force;
-        vec3<double> force1 = vec3<double> (0.0, 0.0, 0.0);
-        vec3<double> force2 = vec3<double> (0.0, 0.0, 0.0);
-        vec3<double> torque1 = vec3<double> (0.0, 0.0, 0.0);
-        vec3<double> torque2 = vec3<double> (0.0, 0.0, 0.0);
-
-        std::array<vec3<double>, 2> relPos = relativePositionComplete(part1.position, part2.position);
-        vec3<double> pos1virtual = relPos[0]; // virtual part1.position if periodic boundary; otherwise part1.position.
-        vec3<double> rvec = relPos[1]; //part2.position - part1.position;
-
-        // auxiliary variables to calculate force and torque
-        double repulsiveForceNorm;
-        double attractiveForceNorm;
-
-        /* Calculate and add forces due to repulsive and attractive isotropic potentials.
-         *  Note correct sign/direction of force given by rvec/rvec.norm*() */
-        repulsiveForceNorm = derivativeQuadraticPotential(rvec.norm(), sigma, epsRepulsive, aRepulsive, rstarRepulsive);
-        attractiveForceNorm = derivativeQuadraticPotential(rvec.norm(), sigma, epsAttractive, aAttractive, rstarAttractive);
-        force = (repulsiveForceNorm + attractiveForceNorm)*rvec/rvec.norm();
-
-        // Calculate forces and torque due to patches interaction
-        if (rvec.norm() <= 2*sigma and patchesActive) {
-            std::tie(force1, torque1, force2, torque2) = forceTorquePatchesSelective(part1, part2, pos1virtual);
-        }
-
-        return {force + force1, torque1, -1.0*force + force2, torque2};
-    }
-
     /* Calculates forces and torques due to pacthes interactions, first two vectors returned are the force
      * and torque applied to particle 1 and the second two vectors are the force and torque applied to particle 2.
      * This function is called by main forceTorque function. Only calculates the force if the patches are active to
      * avoid three or more particle bindings in multiparticle simulations */
     std::tuple<vec3<double>, vec3<double>, vec3<double>, vec3<double>> patchyParticleAngular2::
-            forceTorquePatchesSelective(particle &part1, particle &part2, const vec3<double> pos1virtual) {
+            forceTorquePatchesSelective(const particle &part1, const particle &part2,
+                                        const vec3<double> pos1virtual) const {
         vec3<double> patch1;
         vec3<double> patch2;
         vec3<double> relpatch;
@@ -222,19 +213,23 @@ namespace msmrd {
         vec3<double> torque1 = vec3<double> (0.0, 0.0, 0.0);
         vec3<double> torque2 = vec3<double> (0.0, 0.0, 0.0);
 
+        // Unitary rotated patches (from cache if available)
+        std::vector<vec3<double>> buffer1;
+        std::vector<vec3<double>> buffer2;
+        auto patchNormals1 = patchFrames.getPatchNormals(part1, patchesCoordinates, true, buffer1);
+        auto patchNormals2 = patchFrames.getPatchNormals(part2, patchesCoordinates, true, buffer2);
+
         // Loop over all patches of particle 1
         for (int i = 0; i < patchesCoordinates.size(); i++) {
             // Check patch i of particle 1 is active
-            patchNormal1 = msmrdtools::rotateVec(patchesCoordinates[i], part1.orientation);
-            patchNormal1 = patchNormal1 / patchNormal1.norm();
+            patchNormal1 = patchNormals1[i];
             patch1 = pos1virtual + 0.5 * sigma * patchNormal1;
             // Loop over all patches of particle 2
             for (int j = 0; j < patchesCoordinates.size(); j++) {
                 // Check if patchy binding is active
                 auto patchBindingActive = isPatchBindingActive(part1, part2, i, j);
                 if (patchBindingActive) { // Check patch j of particle 2 is active
-                    patchNormal2 = msmrdtools::rotateVec(patchesCoordinates[j], part2.orientation);
-                    patchNormal2 = patchNormal2 / patchNormal2.norm();
+                    patchNormal2 = patchNormals2[j];
                     patch2 = part2.position + 0.5 * sigma * patchNormal2;
                     relpatch = patch2 - patch1;
 
@@ -261,8 +256,8 @@ namespace msmrd {
 
     /* Check if patches should be active or not. If activePatchList was not initialized, it is
      * assumed all patches are active */
-    bool patchyParticleAngular2::isPatchBindingActive(particle &part1, particle &part2,
-            int indexPatch1, int indexPatch2) {
+    bool patchyParticleAngular2::isPatchBindingActive(const particle &part1, const particle &part2,
+            int indexPatch1, int indexPatch2) const {
         bool patchyBindingActive = true;
         if (part1.activePatchList.size() > 0) {
             patchyBindingActive = false;
@@ -282,13 +277,17 @@ namespace msmrd {
     /* Given two quaternions/orientations, returns planes(unit vectors) to be aligned by torque. These
      * may vary depending on the physical arrangement of your molecules. */
     std::tuple<vec3<double>, vec3<double>> patchyParticleAngular2::calculatePlanes(const particle &part1,
-                                                                                   const particle &part2) {
-
-        // Calculate all normal vectors to first two patches for both particles
-        vec3<double> part1PatchNormal1 = msmrdtools::rotateVec(patchesCoordinates[0], part1.orientation);
-        vec3<double> part1PatchNormal2 = msmrdtools::rotateVec(patchesCoordinates[1], part1.orientation);
-        vec3<double> part2PatchNormal1 = msmrdtools::rotateVec(patchesCoordinates[0], part2.orientation);
-        vec3<double> part2PatchNormal2 = msmrdtools::rotateVec(patchesCoordinates[1], part2.orientation);
+                                                                                   const particle &part2) const {
+
+        // Calculate all normal vectors to first two patches for both particles (from cache if available)
+        std::vector<vec3<double>> buffer1;
+        std::vector<vec3<double>> buffer2;
+        auto patchNormals1 = patchFrames.getPatchNormals(part1, patchesCoordinates, false, buffer1);
+        auto patchNormals2 = patchFrames.getPatchNormals(part2, patchesCoordinates, false, buffer2);
+        vec3<double> part1PatchNormal1 = patchNormals1[0];
+        vec3<double> part1PatchNormal2 = patchNormals1[1];
+        vec3<double> part2PatchNormal1 = patchNormals2[0];
+        vec3<double> part2PatchNormal2 = patchNormals2[1];
 
         // Calculate positions of patches
         vec3<double> part1Patch1 = part1.position + 0.5*sigma * part1PatchNormal1;
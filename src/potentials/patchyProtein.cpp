@@ -2,6 +2,7 @@
 // Created by maojrs on 9/26/18.
 //
 
+#include <algorithm>
 #include <utility>
 #include "potentials/patchyProtein.hpp"
 #include "quaternion.hpp"
@@ -83,7 +84,7 @@ namespace msmrd {
 
 
     // Evaluates potential at given positions and orientations of two particles
-    double patchyProtein::evaluate(particle &part1, particle &part2) {
+    double patchyProtein::evaluate(const particle &part1, const particle &part2) const {
 
         // Calculates relative position
         auto relPos = relativePositionComplete(part1.position, part2.position);
@@ -95,8 +96,8 @@ namespace msmrd {
         auto attractivePotential = quadraticPotential(rvec.norm(), sigma, epsAttractive, aAttractive, rstarAttractive);
 
         /* Assign patch pattern depending on particle type (note only two types of particles are supported here) */
-        auto patchesCoords1 = assignPatches(part1.type);
-        auto patchesCoords2 = assignPatches(part2.type);
+        auto &patchesCoords1 = assignPatches(part1.type);
+        auto &patchesCoords2 = assignPatches(part2.type);
 
         // Evaluate patches potential if particles are close enough
         double patchesPotential = 0.0;
@@ -112,10 +113,10 @@ namespace msmrd {
 
     /* Auxiliary function that calculates patches interaction contribution to potential. Called by main
      * evaluate function. */
-    double patchyProtein::evaluatePatchesPotential(particle &part1, particle &part2,
+    double patchyProtein::evaluatePatchesPotential(const particle &part1, const particle &part2,
                                                    vec3<double> &pos1virtual,
-                                                   std::vector<vec3<double>> &patchesCoords1,
-                                                   std::vector<vec3<double>> &patchesCoords2){
+                                                   const std::vector<vec3<double>> &patchesCoords1,
+                                                   const std::vector<vec3<double>> &patchesCoords2) const {
         // Declare variables used in loop
         double patchesPotential = 0.0;
         vec3<double> patchNormal1;
@@ -124,12 +125,18 @@ namespace msmrd {
         vec3<double> patch2;
         vec3<double> rpatch;
 
+        // Rotated patches (from cache if available)
+        std::vector<vec3<double>> buffer1;
+        std::vector<vec3<double>> buffer2;
+        auto patchNormals1 = patchFrames.getPatchNormals(part1, patchesCoords1, false, buffer1);
+        auto patchNormals2 = patchFrames.getPatchNormals(part2, patchesCoords2, false, buffer2);
+
         // Loop over all patches
         for (int i = 0; i < patchesCoords1.size(); i++) {
-            patchNormal1 = msmrdtools::rotateVec(patchesCoords1[i], part1.orientation);
+            patchNormal1 = patchNormals1[i];
             patch1 = pos1virtual + 0.5 * sigma * patchNormal1;
             for (int j = 0; j < patchesCoords2.size(); j++) {
-                patchNormal2 = msmrdtools::rotateVec(patchesCoords2[j], part2.orientation);
+                patchNormal2 = patchNormals2[j];
                 patch2 = part2.position + 0.5 * sigma * patchNormal2;
                 rpatch = patch2 - patch1; // Scale unit distance of patches by sigma
                 // Assumes the first patch from type "0" has a different type of interaction,
@@ -151,7 +158,7 @@ namespace msmrd {
 
     /* Calculate and return (force1, torque1, force2, torque2), which correspond to the force and torque
      * acting on particle1 and the force and torque acting on particle2, respectively. */
-    std::array<vec3<double>, 4> patchyProtein::forceTorque(particle &part1, particle &part2) {
+    std::array<vec3<double>, 4> patchyProtein::forceTorque(const particle &part1, const particle &part2) const {
 
         // Calculate relative position
         std::array<vec3<double>, 2> relPos = relativePositionComplete(part1.position, part2.position);
@@ -167,8 +174,8 @@ namespace msmrd {
         auto force = (repulsiveForceNorm + attractiveForceNorm)*rvec/rvec.norm();
 
         /* Assign patch pattern depending on particle type (note only two types of particles are supported here) */
-        auto patchesCoords1 = assignPatches(part1.type);
-        auto patchesCoords2 = assignPatches(part2.type);
+        auto &patchesCoords1 = assignPatches(part1.type);
+        auto &patchesCoords2 = assignPatches(part2.type);
 
         // Calculate forces and torque due to patches interaction if particles are close enough
         if (rvec.norm() <= 2*sigma and patchesActive) {
@@ -186,10 +193,10 @@ namespace msmrd {
     }
 
     /* Auxiliary function that calculates patches interaction forces. Called by main forceTorque function. */
-    std::array<vec3<double>, 4> patchyProtein::forceTorquePatches(particle &part1, particle &part2,
+    std::array<vec3<double>, 4> patchyProtein::forceTorquePatches(const particle &part1, const particle &part2,
                                                                   vec3<double> &pos1virtual,
-                                                                  std::vector<vec3<double>> &patchesCoords1,
-                                                                  std::vector<vec3<double>> &patchesCoords2){
+                                                                  const std::vector<vec3<double>> &patchesCoords1,
+                                                                  const std::vector<vec3<double>> &patchesCoords2) const {
         // Initialize forceas and torques due to patches
         vec3<double> force1 = vec3<double> (0.0, 0.0, 0.0);
         vec3<double> force2 = vec3<double> (0.0, 0.0, 0.0);
@@ -205,15 +212,19 @@ namespace msmrd {
         vec3<double> patchNormal2;
         vec3<double> rpatch;
 
+        // Unitary rotated patches (from cache if available)
+        std::vector<vec3<double>> buffer1;
+        std::vector<vec3<double>> buffer2;
+        auto patchNormals1 = patchFrames.getPatchNormals(part1, patchesCoords1, true, buffer1);
+        auto patchNormals2 = patchFrames.getPatchNormals(part2, patchesCoords2, true, buffer2);
+
         // Loop over all patches of particle 1
         for (int i = 0; i < patchesCoords1.size(); i++) {
-            patchNormal1 = msmrdtools::rotateVec(patchesCoords1[i], part1.orientation);
-            patchNormal1 = patchNormal1 / patchNormal1.norm();
+            patchNormal1 = patchNormals1[i];
             patch1 = pos1virtual + 0.5 * sigma * patchNormal1;
             // Loop over all patches of particle 2
             for (int j = 0; j < patchesCoords2.size(); j++) {
-                patchNormal2 = msmrdtools::rotateVec(patchesCoords2[j], part2.orientation);
-                patchNormal2 = patchNormal2 / patchNormal2.norm();
+                patchNormal2 = patchNormals2[j];
                 patch2 = part2.position + 0.5 * sigma * patchNormal2;
                 // Calculate distance between the two patches
                 rpatch = patch2 - patch1;
@@ -246,12 +257,40 @@ namespace msmrd {
     };
 
 
+    // Rotates the patches of all the particles once per time step (see patchFrameCache)
+    void patchyProtein::precompute(const std::vector<particle> &parts) {
+        patchFrames.update(parts, [this](const particle &part) -> const std::vector<vec3<double>> & {
+            return assignPatches(part.type);
+        });
+    }
+
+
+    /* Slow part of the interaction: the soft isotropic repulsive and attractive potentials (same as in
+     * patchyParticle). Child classes with additional terms add them to the fast part. */
+    std::array<vec3<double>, 4> patchyProtein::forceTorqueSlow(const particle &part1, const particle &part2) const {
+        vec3<double> rvec = relativePosition(part1.position, part2.position);
+        auto forceNorm = derivativeQuadraticPotential(rvec.norm(), sigma, epsRepulsive, aRepulsive, rstarRepulsive) +
+                derivativeQuadraticPotential(rvec.norm(), sigma, epsAttractive, aAttractive, rstarAttractive);
+        return centralForceTorque(rvec, forceNorm);
+    }
+
+    // Fast part of the interaction: the stiff patches interactions only.
+    std::array<vec3<double>, 4> patchyProtein::forceTorqueFast(const particle &part1, const particle &part2) const {
+        std::array<vec3<double>, 2> relPos = relativePositionComplete(part1.position, part2.position);
+        if (relPos[1].norm() <= 2*sigma and patchesActive) {
+            return forceTorquePatches(part1, part2, relPos[0], assignPatches(part1.type), assignPatches(part2.type));
+        }
+        auto zero = vec3<double> (0.0, 0.0, 0.0);
+        return {zero, zero, zero, zero};
+    }
+
+
     /* Custom quadratic potential (same functions as in patchy particle, inheritance was not an option :( ):
      * @param r is distance between particles or  patches,
      * @param eps strength of the potential
      * @param rstar distance to switch to second potential function
      * @param a the stiffness, together with rstar determines the range of the potential */
-    double patchyProtein::quadraticPotential(double r, double sig, double eps, double a, double rstar) {
+    double patchyProtein::quadraticPotential(double r, double sig, double eps, double a, double rstar) const {
         // Parameters to force continuity and continuous derivative
         double rcritical = std::pow(sig, 2)/(a*rstar);
         double b = (1.0 - a*std::pow(rstar/sig, 2))/std::pow(rcritical/sig - rstar/sig, 2);
@@ -268,7 +307,8 @@ namespace msmrd {
     }
 
     // Derivative of patchyProtein::quadraticPotential
-    double patchyProtein::derivativeQuadraticPotential(double r, double sig, double eps, double a, double rstar) {
+    double patchyProtein::derivativeQuadraticPotential(double r, double sig, double eps, double a,
+                                                       double rstar) const {
         // Parameters to force continuity and continuous derivative
         double rcritical = std::pow(sig, 2)/(a*rstar);
         double b = (1.0 - a*std::pow(rstar/sig, 2))/std::pow(rcritical/sig - rstar/sig, 2);
@@ -284,8 +324,15 @@ namespace msmrd {
         }
     }
 
+    // Interaction range, analogous to patchyParticle::getCutOff (both patch types only act for r <= 2 sigma).
+    double patchyProtein::getCutOff() const {
+        double rcriticalRepulsive = std::pow(sigma, 2)/(aRepulsive*rstarRepulsive);
+        double rcriticalAttractive = std::pow(sigma, 2)/(aAttractive*rstarAttractive);
+        return std::max({2*sigma, rcriticalRepulsive, rcriticalAttractive});
+    }
+
     // Assign pacthes coordinates in terms of particle type
-    std::vector<vec3<double>> patchyProtein::assignPatches(int type) {
+    const std::vector<vec3<double>> &patchyProtein::assignPatches(int type) const {
         if (type == 0) {
             return patchesCoordinatesA;
         }
@@ -94,7 +94,7 @@ namespace msmrd{
 
 
     // Evaluates potential at given positions and orientations of two particles
-    double patchyProteinMarkovSwitch::evaluate(particle &part1, particle &part2) {
+    double patchyProteinMarkovSwitch::evaluate(const particle &part1, const particle &part2) const {
         // Declare variables used in loop
         double patchesPotential = 0.0;
         double angularPotential = 0.0;
@@ -109,8 +109,8 @@ namespace msmrd{
         auto attractivePotential = quadraticPotential(rvec.norm(), sigma, epsAttractive, aAttractive, rstarAttractive);
 
         /* Assign patch pattern depending on particle type (note only two types of particles are supported here) */
-        auto patchesCoords1 = assignPatches(part1.type);
-        auto patchesCoords2 = assignPatches(part2.type);
+        auto &patchesCoords1 = assignPatches(part1.type);
+        auto &patchesCoords2 = assignPatches(part2.type);
 
         // Evaluate patches potential if close enough and if particle 2 is in state 0
         if (rvec.norm() <= minimumR and part2.state == 0 and patchesActive) {
@@ -130,8 +130,18 @@ namespace msmrd{
     }
 
     /* Calculate and return (force1, torque1, force2, torque2), which correspond to the force and torque
-     * acting on particle1 and the force and torque acting on particle2, respectively. */
-    std::array<vec3<double>, 4> patchyProteinMarkovSwitch::forceTorque(particle &part1, particle &part2)  {
+     * acting on particle1 and the force and torque acting on particle2, respectively. It is the sum of the
+     * isotropic part (slow, see patchyProtein) and the patches and angular part (fast). */
+    std::array<vec3<double>, 4> patchyProteinMarkovSwitch::forceTorque(const particle &part1,
+                                                                       const particle &part2) const {
+        return addForceTorques(forceTorqueSlow(part1, part2),
+                               patchyProteinMarkovSwitch::forceTorqueFast(part1, part2));
+    }
+
+    /* Fast part of the interaction: the patches interactions and the explicit angular dependence, only if the
+     * particles are close enough and particle 2 is in state 0. */
+    std::array<vec3<double>, 4> patchyProteinMarkovSwitch::forceTorqueFast(const particle &part1,
+                                                                           const particle &part2) const {
 
         // Calculate relative position
         std::array<vec3<double>, 2> relPos = relativePositionComplete(part1.position, part2.position);
@@ -141,22 +151,14 @@ namespace msmrd{
         // // Calculate relative orientation
         // auto relOrientation = part2.orientation * part1.orientation.conj();
 
-        /* Calculate and add forces due to repulsive and attractive isotropic potentials.
-         *  Note correct sign/direction of force given by rvec/rvec.norm*() */
-        auto repulsiveForceNorm = derivativeQuadraticPotential(rvec.norm(), sigma, epsRepulsive,
-                                                               aRepulsive, rstarRepulsive);
-        auto attractiveForceNorm = derivativeQuadraticPotential(rvec.norm(), sigma, epsAttractive,
-                                                                aAttractive, rstarAttractive);
-
-        auto force = (repulsiveForceNorm + attractiveForceNorm)*rvec/rvec.norm();
-
         /* Assign patch pattern depending on particle type (note only two types of particles are supported here) */
-        auto patchesCoords1 = assignPatches(part1.type);
-        auto patchesCoords2 = assignPatches(part2.type);
+        auto &patchesCoords1 = assignPatches(part1.type);
+        auto &patchesCoords2 = assignPatches(part2.type);
 
         /* Enables/Disables MSM following potential hardcoded rules. In this case, if bounded or close to bounded
          * disable and reset the MSM on particle2 when it is on state 0. This is not used for the MSM/RD example, but
-         * it is left for possible future implementations. */
+         * it is left for possible future implementations. Since forceTorque cannot modify the particles (it may be
+         * called concurrently), it would need to be called by the integrator outside the force calculation. */
         //enableDisableMSM(rvec, part1, part2);
 
         // Check if particle is in any of the bound states. Not in use, left here for possible future implementations
@@ -190,10 +192,10 @@ namespace msmrd{
             torque1 += derivativeAngluarPotential; // Plus sign since plane1 x plane2 defined torque in particle 1
             torque2 -= derivativeAngluarPotential;
 
-            return {force + force1, torque1, -1.0*force + force2, torque2};
+            return {force1, torque1, force2, torque2};
         } else {
-            auto zeroTorque = vec3<double> (0.0, 0.0, 0.0);
-            return {force, zeroTorque, -1.0 * force, zeroTorque};
+            auto zero = vec3<double> (0.0, 0.0, 0.0);
+            return {zero, zero, zero, zero};
         }
     }
 
@@ -201,28 +203,25 @@ namespace msmrd{
     /* Given two quaternions/orientations, returns planes(unit vectors) to be aligned by torque. These
      * may vary depending on the physical arrangement of your molecules and how the patches are ordered and
      * selected. Currently set up for particle 1 with 6 binding patches and particle 2 only with one.*/
-    std::tuple<vec3<double>, vec3<double>> patchyProteinMarkovSwitch::calculatePlanes(particle &part1,
-                                                                 particle &part2,
-                                                                 const std::vector<vec3<double>> patches1,
-                                                                 const std::vector<vec3<double>> patches2) {
-
-        std::vector<vec3<double>> part1PatchNormals;
-        std::vector<vec3<double>> part2PatchNormals;
-        for (auto &patch : patches1) {
-            part1PatchNormals.push_back(msmrdtools::rotateVec(patch, part1.orientation));
-        }
-        for (auto &patch : patches2) {
-            part2PatchNormals.push_back(msmrdtools::rotateVec(patch, part2.orientation));
-        }
+    std::tuple<vec3<double>, vec3<double>> patchyProteinMarkovSwitch::calculatePlanes(const particle &part1,
+                                                                 const particle &part2,
+                                                                 const std::vector<vec3<double>> &patches1,
+                                                                 const std::vector<vec3<double>> &patches2) const {
+
+        // Rotated patches (from cache if available)
+        std::vector<vec3<double>> buffer1;
+        std::vector<vec3<double>> buffer2;
+        auto part1PatchNormals = patchFrames.getPatchNormals(part1, patches1, false, buffer1);
+        auto part2PatchNormals = patchFrames.getPatchNormals(part2, patches2, false, buffer2);
 
         // Calculate positions of patches
         std::vector<vec3<double>> part1PatchPositions;
         std::vector<vec3<double>> part2PatchPositions;
-        for(auto &patchNormal : part1PatchNormals) {
-            part1PatchPositions.push_back(part1.position + 0.5*sigma * patchNormal);
+        for (int i = 0; i < patches1.size(); i++) {
+            part1PatchPositions.push_back(part1.position + 0.5*sigma * part1PatchNormals[i]);
         }
-        for(auto &patchNormal : part2PatchNormals) {
-            part2PatchPositions.push_back(part2.position + 0.5*sigma * patchNormal);
+        for (int i = 0; i < patches2.size(); i++) {
+            part2PatchPositions.push_back(part2.position + 0.5*sigma * part2PatchNormals[i]);
         }
 
 
@@ -11,43 +11,41 @@ namespace msmrd {
 
 
     /* Force Torque for binding functions */
-    std::vector<std::vector<double>> externalPotential::forceTorquePyBind(particle &part) {
+    std::vector<std::vector<double>> externalPotential::forceTorquePyBind(const particle &part) const {
         std::array<vec3<double>, 2> forceTorquex = forceTorque(part);
         return msmrdtools::array2Dtovec2D(forceTorquex);
     }
 
-    std::vector<std::vector<double>> pairPotential::forceTorquePyBind(particle &part1, particle &part2) {
+    std::vector<std::vector<double>> pairPotential::forceTorquePyBind(const particle &part1,
+                                                                      const particle &part2) const {
         std::array<vec3<double>, 4> forceTorquex = forceTorque(part1, part2);
         return msmrdtools::array2Dtovec2D(forceTorquex);
     }
 
+    // Default fast part of the interaction (none, see forceTorqueSlow)
+    std::array<vec3<double>, 4> pairPotential::forceTorqueFast(const particle &part1, const particle &part2) const {
+        auto zero = vec3<double>(0.0, 0.0, 0.0);
+        return {zero, zero, zero, zero};
+    }
+
+    // Central force along rvec (pos2 - pos1) without torques, see forceTorqueSlow of the patchy potentials
+    std::array<vec3<double>, 4> pairPotential::centralForceTorque(vec3<double> rvec, double forceNorm) {
+        auto force = forceNorm*rvec/rvec.norm();
+        auto zeroTorque = vec3<double>(0.0, 0.0, 0.0);
+        return {force, zeroTorque, -1.0*force, zeroTorque};
+    }
+
+    std::array<vec3<double>, 4> pairPotential::addForceTorques(const std::array<vec3<double>, 4> &forceTorque1,
+                                                               const std::array<vec3<double>, 4> &forceTorque2) {
+        return {forceTorque1[0] + forceTorque2[0], forceTorque1[1] + forceTorque2[1],
+                forceTorque1[2] + forceTorque2[2], forceTorque1[3] + forceTorque2[3]};
+    }
+
     // Incorporates integrator's boundary into potential
     void pairPotential::setBoundary(boundary *bndry) {
         boundaryActive = true;
         domainBoundary = bndry;
+        periodicBoundary = bndry->getBoundaryType() == "periodic";
     }
 
-    // Calculates relative distance (p2-p1) of two vectors, p1, p2, taking into account possible periodic boundary
-    vec3<double> pairPotential::relativePosition(const vec3<double> p1, const vec3<double> p2) {
-        // Calculate relative distance. If box periodic boundary, take that into account.
-        if (boundaryActive and domainBoundary->getBoundaryType() == "periodic") {
-            auto boxsize = domainBoundary->boxsize;
-            return msmrdtools::distancePeriodicBox(p1, p2, boxsize);
-        } else {
-            return p2 - p1;
-        }
-    };
-
-    /* Calculates relative distance (p2-p1) of two vectors, p1, p2, taking into account possible periodic boundary and
-     * returns virtual position of p1 as well as the relative distance */
-    std::array<vec3<double>, 2> pairPotential::relativePositionComplete(vec3<double> p1, vec3<double> p2){
-        // Calculate relative distance. If box periodic boundary, take that into account.
-        if (boundaryActive and domainBoundary->getBoundaryType() == "periodic") {
-            vec3<double> boxsize = domainBoundary->boxsize;
-            return msmrdtools::distancePeriodicBoxComplete(p1, p2, boxsize);
-        } else {
-            return {p1, p2 - p1};
-        }
-    };
-
 }
\ No newline at end of file
@@ -2,29 +2,138 @@
 // Created by maojrs on 7/25/18.
 //
 #include <math.h>
+#include <limits>
+#include <stdexcept>
 #include "randomgen.hpp"
 #include "vec3.hpp"
 
 namespace msmrd {
     /**
-     *  Implementation of random number generator class functions (constructor in header)
+     *  Implementation of Philox4x32-10 counter-based random number engine
      */
 
-    // Sets seed for random generator mt19937_64
+    // Sets key from seed (lower and upper 32 bits) and restarts the counter
+    void philox4x32::setKey(uint64_t seed) {
+        key = {{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}};
+        setCounter(0, 0, 0);
+    }
+
+    // Selects substream; the draw index (first word of the counter) starts again from zero
+    void philox4x32::setCounter(uint32_t replicaID, uint32_t particleID, uint32_t step) {
+        counter = {{0, particleID, step, replicaID}};
+        blockPosition = 4;
+    }
+
+    // Ten rounds of the Philox bijection of the 128 bit counter under the 64 bit key
+    std::array<uint32_t, 4> philox4x32::bijection(std::array<uint32_t, 4> ctr, std::array<uint32_t, 2> k) {
+        const uint64_t multiplier0 = 0xD2511F53;
+        const uint64_t multiplier1 = 0xCD9E8D57;
+        const uint32_t weyl0 = 0x9E3779B9;
+        const uint32_t weyl1 = 0xBB67AE85;
+        for (int round = 0; round < 10; round++) {
+            uint64_t product0 = multiplier0 * ctr[0];
+            uint64_t product1 = multiplier1 * ctr[2];
+            ctr = {{static_cast<uint32_t>(product1 >> 32) ^ ctr[1] ^ k[0], static_cast<uint32_t>(product1),
+                    static_cast<uint32_t>(product0 >> 32) ^ ctr[3] ^ k[1], static_cast<uint32_t>(product0)}};
+            k[0] += weyl0;
+            k[1] += weyl1;
+        }
+        return ctr;
+    }
+
+    void philox4x32::generateBlock() {
+        block = bijection(counter, key);
+        counter[0]++;
+        blockPosition = 0;
+    }
+
+    // Returns 64 bits, made of two consecutive words of the current block
+    philox4x32::result_type philox4x32::operator()() {
+        if (blockPosition >= 4) {
+            generateBlock();
+        }
+        uint64_t result = (static_cast<uint64_t>(block[blockPosition]) << 32) | block[blockPosition + 1];
+        blockPosition += 2;
+        return result;
+    }
+
+
+    /**
+     *  Implementation of random number generator class functions
+     */
+
+    // Copy constructor, see header for seed semantics
+    randomgen::randomgen(const randomgen &other) {
+        *this = other;
+    }
+
+    randomgen &randomgen::operator=(const randomgen &other) {
+        seed = other.seed;
+        backend = other.backend;
+        counterBased = other.counterBased;
+        replicaID = other.replicaID;
+        hasSpareNormal = other.hasSpareNormal;
+        spareNormal = other.spareNormal;
+        if (seed >= 0) {
+            mt_rand = other.mt_rand;
+            philox_rand = other.philox_rand;
+        } else {
+            setSeed(seed);
+        }
+        return *this;
+    }
+
+    void randomgen::seedEngines(uint64_t engineSeed) {
+        mt_rand = std::mt19937_64(engineSeed);
+        philox_rand.setKey(engineSeed);
+        philox_rand.setCounter(static_cast<uint32_t>(replicaID), 0, 0);
+        hasSpareNormal = false;
+    }
+
+    /* Sets seed for random generators. seed = -1 uses a random device seed and seed < -1 a random device
+     * seed multiplied by -seed (both non-reproducible); seed >= 0 is a fixed seed. */
     void randomgen::setSeed(long newseed) {
+        seed = newseed;
         if (newseed == -1) {
-            mt_rand = std::mt19937_64(rd()); //random device seed
+            seedEngines(std::random_device()()); //random device seed
         } else if (newseed < -1) {
-            mt_rand = std::mt19937_64(-newseed*rd()); //random device and time used as random seed
+            seedEngines(-newseed*std::random_device()()); //random device scaled by seed used as random seed
         } else {
-            mt_rand = std::mt19937_64(newseed); //fixed seed
+            seedEngines(newseed); //fixed seed
         }
     };
 
+    // Selects random number generator, "mt19937" (default) or "philox" (counter-based)
+    void randomgen::setBackend(std::string newbackend) {
+        if (newbackend != "mt19937" and newbackend != "philox") {
+            throw std::invalid_argument("Unknown random number generator " + newbackend +
+                                        ", available generators are mt19937 and philox");
+        }
+        backend = newbackend;
+        counterBased = newbackend == "philox";
+    }
+
+    // Sets replica key of the counter-based generator, so ensemble members with the same seed are independent
+    void randomgen::setReplicaID(long newreplicaID) {
+        replicaID = newreplicaID;
+        philox_rand.setCounter(static_cast<uint32_t>(replicaID), 0, 0);
+        hasSpareNormal = false;
+    }
+
+    /* Selects the substream of the counter-based generator given by the particle id and time step. The numbers
+     * drawn afterwards are fully determined by (seed, replica id, particle id, step). Does nothing for the
+     * sequential mt19937 generator. */
+    void randomgen::setSubstream(long particleID, long step) {
+        if (counterBased) {
+            philox_rand.setCounter(static_cast<uint32_t>(replicaID), static_cast<uint32_t>(particleID),
+                                   static_cast<uint32_t>(step));
+            hasSpareNormal = false;
+        }
+    }
+
     // Returns random number between rmin and rmax sampled uniformly [rmin,rmax)
     double randomgen::uniformRange(double rmin, double rmax) {
-        std::uniform_real_distribution<double> uniform(rmin, rmax);
-        return uniform(mt_rand);
+        return rmin + (rmax - rmin) * uniform01();
     };
 
     int randomgen::uniformInteger(int imin, int imax) {
@@ -32,20 +141,76 @@ namespace msmrd {
         return (int) std::floor(value);
     };
 
+    void randomgen::fillUniform01(double *buffer, size_t numSamples) {
+        for (size_t i = 0; i < numSamples; i++) {
+            buffer[i] = uniform01();
+        }
+    }
+
+    // Standard normal sample, the Box-Muller transform generates two, the second one is kept for the next call
+    double randomgen::standardNormal() {
+        if (hasSpareNormal) {
+            hasSpareNormal = false;
+            return spareNormal;
+        }
+        double radius = std::sqrt(-2.0 * std::log(1.0 - uniform01()));
+        double angle = 2.0 * M_PI * uniform01();
+        spareNormal = radius * std::sin(angle);
+        hasSpareNormal = true;
+        return radius * std::cos(angle);
+    }
 
     // Returns random number sampled from normal distribution with given mean and standard deviation
     double randomgen::normal(double mean, double stddev) {
-        std::normal_distribution<double> normaldist(mean, stddev);
-        return normaldist(mt_rand);
+        return mean + stddev * standardNormal();
+    };
+
+    /* Returns random number sampled from exponential distribution with given rate by inversion, with one uniform
+     * sample in (0,1]. A zero rate yields infinity. */
+    double randomgen::exponential(double rate) {
+        if (rate <= 0) {
+            return std::numeric_limits<double>::infinity();
+        }
+        return -std::log(1.0 - uniform01()) / rate;
     };
 
+    // Fills buffer with numSamples random numbers sampled uniformly in [rmin,rmax)
+    void randomgen::fillUniform(double *buffer, size_t numSamples, double rmin, double rmax) {
+        fillUniform01(buffer, numSamples);
+        for (size_t i = 0; i < numSamples; i++) {
+            buffer[i] = rmin + (rmax - rmin) * buffer[i];
+        }
+    }
+
+    /* Fills buffer with numSamples normal random numbers. The uniform samples are drawn first and then
+     * transformed pairwise (Box-Muller) in a separate loop without branches, so the compiler can vectorize
+     * it. The sequence of samples is the same as the one obtained by calling normal numSamples times. */
+    void randomgen::fillNormal(double *buffer, size_t numSamples, double mean, double stddev) {
+        size_t first = 0;
+        if (numSamples > 0 and hasSpareNormal) {
+            buffer[0] = mean + stddev * standardNormal();
+            first = 1;
+        }
+        size_t numPairs = (numSamples - first) / 2;
+        double *pairs = buffer + first;
+        fillUniform01(pairs, 2 * numPairs);
+        for (size_t i = 0; i < numPairs; i++) {
+            double radius = std::sqrt(-2.0 * std::log(1.0 - pairs[2 * i]));
+            double angle = 2.0 * M_PI * pairs[2 * i + 1];
+            pairs[2 * i] = mean + stddev * radius * std::cos(angle);
+            pairs[2 * i + 1] = mean + stddev * radius * std::sin(angle);
+        }
+        if (first + 2 * numPairs < numSamples) {
+            buffer[numSamples - 1] = mean + stddev * standardNormal();
+        }
+    }
+
     // Returns random 3D vector sampled from 3D normal distribution with given mean and standard deviation
     vec3<double> randomgen::normal3D(double mean, double stddev) {
         vec3<double> randvec;
-        std::normal_distribution<double> normaldist(mean, stddev);
-        randvec[0] = normaldist(mt_rand);
-        randvec[1] = normaldist(mt_rand);
-        randvec[2] = normaldist(mt_rand);
+        randvec[0] = mean + stddev * standardNormal();
+        randvec[1] = mean + stddev * standardNormal();
+        randvec[2] = mean + stddev * standardNormal();
         return randvec;
     };
 
@@ -91,38 +91,6 @@ namespace msmrdtools {
         return std::min(relangle.norm(), relangle2.norm());
     }
 
-    // Calculates relative distance (p2-p1) of two vectors (p1, p2) in a periodic box, returns relative distance.
-    vec3<double> distancePeriodicBox(const vec3<double> p1, const vec3<double> p2, const vec3<double> edgeslength) {
-        vec3<double> p1Periodic = 1.0*p1;
-        // Loop over three coordinates (x,y,z)
-        for (int i = 0; i < 3; i++){
-            if ( (p2[i] - p1[i]) > 0.5*edgeslength[i]) {
-                p1Periodic[i] += edgeslength[i];
-            }
-            if ( (p2[i] - p1[i]) < -0.5*edgeslength[i]) {
-                p1Periodic[i] -= edgeslength[i];
-            }
-        }
-        return p2 - p1Periodic;
-    }
-
-    /* Calculates relative distance (p2-p1) of two vectors (p1, p2) in a periodic box, returns tuple with
-     * "virtual" position of p1 as first entry and relative distance as second entry */
-    std::array<vec3<double>, 2> distancePeriodicBoxComplete(const vec3<double> p1, const vec3<double> p2,
-                                                            const vec3<double> edgeslength) {
-        vec3<double> p1Periodic = 1.0*p1;
-        // Loop over three coordinates (x,y,z)
-        for (int i = 0; i < 3; i++){
-            if (p2[i] - p1[i] > 0.5*edgeslength[i]) {
-                p1Periodic[i] += edgeslength[i];
-            }
-            if (p2[i] - p1[i] < -0.5*edgeslength[i]) {
-                p1Periodic[i] -= edgeslength[i];
-            }
-        }
-        return {p1Periodic, p2 - p1Periodic};
-    }
-
     // Calculates relative position between two particles taking into account possible periodic boundary.
     vec3<double> calculateRelativePosition(const vec3<double> pos1, const vec3<double> pos2, const bool boundaryActive,
                                            const std::string boundaryType, const vec3<double> boxsize){
@@ -100,29 +100,18 @@ namespace msmrd {
      * the particle 2 state to choose a discrete state. It assumes particle can only bind, while particle 2
      * is in state 0. The previous implementation assumes the behavior of particle's 2 state is averaged by
      * the MSM. */
-    int patchyProteinTrajectory2::sampleDiscreteState(particle part1, particle part2) {
+    int patchyProteinTrajectory2::sampleDiscreteStateRelative(const vec3<double> &relativePosition,
+                                                              const quaternion<double> &relativeOrientation,
+                                                              int state1, int state2) {
         // Initialize sample with value zero (unbound state)
         int discreteState = 0;
-
-        /* Calculate relative position taking into account periodic boundary measured
-         * from i to j (gets you from i to j). */
-        vec3<double> relativePosition = calculateRelativePosition(part1.position, part2.position);
-
-        // Rotate relative position to match the reference orientation of particle 1. (VERY IMPORTANT)
-        relativePosition = msmrdtools::rotateVec(relativePosition, part1.orientation.conj());
-        quaternion<double> quatReference = {1,0,0,0}; // we can then define reference quaternion as identity.
-
-        // Calculate relative orientation (w/respect to particle 1)
-        quaternion<double> relativeOrientation;
-        //relativeOrientation = part1.orientation.conj() * part2.orientation;
-        relativeOrientation =  part2.orientation * part1.orientation.conj();
-
+        quaternion<double> quatReference = {1,0,0,0}; // Relative position is in the frame of particle 1.
 
         // Extract current state, save into sample and return sample
         int secNum;
         if (relativePosition.norm() < rLowerBound) {
             // Only sample bound states if part2 is in state 0.
-            if (part2.state == 0) {
+            if (state2 == 0) {
                 discreteState = getBoundState(relativePosition, relativeOrientation);
             } else{
                 // Returns -1 so functions in discretizeTrajectory can usbstitute with prevsample if using coreMSM.
@@ -132,7 +121,7 @@ namespace msmrd {
             // Get corresponding section numbers from spherical partition to classify its state
             secNum = positionOrientationPart->getSectionNumber(relativePosition, relativeOrientation, quatReference);
             // Take into account the state of particle 2 to define state numbering
-            secNum += part2.state * positionOrientationPart->numTotalSections;
+            secNum += state2 * positionOrientationPart->numTotalSections;
             // Make sure bound states and transitions states correspond to different numbers
             discreteState  = maxNumberBoundStates + secNum;
         }
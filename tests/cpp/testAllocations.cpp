@@ -0,0 +1,73 @@
+//
+// Created by maojrs on 3/16/20.
+//
+#define CATCH_CONFIG_MAIN  // Separate executable, since it replaces the global operator new
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <catch2/catch.hpp>
+#include "integrators/overdampedLangevinMarkovSwitch.hpp"
+#include "boundaries/box.hpp"
+#include "particle.hpp"
+#include "randomgen.hpp"
+
+using namespace msmrd;
+using ctmsm = msmrd::continuousTimeMarkovStateModel;
+
+/* Counts the heap allocations of this executable, to check the integrators don't allocate memory in steady-state
+ * time steps. It is built apart from test_executable, so the other tests keep the default allocator. */
+namespace {
+    std::atomic<long> numHeapAllocations(0);
+}
+
+void *operator new(std::size_t size) {
+    numHeapAllocations++;
+    if (void *pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+
+TEST_CASE("Steady-state Markov switch time steps don't allocate", "[overdampedLangevinMarkovSwitch]") {
+    std::vector<std::vector<double>> tmatrix = {{-2.0, 2.0}, {3.0, -3.0}};
+    auto tmsm = ctmsm(0, tmatrix, 7);
+    std::vector<double> Dlist = {1.0, 0.1};
+    std::vector<double> Drotlist = {1.0, 0.1};
+    tmsm.setD(Dlist);
+    tmsm.setDrot(Drotlist);
+    double boxsize = 5.0;
+    auto boundary = box(boxsize, boxsize, boxsize, "periodic");
+    randomgen randg;
+    randg.setSeed(19);
+    std::vector<particle> plist;
+    for (int i = 0; i < 50; i++) {
+        auto position = vec3<double> {randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                      randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                      randg.uniformRange(-0.5*boxsize, 0.5*boxsize)};
+        plist.push_back(particle(0, i % 2, Dlist[i % 2], Drotlist[i % 2], position, quaternion<double>(1, 0, 0, 0)));
+    }
+
+    // Step by step and event driven switching, the first time step sets up the buffers
+    for (bool eventDriven : {false, true}) {
+        auto integ = overdampedLangevinMarkovSwitch<ctmsm>(tmsm, 0.01, 23, "point");
+        integ.setBoundary(&boundary);
+        integ.setEventDrivenSwitching(eventDriven);
+        integ.integrate(plist);
+        long numAllocations = 0;
+        for (int step = 0; step < 500; step++) {
+            auto allocationsBefore = numHeapAllocations.load();
+            integ.integrate(plist);
+            numAllocations += numHeapAllocations.load() - allocationsBefore;
+        }
+        REQUIRE(numAllocations == 0);
+    }
+}
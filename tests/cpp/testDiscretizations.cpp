@@ -6,6 +6,7 @@
 #include "discretizations/halfSpherePartition.hpp"
 #include "discretizations/quaternionPartition.hpp"
 #include "discretizations/positionOrientationPartition.hpp"
+#include "randomgen.hpp"
 #include "tools.hpp"
 
 using namespace msmrd;
@@ -323,3 +324,74 @@ TEST_CASE("position orientation partition", "[positionOrientationPartition]") {
     auto numTotalSecs = positionOrientationPart->numTotalSections;
     REQUIRE(numTotalSecs == 203);
 }
+
+
+TEST_CASE("Lookup table of spherical partition", "[spherePartition]") {
+    randomgen randg;
+    randg.setSeed(1234);
+    // Compare sections with and without lookup table for random directions (the half sphere only for y >= 0)
+    std::vector<std::shared_ptr<spherePartition>> partitions{std::make_shared<spherePartition>(15),
+                                                             std::make_shared<spherePartition>(2),
+                                                             std::make_shared<spherePartition>(40),
+                                                             std::make_shared<halfSpherePartition>(15)};
+    for (auto &partition : partitions) {
+        auto reference = *partition;
+        partition->setLookupTable(64);
+        REQUIRE(partition->getLookupTableResolution() == 64);
+        REQUIRE(partition->getLookupTableCoverage() > 0.8);
+        for (int i = 0; i < 20000; i++) {
+            auto direction = randg.normal3D(0.0, 1.0);
+            if (partition->scaling == 2) {
+                direction[1] = std::abs(direction[1]);
+            }
+            int secNum = partition->getSectionNumber(direction);
+            REQUIRE(secNum == reference.getSectionNumber(direction));
+            // Section of direction must contain its polar angle
+            auto phiInterval = std::get<0>(partition->getAngles(secNum));
+            double phi = std::acos(direction[2] / direction.norm());
+            REQUIRE(phiInterval[0] <= phi);
+            REQUIRE(phi <= phiInterval[1]);
+        }
+        // Directions on the cuts between sections
+        for (int collar = 1; collar < partition->phis.size(); collar++) {
+            for (int j = 0; j < 100; j++) {
+                double phi = partition->phis[collar];
+                double theta = M_PI * j / 50.0 / partition->scaling;
+                vec3<double> direction{std::sin(phi) * std::cos(theta), std::sin(phi) * std::sin(theta),
+                                       std::cos(phi)};
+                REQUIRE(partition->getSectionNumber(direction) == reference.getSectionNumber(direction));
+            }
+        }
+    }
+
+    // Lookup table must be updated when offsetting thetas
+    auto spherePart = spherePartition(15);
+    spherePart.setLookupTable(32);
+    spherePart.setThetasOffset(0.3);
+    auto reference = spherePartition(15);
+    reference.setThetasOffset(0.3);
+    for (int i = 0; i < 20000; i++) {
+        auto direction = randg.normal3D(0.0, 1.0);
+        REQUIRE(spherePart.getSectionNumber(direction) == reference.getSectionNumber(direction));
+    }
+    spherePart.setLookupTable(0);
+    REQUIRE(spherePart.getLookupTableCoverage() == 0.0);
+    REQUIRE_THROWS(spherePart.setLookupTable(-1));
+
+    // Quaternion and position orientation partitions with and without lookup tables
+    auto quatPartition = quaternionPartition(5, 15);
+    auto quatReference = quaternionPartition(5, 15);
+    quatPartition.setLookupTable(64);
+    auto positionOrientationPart = positionOrientationPartition(2.2, 7, 5, 7);
+    auto positionOrientationReference = positionOrientationPartition(2.2, 7, 5, 7);
+    positionOrientationPart.setLookupTable(64);
+    for (int i = 0; i < 20000; i++) {
+        quaternion<double> quat{randg.normal(0, 1), randg.normal(0, 1), randg.normal(0, 1), randg.normal(0, 1)};
+        quat = quat / quat.norm();
+        quaternion<double> quatVolume = randg.uniformRange(0, 1) * quat;
+        REQUIRE(quatPartition.getSectionNumber(quatVolume) == quatReference.getSectionNumber(quatVolume));
+        auto relativePosition = randg.uniformSphere(2.0);
+        REQUIRE(positionOrientationPart.getSectionNumber(relativePosition, quat) ==
+                positionOrientationReference.getSectionNumber(relativePosition, quat));
+    }
+}
@@ -2,19 +2,35 @@
 // Created by maojrs on 6/4/19.
 //
 
+#include <algorithm>
+#include <set>
 #include <catch2/catch.hpp>
 #include "integrators/msmrdIntegrator.hpp"
 #include "integrators/msmrdMultiParticleIntegrator.hpp"
+#include "integrators/overdampedLangevin.hpp"
+#include "integrators/overdampedLangevinEngine.hpp"
+#include "integrators/overdampedLangevinMarkovSwitch.hpp"
+#include "integrators/overdampedLangevinMTS.hpp"
+#include "integrators/overdampedLangevinSelective.hpp"
 #include "boundaries/box.hpp"
+#include "ensembleRunner.hpp"
+#include "firstPassage.hpp"
 #include "discretizations/positionOrientationPartition.hpp"
 #include "markovModels/msmrdMarkovModel.hpp"
+#include "neighborList.hpp"
 #include "particle.hpp"
+#include "particleSoA.hpp"
+#include "potentials/harmonicRepulsion.hpp"
+#include "potentials/patchyParticleAngular.hpp"
+#include "potentials/patchyProteinMarkovSwitch.hpp"
+#include "trajectories/discrete/patchyDimerTrajectory.hpp"
 #include "quaternion.hpp"
 #include "randomgen.hpp"
 #include "tools.hpp"
 #include "vec3.hpp"
 
 using namespace msmrd;
+
 using msm = msmrd::discreteTimeMarkovStateModel;
 using ctmsm = msmrd::continuousTimeMarkovStateModel;
 
@@ -98,6 +114,88 @@ TEST_CASE("Initialization of MSMRD integrator class", "[msmrdIntegrator]") {
     REQUIRE(thetas[0] == thetasRef);
 }
 
+TEST_CASE("Candidate pairs of MSMRD integrator", "[msmrdIntegrator]") {
+    std::array<double,2> radialBounds{1.25, 2.25};
+    double boxsize = 12.0;
+    ctmsm unboundMSM = ctmsm(0, std::vector<std::vector<double>>{{-1.0, 1.0}, {1.0, -1.0}}, 3);
+    std::vector<double> Dlist{1.0, 1.0};
+    unboundMSM.setD(Dlist);
+    unboundMSM.setDrot(Dlist);
+    std::vector<std::vector<double>> msmrdTmatrix = {{0.0, 0.3, 0.2, 0.5},
+                                                     {0.4, 0.3, 0.1, 0.2},
+                                                     {0.1, 0.1, 0.6, 0.2},
+                                                     {0.4, 0.2, 0.3, 0.1}};
+    auto msmrdMSM = msmrdMarkovModel(2, 10, msmrdTmatrix, std::vector<int>{1, 2, 11, 12}, 1.0, 5);
+    auto boundary = box(boxsize, boxsize, boxsize, "periodic");
+    auto myIntegrator = msmrdIntegrator<ctmsm>(0.001, 7, "rigidbody", 1, radialBounds, unboundMSM, msmrdMSM);
+    myIntegrator.setBoundary(&boundary);
+    myIntegrator.setCandidatePairsSkin(1.0);
+    randomgen randg;
+    randg.setSeed(11);
+    std::vector<particle> plist;
+    for (int i = 0; i < 150; i++) {
+        auto position = vec3<double>(randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                     randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                     randg.uniformRange(-0.5*boxsize, 0.5*boxsize));
+        plist.push_back(particle(0, 0, 1.0, 1.0, position, quaternion<double>(1, 0, 0, 0)));
+    }
+    /* All the pairs closer than radialBounds[1] (periodic distance) are candidates, including pairs across
+     * the periodic boundary; checked against all the pairs after every time step. */
+    int numSteps = 200;
+    int numMissing = 0;
+    int numCloseAcross = 0;
+    for (int step = 0; step < numSteps; step++) {
+        myIntegrator.integrate(plist);
+        auto &candidates = myIntegrator.getCandidatePairs(plist);
+        for (int i = 0; i < plist.size(); i++) {
+            for (int j = i + 1; j < plist.size(); j++) {
+                auto relativePosition = msmrdtools::distancePeriodicBox(plist[i].nextPosition,
+                                                                        plist[j].nextPosition, boundary.boxsize);
+                if (relativePosition.norm() < radialBounds[1]) {
+                    std::array<int, 2> pair{i, j};
+                    numMissing += not std::binary_search(candidates.begin(), candidates.end(), pair);
+                    numCloseAcross += (plist[j].nextPosition - plist[i].nextPosition).norm() >= radialBounds[1];
+                }
+            }
+        }
+    }
+    REQUIRE(numMissing == 0);
+    REQUIRE(numCloseAcross > 0);
+    // The list is refreshed from the displacements, not rebuilt at every time step
+    REQUIRE(myIntegrator.getNumberOfCandidatePairsRebuilds() < numSteps / 2);
+    REQUIRE(myIntegrator.getNumberOfCandidatePairsRebuilds() > 1);
+}
+
+TEST_CASE("Event stream of MSMRD integrator replicas", "[msmrdIntegrator]") {
+    std::array<double,2> radialBounds{1.25, 2.25};
+    ctmsm unboundMSM = ctmsm(0, std::vector<std::vector<double>>{{-1.0, 1.0}, {1.0, -1.0}}, 3);
+    std::vector<std::vector<double>> msmrdTmatrix = {{0.0, 0.3, 0.2, 0.5},
+                                                     {0.4, 0.3, 0.1, 0.2},
+                                                     {0.1, 0.1, 0.6, 0.2},
+                                                     {0.4, 0.2, 0.3, 0.1}};
+    auto msmrdMSM = msmrdMarkovModel(2, 10, msmrdTmatrix, std::vector<int>{1, 2, 11, 12}, 1.0, 5);
+    auto prototype = msmrdIntegrator<ctmsm>(0.001, 7, "rigidbody", 1, radialBounds, unboundMSM, msmrdMSM);
+    prototype.setEventStream("testReplicaEvents");
+    // Copies (as made by the ensemble runner) share the stream, their records carry their replica ID
+    auto replica1 = prototype;
+    auto replica2 = prototype;
+    replica1.setReplicaID(1);
+    replica2.setReplicaID(2);
+    replica1.recordAppliedEvent(pairEvent{0.0, 0, 1, 12, 1, eventType::binding});
+    replica2.recordAppliedEvent(pairEvent{0.0, 2, 3, 1, 14, eventType::unbinding});
+    prototype.recordAppliedEvent(pairEvent{0.0, 4, 5, 13, 2, eventType::binding});
+    prototype.closeEventStream();
+    auto records = eventStream::readEventStream("testReplicaEvents.bin");
+    REQUIRE(records.size() == 3);
+    REQUIRE(records[0].replicaID == 1);
+    REQUIRE(records[0].part1Index == 0);
+    REQUIRE(records[1].replicaID == 2);
+    REQUIRE(records[1].part1Index == 2);
+    REQUIRE(records[2].replicaID == 0);
+    REQUIRE(records[2].part1Index == 4);
+    std::remove("testReplicaEvents.bin");
+}
+
 TEST_CASE("Initialization and functions of MSMRD multi-particle integrator class", "[msmrdMultiParticleIntegrator]") {
     int numBoundStates = 4;
     int numTransitionStates = 2;
@@ -297,6 +395,8 @@ TEST_CASE("Initialization and functions of MSMRD multi-particle integrator class
     REQUIRE((plist[2].orientation * relOrientation - plist[1].orientation).norm() <= 0.000001);
 
     // Bind two existing compounds together (compound 0-2-1 with compound 3-4)
+    REQUIRE(myIntegrator.findClosedBindingLoops(plist).empty());
+    REQUIRE(myIntegrator.getNumberOfRingFormations() == 0);
     iIndex = 0;
     jIndex = 3;
     boundStateIndex = 2;
@@ -305,6 +405,9 @@ TEST_CASE("Initialization and functions of MSMRD multi-particle integrator class
     REQUIRE(myIntegrator.particleCompounds.size() == 2);
     REQUIRE(myIntegrator.getCompoundSize(0) == 5);
     REQUIRE(myIntegrator.getCompoundSize(1) == 0);
+    // A compound of five particles counts as a pentamer, but it is an open chain, so no ring formation is recorded
+    REQUIRE(myIntegrator.findClosedBindingLoops(plist) == std::vector<int>{5});
+    REQUIRE(myIntegrator.getNumberOfRingFormations() == 0);
     myIntegrator.cleanParticleCompoundsVector(plist);
     REQUIRE(myIntegrator.particleCompounds.size() == 1);
     REQUIRE(myIntegrator.getCompoundSize(0) == 5);
@@ -340,8 +443,938 @@ TEST_CASE("Initialization and functions of MSMRD multi-particle integrator class
     jIndex = 4;
     boundStateIndex = 1;
     boundState = 2;
+    myIntegrator.setClock(2.5);
     myIntegrator.addCompound(plist, iIndex, jIndex, boundState);
     REQUIRE(myIntegrator.getNumberOfBindingsInCompound(0) == 5);
     auto bindingLoops = myIntegrator.findClosedBindingLoops(plist);
     REQUIRE(bindingLoops[0] == 5);
+    REQUIRE(myIntegrator.getNumberOfRingFormations() == 1);
+    auto ringFormation = myIntegrator.popRingFormation();
+    REQUIRE(ringFormation.loopSize == 5);
+    REQUIRE(ringFormation.iIndex == 1);
+    REQUIRE(ringFormation.jIndex == 4);
+    REQUIRE(ringFormation.compoundIndex == 0);
+    REQUIRE(ringFormation.time == 2.5);
+    REQUIRE(myIntegrator.getNumberOfRingFormations() == 0);
+    REQUIRE_THROWS(myIntegrator.popRingFormation());
+}
+
+TEST_CASE("Neighbor list pair search and pair forces", "[neighborList]") {
+    double boxsize = 5.0;
+    double cutOff = 0.7;
+    int numParticles = 150;
+    auto boundary = box(boxsize, boxsize, boxsize, "periodic");
+    randomgen randg;
+    randg.setSeed(5);
+
+    // Create random particle list in periodic box
+    std::vector<particle> plist;
+    std::vector<vec3<double>> positions;
+    auto orientation = quaternion<double> {1.0, 0.0, 0.0, 0.0};
+    for (int i = 0; i < numParticles; i++) {
+        auto position = vec3<double> {randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                      randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                      randg.uniformRange(-0.5*boxsize, 0.5*boxsize)};
+        positions.push_back(position);
+        plist.push_back(particle(1.0, 1.0, position, orientation));
+    }
+
+    // Pairs found by brute force (minimum image convention)
+    std::vector<std::array<int, 2>> pairsRef;
+    for (int i = 0; i < numParticles; i++) {
+        for (int j = i + 1; j < numParticles; j++) {
+            if (msmrdtools::distancePeriodicBox(positions[i], positions[j], boundary.boxsize).norm() <= cutOff) {
+                pairsRef.push_back({i, j});
+            }
+        }
+    }
+
+    // Check cell list finds the same pairs, also with less than three cells per axis
+    auto cellList = neighborList(cutOff, 0.0);
+    cellList.setBoundary(&boundary);
+    REQUIRE(cellList.getNeighborPairs(plist) == pairsRef);
+    auto cellListLarge = neighborList(2.0, 0.0);
+    cellListLarge.setBoundary(&boundary);
+    auto pairsLarge = cellListLarge.getNeighborPairs(plist);
+    int numPairsLarge = 0;
+    for (int i = 0; i < numParticles; i++) {
+        for (int j = i + 1; j < numParticles; j++) {
+            if (msmrdtools::distancePeriodicBox(positions[i], positions[j], boundary.boxsize).norm() <= 2.0) {
+                numPairsLarge++;
+            }
+        }
+    }
+    REQUIRE(pairsLarge.size() == numPairsLarge);
+
+    // Check Verlet list is only rebuilt after particles move more than skin/2
+    auto verletList = neighborList(cutOff, 0.2);
+    verletList.setBoundary(&boundary);
+    verletList.getNeighborPairs(plist);
+    plist[0].position += vec3<double>(0.05, 0.0, 0.0);
+    verletList.getNeighborPairs(plist);
+    REQUIRE(verletList.getNumberOfRebuilds() == 1);
+    plist[0].position += vec3<double>(0.1, 0.0, 0.0);
+    verletList.getNeighborPairs(plist);
+    REQUIRE(verletList.getNumberOfRebuilds() == 2);
+    plist[0].position = 1.0*positions[0];
+
+    // Check integration with cell and Verlet lists matches integration over all pairs
+    double dt = 0.001;
+    long seed = 7;
+    auto potential = harmonicRepulsion(10.0, cutOff);
+    REQUIRE(potential.getCutOff() == cutOff);
+    auto integratorRef = overdampedLangevin(dt, seed, "point");
+    auto integratorCell = overdampedLangevin(dt, seed, "point");
+    auto integratorVerlet = overdampedLangevin(dt, seed, "point");
+    std::array<overdampedLangevin*, 3> integrators = {&integratorRef, &integratorCell, &integratorVerlet};
+    for (auto integ : integrators) {
+        integ->setBoundary(&boundary);
+        integ->setPairPotential(&potential);
+    }
+    integratorCell.setNeighborList(0.0);
+    integratorVerlet.setNeighborList(0.3);
+    auto plistCell = plist;
+    auto plistVerlet = plist;
+    for (int step = 0; step < 50; step++) {
+        integratorRef.integrate(plist);
+        integratorCell.integrate(plistCell);
+        integratorVerlet.integrate(plistVerlet);
+    }
+    for (int i = 0; i < numParticles; i++) {
+        REQUIRE(plistCell[i].position == plist[i].position);
+        REQUIRE(plistVerlet[i].position == plist[i].position);
+    }
+}
+
+TEST_CASE("Structure of arrays particle container", "[particleSoA]") {
+    double boxsize = 4.0;
+    int numParticles = 60;
+    randomgen randg;
+    randg.setSeed(13);
+
+    // Create random particle list of rigid bodies in periodic box
+    std::vector<particle> plist;
+    for (int i = 0; i < numParticles; i++) {
+        auto position = vec3<double> {randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                      randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                      randg.uniformRange(-0.5*boxsize, 0.5*boxsize)};
+        auto orientation = msmrdtools::axisangle2quaternion(randg.uniformSphere(M_PI));
+        plist.push_back(particle(i % 2, 1, 1.0, 0.5, position, orientation));
+    }
+    plist[3].deactivate();
+
+    // Check adapters to and from particle lists
+    auto soa = particleSoA(plist);
+    REQUIRE(soa.size() == numParticles);
+    auto plistCopy = soa.toParticleList();
+    for (int i = 0; i < numParticles; i++) {
+        REQUIRE(plistCopy[i].position == plist[i].position);
+        REQUIRE(plistCopy[i].orientation == plist[i].orientation);
+        REQUIRE(plistCopy[i].type == plist[i].type);
+        REQUIRE(plistCopy[i].state == plist[i].state);
+        REQUIRE(plistCopy[i].isActive() == plist[i].isActive());
+    }
+    REQUIRE_FALSE(soa.isActive(3));
+
+    // Check values set on the container are copied back, keeping the variables not stored in it
+    plist[5].boundList = {6};
+    auto newPosition = vec3<double>(0.1, 0.2, 0.3);
+    soa.setPosition(5, newPosition);
+    soa.copyToParticleList(plist);
+    REQUIRE(plist[5].position == newPosition);
+    REQUIRE(plist[5].boundList == std::vector<int>{6});
+    soa.fromParticleList(plist);
+    REQUIRE(soa.getPosition(5) == newPosition);
+}
+
+TEST_CASE("Compile time specialized overdamped Langevin engine", "[overdampedLangevinEngine]") {
+    double boxsize = 4.0;
+    int numParticles = 60;
+    auto boundary = box(boxsize, boxsize, boxsize, "periodic");
+    randomgen randg;
+    randg.setSeed(21);
+
+    // Create random particle list of rigid bodies in periodic box
+    std::vector<particle> plist;
+    for (int i = 0; i < numParticles; i++) {
+        auto position = vec3<double> {randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                      randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                      randg.uniformRange(-0.5*boxsize, 0.5*boxsize)};
+        auto orientation = msmrdtools::axisangle2quaternion(randg.uniformSphere(M_PI));
+        plist.push_back(particle(1.0, 0.5, position, orientation));
+    }
+
+    // Rigid bodies with patchy particles, compare with generic integrator
+    double dt = 0.001;
+    long seed = 23;
+    double angleDiff = 3*M_PI/5.0;
+    std::vector<std::vector<double>> patchesCoordinates = {{std::cos(angleDiff/2), std::sin(angleDiff/2), 0.},
+                                                           {std::cos(-angleDiff/2), std::sin(-angleDiff/2), 0.}};
+    auto potential = patchyParticleAngular2(1.0, 50.0, patchesCoordinates);
+    auto integratorGeneric = overdampedLangevin(dt, seed, "rigidbody");
+    auto integratorEngine = overdampedLangevinEngine<patchyParticleAngular2, periodicBoxPolicy, rigidBody>(dt, seed);
+    integratorGeneric.setBoundary(&boundary);
+    integratorGeneric.setPairPotential(&potential);
+    integratorEngine.setBoundary(&boundary);
+    integratorEngine.setPairPotential(&potential);
+    auto plistEngine = plist;
+    for (int step = 0; step < 20; step++) {
+        integratorGeneric.integrate(plist);
+        integratorEngine.integrate(plistEngine);
+    }
+    for (int i = 0; i < numParticles; i++) {
+        REQUIRE(plistEngine[i].position == plist[i].position);
+        REQUIRE(plistEngine[i].orientation == plist[i].orientation);
+    }
+
+    // Point particles with harmonic repulsion and neighbor list, compare with generic integrator
+    auto repulsion = harmonicRepulsion(10.0, 0.6);
+    auto integratorPoint = overdampedLangevin(dt, seed, "point");
+    using pointEngine = overdampedLangevinEngine<harmonicRepulsion, genericBoundaryPolicy, pointBody>;
+    auto integratorPointEngine = pointEngine(dt, seed);
+    integratorPoint.setBoundary(&boundary);
+    integratorPoint.setPairPotential(&repulsion);
+    integratorPointEngine.setBoundary(&boundary);
+    integratorPointEngine.setPairPotential(&repulsion);
+    integratorPointEngine.setNeighborList(0.2);
+    plistEngine = plist;
+    for (int step = 0; step < 20; step++) {
+        integratorPoint.integrate(plist);
+        integratorPointEngine.integrate(plistEngine);
+    }
+    for (int i = 0; i < numParticles; i++) {
+        REQUIRE(plistEngine[i].position == plist[i].position);
+    }
+
+    // Potential or boundary not matching the engine
+    auto integratorMismatch = overdampedLangevinEngine<harmonicRepulsion, periodicBoxPolicy, pointBody>(dt, seed);
+    integratorMismatch.setBoundary(&boundary);
+    integratorMismatch.setPairPotential(&potential);
+    REQUIRE_THROWS(integratorMismatch.integrate(plist));
+    auto integratorNoBox = overdampedLangevinEngine<harmonicRepulsion, periodicBoxPolicy, pointBody>(dt, seed);
+    integratorNoBox.setPairPotential(&repulsion);
+    REQUIRE_THROWS(integratorNoBox.integrate(plist));
+}
+
+TEST_CASE("Multiple time step overdamped Langevin integrator", "[overdampedLangevinMTS]") {
+    double boxsize = 4.0;
+    int numParticles = 60;
+    auto boundary = box(boxsize, boxsize, boxsize, "periodic");
+    randomgen randg;
+    randg.setSeed(31);
+
+    // Create random particle list of rigid bodies in periodic box
+    std::vector<particle> plist;
+    for (int i = 0; i < numParticles; i++) {
+        auto position = vec3<double> {randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                      randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                      randg.uniformRange(-0.5*boxsize, 0.5*boxsize)};
+        auto orientation = msmrdtools::axisangle2quaternion(randg.uniformSphere(M_PI));
+        plist.push_back(particle(1.0, 0.5, position, orientation));
+    }
+
+    // Slow and fast parts of the patchy potential add up to the complete interaction
+    double angleDiff = 3*M_PI/5.0;
+    std::vector<std::vector<double>> patchesCoordinates = {{std::cos(angleDiff/2), std::sin(angleDiff/2), 0.},
+                                                           {std::cos(-angleDiff/2), std::sin(-angleDiff/2), 0.}};
+    std::vector<std::vector<double>> patchesCoordinatesA = {{1., 0., 0.}, {0., 1., 0.}, {0., 0., 1.},
+                                                            {-1., 0., 0.}, {0., -1., 0.}, {0., 0., -1.}};
+    std::vector<std::vector<double>> patchesCoordinatesB = {{1., 0., 0.}};
+    auto patchy = patchyParticle(1.0, 50.0, patchesCoordinates);
+    auto patchyAngular = patchyParticleAngular(1.0, 50.0, 2.0, patchesCoordinates);
+    auto patchyAngular2 = patchyParticleAngular2(1.0, 50.0, patchesCoordinates);
+    auto protein = patchyProtein(1.0, 50.0, patchesCoordinatesA, patchesCoordinatesB);
+    auto proteinMarkovSwitch = patchyProteinMarkovSwitch(1.0, 50.0, 2.0, patchesCoordinatesA, patchesCoordinatesB);
+    std::vector<pairPotential *> potentials = {&patchy, &patchyAngular, &patchyAngular2, &protein,
+                                               &proteinMarkovSwitch};
+    auto typedList = plist;
+    for (int i = 0; i < numParticles; i++) {
+        typedList[i].setType(i % 2);
+    }
+    int numFastPairs = 0;
+    for (auto potential : potentials) {
+        potential->setBoundary(&boundary);
+        for (int i = 0; i < numParticles; i++) {
+            for (int j = i + 1; j < numParticles; j++) {
+                // The Markov switch protein potential is only defined for pairs of particles of type 0 and 1
+                if (potential == &proteinMarkovSwitch and (i % 2 != 0 or j % 2 != 1)) {
+                    continue;
+                }
+                auto forctorq = potential->forceTorque(typedList[i], typedList[j]);
+                auto forctorqSlow = potential->forceTorqueSlow(typedList[i], typedList[j]);
+                auto forctorqFast = potential->forceTorqueFast(typedList[i], typedList[j]);
+                numFastPairs += static_cast<int>(forctorqFast[1].norm() > 0);
+                for (int k = 0; k < 4; k++) {
+                    REQUIRE((forctorqSlow[k] + forctorqFast[k] - forctorq[k]).norm() <= 1E-10);
+                }
+            }
+        }
+    }
+    REQUIRE(numFastPairs > 0);
+
+    // Without fast part of the interaction, same trajectories as overdampedLangevin
+    double dt = 0.001;
+    long seed = 37;
+    auto repulsion = harmonicRepulsion(10.0, 0.6);
+    auto integratorReference = overdampedLangevin(dt, seed, "rigidbody");
+    auto integratorMTS = overdampedLangevinMTS(dt, seed, "rigidbody", 5);
+    integratorReference.setBoundary(&boundary);
+    integratorReference.setPairPotential(&repulsion);
+    integratorMTS.setBoundary(&boundary);
+    integratorMTS.setPairPotential(&repulsion);
+    auto plistMTS = plist;
+    for (int step = 0; step < 20; step++) {
+        integratorReference.integrate(plist);
+        integratorMTS.integrate(plistMTS);
+    }
+    for (int i = 0; i < numParticles; i++) {
+        REQUIRE(plistMTS[i].position == plist[i].position);
+        REQUIRE(plistMTS[i].orientation == plist[i].orientation);
+    }
+    REQUIRE(integratorMTS.getClock() == integratorReference.getClock());
+
+    // Patchy particles with fast patch interactions, substeps keep particles in the box
+    auto integratorPatchy = overdampedLangevinMTS(10*dt, seed, "rigidbody", 10);
+    integratorPatchy.setBoundary(&boundary);
+    integratorPatchy.setPairPotential(&patchyAngular2);
+    integratorPatchy.setNeighborList(0.2);
+    for (int step = 0; step < 20; step++) {
+        integratorPatchy.integrate(plistMTS);
+    }
+    for (int i = 0; i < numParticles; i++) {
+        for (int k = 0; k < 3; k++) {
+            REQUIRE(std::abs(plistMTS[i].position[k]) <= 0.5*boxsize);
+        }
+        REQUIRE(std::abs(plistMTS[i].orientation.norm() - 1.0) <= 1E-10);
+    }
+    REQUIRE_THROWS(integratorPatchy.setNumSubsteps(0));
+}
+
+TEST_CASE("Adaptive time stepping of overdamped Langevin integrator", "[overdampedLangevin]") {
+    double boxsize = 4.0;
+    int numParticles = 60;
+    auto boundary = box(boxsize, boxsize, boxsize, "periodic");
+    randomgen randg;
+    randg.setSeed(41);
+    std::vector<particle> plist;
+    for (int i = 0; i < numParticles; i++) {
+        auto position = vec3<double> {randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                      randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                      randg.uniformRange(-0.5*boxsize, 0.5*boxsize)};
+        plist.push_back(particle(1.0, 0.5, position, quaternion<double>(1, 0, 0, 0)));
+    }
+    double dt = 0.01;
+    long seed = 43;
+    int numSteps = 20;
+    auto integratorReference = overdampedLangevin(dt, seed, "rigidbody");
+
+    // Without forces every internal step is accepted, so there is one internal step per time step
+    auto integratorFree = overdampedLangevin(dt, seed, "rigidbody");
+    integratorFree.setAdaptiveTimeStepping(1E-3, 1E-6);
+    auto plistFree = plist;
+    for (int step = 0; step < numSteps; step++) {
+        integratorFree.integrate(plistFree);
+        integratorReference.integrate(plist);
+    }
+    REQUIRE(integratorFree.getNumAcceptedSteps() == numSteps);
+    REQUIRE(integratorFree.getNumRejectedSteps() == 0);
+    REQUIRE(integratorFree.getClock() == integratorReference.getClock());
+
+    /* Stiff repulsion with a large time step: steps are rejected and refined, but the clock still advances
+     * exactly dt per call, so trajectories are sampled at the same times as with a fixed time step */
+    auto repulsion = harmonicRepulsion(100.0, 0.8);
+    auto integratorAdaptive = overdampedLangevin(dt, seed, "rigidbody");
+    integratorAdaptive.setBoundary(&boundary);
+    integratorAdaptive.setPairPotential(&repulsion);
+    integratorAdaptive.setAdaptiveTimeStepping(1E-3, 1E-6);
+    for (int step = 0; step < numSteps; step++) {
+        integratorAdaptive.integrate(plist);
+    }
+    REQUIRE(integratorAdaptive.getNumRejectedSteps() > 0);
+    REQUIRE(integratorAdaptive.getNumAcceptedSteps() > numSteps);
+    REQUIRE(integratorAdaptive.getClock() == integratorReference.getClock());
+    for (auto &part : plist) {
+        for (int k = 0; k < 3; k++) {
+            REQUIRE(std::abs(part.position[k]) <= 0.5*boxsize);
+        }
+    }
+
+    // Free diffusion in one long adaptive step has the correct mean squared displacement 6Dt
+    auto integratorDiffusion = overdampedLangevin(1.0, seed, "point");
+    integratorDiffusion.setAdaptiveTimeStepping(1E-3, 0.0);
+    std::vector<particle> plistDiffusion(2000, particle(1.0, 0.0, vec3<double>(0, 0, 0),
+                                                       quaternion<double>(1, 0, 0, 0)));
+    integratorDiffusion.integrate(plistDiffusion);
+    double meanSquaredDisplacement = 0.0;
+    for (auto &part : plistDiffusion) {
+        meanSquaredDisplacement += part.position.normSquared() / plistDiffusion.size();
+    }
+    REQUIRE(std::abs(meanSquaredDisplacement - 6.0) < 0.6);
+    REQUIRE_THROWS(integratorDiffusion.setAdaptiveTimeStepping(0.0, 0.0));
+    REQUIRE_THROWS(integratorDiffusion.setAdaptiveTimeStepping(1E-3, 2.0));
+
+    // Child integrators with their own integrate function don't support it (also when called as overdampedLangevin)
+    auto switchingMSM = ctmsm(0, std::vector<std::vector<double>>{{-1.0, 1.0}, {1.0, -1.0}}, 3);
+    auto integratorSwitch = overdampedLangevinMarkovSwitch<ctmsm>(switchingMSM, dt, seed, "point");
+    auto integratorMTS = overdampedLangevinMTS(dt, seed, "rigidbody", 5);
+    auto integratorSelective = overdampedLangevinSelective(dt, seed, "rigidbody");
+    auto integratorEngine = overdampedLangevinEngine<harmonicRepulsion, periodicBoxPolicy, pointBody>(dt, seed);
+    std::vector<overdampedLangevin *> childIntegrators = {&integratorSwitch, &integratorMTS, &integratorSelective,
+                                                          &integratorEngine};
+    for (auto childIntegrator : childIntegrators) {
+        REQUIRE_THROWS_AS(childIntegrator->setAdaptiveTimeStepping(1E-3, 1E-6), std::invalid_argument);
+        REQUIRE_FALSE(childIntegrator->isAdaptiveTimeStepping());
+    }
+}
+
+TEST_CASE("Ensemble runner of independent replicas", "[ensembleRunner]") {
+    // Every task of the work stealing pool runs exactly once
+    std::vector<std::atomic<int>> taskCounts(100);
+    workStealingPool pool(4);
+    pool.run(100, [&](int task) { taskCounts[task]++; });
+    for (auto &count : taskCounts) {
+        REQUIRE(count == 1);
+    }
+
+    // Replicas of a small system with pair interactions in a periodic box
+    double boxsize = 3.0;
+    auto boundary = box(boxsize, boxsize, boxsize, "periodic");
+    auto repulsion = harmonicRepulsion(10.0, 0.6);
+    auto prototype = overdampedLangevin(0.001, 51, "point");
+    prototype.setBoundary(&boundary);
+    prototype.setPairPotential(&repulsion);
+    auto generator = [boxsize](int replica, randomgen &randg) {
+        std::vector<particle> plist;
+        for (int i = 0; i < 10; i++) {
+            auto position = vec3<double> {randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                          randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                          randg.uniformRange(-0.5*boxsize, 0.5*boxsize)};
+            plist.push_back(particle(1.0, 0.0, position, quaternion<double>(1, 0, 0, 0)));
+        }
+        return plist;
+    };
+    auto runner = ensembleRunner<overdampedLangevin>(prototype, generator, 53);
+    runner.setStopCondition([](const std::vector<particle> &parts, double time) {
+        return parts[0].position[0] > 1.0;
+    });
+    runner.setNumThreads(4);
+    int numReplicas = 24;
+    long maxSteps = 400;
+    int numCallbacks = 0;
+    auto results = runner.run(numReplicas, maxSteps, [&](const replicaResult &result) { numCallbacks++; });
+    REQUIRE(numCallbacks == numReplicas);
+    REQUIRE(results.size() == numReplicas);
+    int numStopped = 0;
+    for (int replica = 0; replica < numReplicas; replica++) {
+        REQUIRE(results[replica].replica == replica);
+        REQUIRE(results[replica].numSteps <= maxSteps);
+        REQUIRE(results[replica].time == Approx(0.001*results[replica].numSteps));
+        if (results[replica].stopped) {
+            numStopped++;
+            REQUIRE(results[replica].particles[0].position[0] > 1.0);
+        }
+    }
+    REQUIRE(numStopped > 0);
+    REQUIRE(numStopped < numReplicas);
+
+    // Results don't depend on the number of threads, and replicas are independent
+    runner.setNumThreads(1);
+    auto resultsSerial = runner.run(numReplicas, maxSteps);
+    for (int replica = 0; replica < numReplicas; replica++) {
+        REQUIRE(resultsSerial[replica].numSteps == results[replica].numSteps);
+        for (int i = 0; i < 10; i++) {
+            REQUIRE(resultsSerial[replica].particles[i].position == results[replica].particles[i].position);
+        }
+    }
+    auto sameInitialConditions = [boxsize](int replica, randomgen &randg) {
+        return std::vector<particle>(1, particle(1.0, 0.0, vec3<double>(0, 0, 0), quaternion<double>(1, 0, 0, 0)));
+    };
+    auto runnerFree = ensembleRunner<overdampedLangevin>(overdampedLangevin(0.001, 51, "point"),
+                                                         sameInitialConditions, 53);
+    auto replica0 = runnerFree.runReplica(0, 10);
+    auto replica1 = runnerFree.runReplica(1, 10);
+    REQUIRE(not (replica0.particles[0].position == replica1.particles[0].position));
+
+    // Exceptions thrown by a replica are passed to the caller
+    auto throwingGenerator = [](int replica, randomgen &randg) -> std::vector<particle> {
+        throw std::runtime_error("Failed to generate particles");
+    };
+    auto runnerThrowing = ensembleRunner<overdampedLangevin>(prototype, throwingGenerator, 53);
+    runnerThrowing.setNumThreads(4);
+    REQUIRE_THROWS(runnerThrowing.run(numReplicas, maxSteps));
+}
+
+TEST_CASE("Active patches of selective overdamped Langevin integrator", "[overdampedLangevinSelective]") {
+    // Reference: active patches assigned by looping over all the pairs of particles
+    auto referenceTraj = patchyDimerTrajectory2(2, 1);
+    referenceTraj.setTolerances(0.50, 0.5*2*M_PI);
+    auto referenceActivePatches = [&referenceTraj](std::vector<particle> &parts, int &numBoundPairs) {
+        std::vector<std::vector<int>> activePatches(parts.size(), std::vector<int>(2, -1));
+        std::array<std::array<int, 2>, 4> patchIndexes = {{{0, 1}, {0, 0}, {1, 0}, {1, 1}}};
+        for (int i = 0; i < parts.size() - 1; i++) {
+            for (int j = i + 1; j < parts.size(); j++) {
+                int state = referenceTraj.sampleDiscreteState(parts[i], parts[j]);
+                if (state >= 1 and state <= 4) {
+                    numBoundPairs++;
+                    auto patchi = patchIndexes[state - 1][0];
+                    auto patchj = patchIndexes[state - 1][1];
+                    if (activePatches[i][patchi] < 0 and activePatches[j][patchj] < 0) {
+                        activePatches[i][patchi] = j;
+                        activePatches[j][patchj] = i;
+                    }
+                }
+            }
+        }
+        return activePatches;
+    };
+
+    // Pairs of particles initially in each of the four bound states and a few other particles
+    randomgen randg;
+    randg.setSeed(83);
+    double boxsize = 5.0;
+    auto boundary = box(boxsize, boxsize, boxsize, "periodic");
+    std::vector<particle> plist;
+    for (int pair = 0; pair < 8; pair++) {
+        auto position = vec3<double>(-2.0 + 1.6 * (pair % 4), -1.0 + 2.0 * (pair / 4), 0.0);
+        auto orientation = msmrdtools::axisangle2quaternion(randg.uniformSphere(M_PI));
+        auto position2 = position + msmrdtools::rotateVec(referenceTraj.getRelativePosition(pair % 4), orientation);
+        auto orientation2 = referenceTraj.getRelativeOrientation(pair % 4) * orientation;
+        plist.push_back(particle(1.0, 1.0, position, orientation));
+        plist.push_back(particle(1.0, 1.0, position2, orientation2));
+    }
+    for (int i = 0; i < 4; i++) {
+        auto position = vec3<double> {randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                      randg.uniformRange(-0.5*boxsize, 0.5*boxsize), 1.5};
+        plist.push_back(particle(1.0, 1.0, position, msmrdtools::axisangle2quaternion(randg.uniformSphere(M_PI))));
+    }
+    for (int i = 0; i < plist.size(); i++) {
+        plist[i].setID(i);
+        plist[i].setActivePatchList(2);
+    }
+
+    /* The active patches found by the integrator (only for nearby pairs, and reassigned only when the bound
+     * pairs change) match the reference at every time step. */
+    double angleDiff = 3*M_PI/5.0;
+    std::vector<std::vector<double>> patchesCoordinates = {{std::cos(angleDiff/2), std::sin(angleDiff/2), 0.},
+                                                           {std::cos(-angleDiff/2), std::sin(-angleDiff/2), 0.}};
+    auto potential = patchyParticleAngular2(1.0, 160.0, 20.0, patchesCoordinates);
+    auto integ = overdampedLangevinSelective(0.0005, 29, "rigidbody");
+    integ.setBoundary(&boundary);
+    integ.setPairPotential(&potential);
+    int numBoundPairs = 0;
+    for (int step = 0; step < 400; step++) {
+        auto activePatches = referenceActivePatches(plist, numBoundPairs);
+        integ.integrate(plist);
+        for (int i = 0; i < plist.size(); i++) {
+            REQUIRE(plist[i].activePatchList == activePatches[i]);
+        }
+    }
+    REQUIRE(numBoundPairs > 0);
+}
+
+TEST_CASE("Ring detection of selective overdamped Langevin integrator", "[overdampedLangevinSelective]") {
+    // Reference: loops found from the particle compounds built from all the bound pairs
+    auto referenceLoops = [](overdampedLangevinSelective &integ, std::vector<particle> &parts) {
+        integ.updateParticleCompounds(parts);
+        std::vector<int> loops;
+        for (auto &compound : integ.particleCompounds) {
+            if (compound.active and compound.getSizeOfCompound() == compound.getNumberOfbindings()) {
+                loops.push_back(compound.getNumberOfbindings());
+            }
+        }
+        std::sort(loops.begin(), loops.end());
+        return loops;
+    };
+
+    // Pentamer ring, each particle bound to the next one in bound state 1, and two unbound particles
+    auto integ = overdampedLangevinSelective(0.0001, 37, "rigidbody");
+    std::vector<particle> plist;
+    auto position = vec3<double>(0.0, 0.0, 0.0);
+    auto orientation = quaternion<double>(1.0, 0.0, 0.0, 0.0);
+    for (int i = 0; i < 5; i++) {
+        plist.push_back(particle(1.0, 1.0, position, orientation));
+        position += msmrdtools::rotateVec(integ.patchyTraj->getRelativePosition(0), orientation);
+        orientation = integ.patchyTraj->getRelativeOrientation(0) * orientation;
+    }
+    plist.push_back(particle(1.0, 1.0, vec3<double>(5.0, 0.0, 0.0), orientation));
+    plist.push_back(particle(1.0, 1.0, vec3<double>(-5.0, 0.0, 0.0), orientation));
+    for (int i = 0; i < plist.size(); i++) {
+        plist[i].setID(i);
+        plist[i].setActivePatchList(2);
+    }
+    REQUIRE(integ.findClosedBindingLoops(plist) == std::vector<int>{5});
+    REQUIRE(integ.getParticleCompoundSize(3) == 5);
+    REQUIRE(integ.getParticleCompoundSize(5) == 1);
+    REQUIRE(integ.getParticleCompoundSize(7) == -1);
+    REQUIRE(referenceLoops(integ, plist) == std::vector<int>{5});
+
+    // Unbinding one particle opens the ring, binding it again closes it
+    auto ringPosition = plist[2].position;
+    plist[2].position = vec3<double>(0.0, 5.0, 0.0);
+    REQUIRE(integ.findClosedBindingLoops(plist).empty());
+    REQUIRE(integ.getParticleCompoundSize(0) == 4);
+    REQUIRE(integ.getParticleCompoundSize(2) == 1);
+    plist[2].position = ringPosition;
+    REQUIRE(integ.findClosedBindingLoops(plist) == std::vector<int>{5});
+
+    // The loops tracked along a trajectory match the reference
+    double angleDiff = 3*M_PI/5.0;
+    std::vector<std::vector<double>> patchesCoordinates = {{std::cos(angleDiff/2), std::sin(angleDiff/2), 0.},
+                                                           {std::cos(-angleDiff/2), std::sin(-angleDiff/2), 0.}};
+    auto potential = patchyParticleAngular2(1.0, 160.0, 20.0, patchesCoordinates);
+    integ.setPairPotential(&potential);
+    for (int step = 0; step < 200; step++) {
+        integ.integrate(plist);
+        auto loops = integ.findClosedBindingLoops(plist);
+        std::sort(loops.begin(), loops.end());
+        REQUIRE(loops == referenceLoops(integ, plist));
+    }
+}
+
+TEST_CASE("Markov switch integration with shared MSMs", "[overdampedLangevinMarkovSwitch]") {
+    std::vector<std::vector<double>> tmatrix = {{-2.0, 2.0}, {3.0, -3.0}};
+    auto tmsm = ctmsm(0, tmatrix, 7);
+    std::vector<double> Dlist = {1.0, 0.1};
+    std::vector<double> Drotlist = {1.0, 0.1};
+    tmsm.setD(Dlist);
+    tmsm.setDrot(Drotlist);
+    double boxsize = 5.0;
+    auto boundary = box(boxsize, boxsize, boxsize, "periodic");
+    randomgen randg;
+    randg.setSeed(19);
+    std::vector<particle> plist;
+    for (int i = 0; i < 50; i++) {
+        auto position = vec3<double> {randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                      randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                      randg.uniformRange(-0.5*boxsize, 0.5*boxsize)};
+        plist.push_back(particle(0, i % 2, 1.0, 1.0, position, quaternion<double>(1, 0, 0, 0)));
+    }
+    auto plist2 = plist;
+    auto integ = overdampedLangevinMarkovSwitch<ctmsm>(tmsm, 0.01, 23, "point");
+    auto integ2 = overdampedLangevinMarkovSwitch<ctmsm>(tmsm, 0.01, 23, "point");
+    integ.setBoundary(&boundary);
+    integ2.setBoundary(&boundary);
+    integ.integrate(plist);
+    integ2.integrate(plist2);
+
+    /* The switching times are drawn from the integrator random streams, so integrators with the same seed give the
+     * same trajectories and the particles switch independently. */
+    int numSwitches = 0;
+    for (int step = 0; step < 500; step++) {
+        auto previousState = plist[step % plist.size()].state;
+        integ.integrate(plist);
+        integ2.integrate(plist2);
+        numSwitches += static_cast<int>(plist[step % plist.size()].state != previousState);
+    }
+    REQUIRE(numSwitches > 0);
+    std::set<double> lagtimes;
+    for (int i = 0; i < plist.size(); i++) {
+        REQUIRE(plist[i].position == plist2[i].position);
+        REQUIRE(plist[i].state == plist2[i].state);
+        REQUIRE(plist[i].lagtime == plist2[i].lagtime);
+        REQUIRE(plist[i].D == Dlist[plist[i].state]);
+        lagtimes.insert(plist[i].lagtime);
+    }
+    REQUIRE(lagtimes.size() > 1);
+}
+
+TEST_CASE("Counter-based noise of Markov switch integration", "[overdampedLangevinMarkovSwitch]") {
+    std::vector<std::vector<double>> tmatrix = {{-20.0, 20.0}, {30.0, -30.0}};
+    auto tmsm = ctmsm(0, tmatrix, 7);
+    std::vector<double> Dlist = {1.0, 0.1};
+    std::vector<double> Drotlist = {1.0, 0.1};
+    tmsm.setD(Dlist);
+    tmsm.setDrot(Drotlist);
+    std::vector<particle> plist;
+    for (int i = 0; i < 40; i++) {
+        plist.push_back(particle(0, i % 2, 1.0, 1.0, vec3<double>(i, 0, 0), quaternion<double>(1, 0, 0, 0)));
+    }
+    auto plistShort = std::vector<particle>(plist.begin(), plist.begin() + 30);
+
+    /* The noise of each particle is drawn from its own substream, followed by its switching times, so the
+     * trajectories don't depend on the other particles in the list (step by step and event driven switching). */
+    for (bool eventDriven : {false, true}) {
+        auto integ = overdampedLangevinMarkovSwitch<ctmsm>(tmsm, 0.01, 29, "rigidbody");
+        auto integShort = overdampedLangevinMarkovSwitch<ctmsm>(tmsm, 0.01, 29, "rigidbody");
+        for (auto currentInteg : {&integ, &integShort}) {
+            currentInteg->setRandomGenerator("philox");
+            currentInteg->setEventDrivenSwitching(eventDriven);
+        }
+        for (int step = 0; step < 100; step++) {
+            integ.integrate(plist);
+            integShort.integrate(plistShort);
+        }
+        for (int i = 0; i < plistShort.size(); i++) {
+            REQUIRE(plist[i].position == plistShort[i].position);
+            REQUIRE(plist[i].orientation == plistShort[i].orientation);
+            REQUIRE(plist[i].state == plistShort[i].state);
+        }
+    }
+}
+
+TEST_CASE("Event driven Markov switch integration", "[overdampedLangevinMarkovSwitch]") {
+    std::vector<std::vector<double>> tmatrix = {{-2.0, 2.0}, {3.0, -3.0}};
+    auto tmsm = ctmsm(0, tmatrix, 7);
+    std::vector<double> Dlist = {1.0, 0.1};
+    std::vector<double> Drotlist = {1.0, 0.1};
+    tmsm.setD(Dlist);
+    tmsm.setDrot(Drotlist);
+    std::vector<particle> plist;
+    for (int i = 0; i < 200; i++) {
+        plist.push_back(particle(0, i % 2, Dlist[i % 2], Drotlist[i % 2], vec3<double>(0, 0, 0),
+                                 quaternion<double>(1, 0, 0, 0)));
+    }
+    plist[0].setMSMoff();
+    double dt = 0.01;
+    auto integ = overdampedLangevinMarkovSwitch<ctmsm>(tmsm, dt, 31, "point");
+    integ.setEventDrivenSwitching(true);
+    integ.integrate(plist);
+
+    /* The stationary distribution is (3/5, 2/5), so the average diffusion coefficient is 0.64 and the mean square
+     * displacement in one time step is 6 * 0.64 * dt. Particles with an inactive MSM don't switch. */
+    int numSteps = 2000;
+    double occupationState0 = 0;
+    double squareDisplacement = 0;
+    int numInconsistent = 0;
+    std::vector<vec3<double>> positions(plist.size());
+    for (int step = 0; step < numSteps; step++) {
+        for (int i = 0; i < plist.size(); i++) {
+            positions[i] = plist[i].position;
+        }
+        integ.integrate(plist);
+        for (int i = 1; i < plist.size(); i++) {
+            occupationState0 += static_cast<double>(plist[i].state == 0);
+            squareDisplacement += (plist[i].position - positions[i]).normSquared();
+            numInconsistent += static_cast<int>(plist[i].D != Dlist[plist[i].state] or
+                                                integ.getNextSwitchTime(i) <= integ.clock);
+        }
+    }
+    REQUIRE(numInconsistent == 0);
+    occupationState0 /= numSteps * (plist.size() - 1);
+    squareDisplacement /= numSteps * (plist.size() - 1);
+    REQUIRE(occupationState0 == Approx(0.6).epsilon(0.05));
+    REQUIRE(squareDisplacement == Approx(6 * 0.64 * dt).epsilon(0.05));
+    REQUIRE(plist[0].state == 0);
+    REQUIRE(integ.getNextSwitchTime(0) == std::numeric_limits<double>::infinity());
+
+    /* Setting or resetting the clock keeps the time left until the next switches, so the particles continue
+     * switching (otherwise they would wait until the clock reaches the old switching times). */
+    double remainingTime = integ.getNextSwitchTime(1) - integ.clock;
+    integ.setClock(1000.0);
+    REQUIRE(integ.getNextSwitchTime(1) - integ.clock == Approx(remainingTime));
+    integ.resetClock();
+    REQUIRE(integ.getNextSwitchTime(1) == Approx(remainingTime));
+    int numSwitches = 0;
+    std::vector<int> states(plist.size());
+    for (int step = 0; step < 100; step++) {
+        for (int i = 0; i < plist.size(); i++) {
+            states[i] = plist[i].state;
+        }
+        integ.integrate(plist);
+        for (int i = 1; i < plist.size(); i++) {
+            numSwitches += static_cast<int>(plist[i].state != states[i]);
+            numInconsistent += static_cast<int>(integ.getNextSwitchTime(i) <= integ.clock or
+                                                integ.getNextSwitchTime(i) > integ.clock + 100.0);
+        }
+    }
+    REQUIRE(numInconsistent == 0);
+    // Expected number of switches is 199 particles * 1.0 time units * 2.4 switches per time unit
+    REQUIRE(numSwitches > 200);
+
+    // Back to step by step switching, the remaining lagtimes continue from the switching queue
+    double nextSwitchTime = integ.getNextSwitchTime(1);
+    integ.setEventDrivenSwitching(false);
+    integ.integrate(plist);
+    REQUIRE(integ.getNextSwitchTime(1) == std::numeric_limits<double>::infinity());
+    if (nextSwitchTime > integ.clock) {
+        REQUIRE(plist[1].lagtime == Approx(nextSwitchTime - integ.clock));
+    }
+}
+
+TEST_CASE("Integration of several time steps in one call", "[integrator]") {
+    double dt = 0.001;
+    auto orientation = quaternion<double>(1, 0, 0, 0);
+    std::vector<particle> plist = {particle(1.0, 0.0, vec3<double>(0, 0, 0), orientation),
+                                   particle(1.0, 0.0, vec3<double>(0.5, 0, 0), orientation)};
+    auto plistCopy = plist;
+    auto repulsion = harmonicRepulsion(10.0, 1.0);
+    auto integ = overdampedLangevin(dt, 71, "point");
+    auto integCopy = overdampedLangevin(dt, 71, "point");
+    integ.setPairPotential(&repulsion);
+    integCopy.setPairPotential(&repulsion);
+
+    // Same trajectory as calling integrate once per step
+    REQUIRE(integ.integrateSteps(plist, 100) == 100);
+    for (int step = 0; step < 100; step++) {
+        integCopy.integrate(plistCopy);
+    }
+    REQUIRE(integ.getClock() == integCopy.getClock());
+    for (int i = 0; i < plist.size(); i++) {
+        REQUIRE(plist[i].position == plistCopy[i].position);
+    }
+
+    // Early stop, the condition is evaluated after each step
+    int numCalls = 0;
+    auto stopCondition = [&numCalls, dt](std::vector<particle> &parts, double time) {
+        numCalls++;
+        return time >= 120 * dt - 0.5 * dt;
+    };
+    REQUIRE(integ.integrateSteps(plist, 100, stopCondition) == 20);
+    REQUIRE(numCalls == 20);
+    REQUIRE(integ.integrateSteps(plist, 0, stopCondition) == 0);
+    REQUIRE(numCalls == 20);
+}
+
+TEST_CASE("First passage driver and stopping conditions", "[firstPassage]") {
+    double dt = 0.001;
+    auto orientation = quaternion<double>(1, 0, 0, 0);
+    std::vector<particle> plist = {particle(1.0, 0.0, vec3<double>(0, 0, 0), orientation),
+                                   particle(1.0, 0.0, vec3<double>(0.2, 0, 0), orientation),
+                                   particle(1.0, 0.0, vec3<double>(0, 0.2, 0), orientation)};
+    auto integ = overdampedLangevin(dt, 61, "point");
+
+    // Bound state conditions of two particle and multiparticle MSM/RD bindings
+    auto bound = passageCondition::boundStates({2, 3}, 0, 1);
+    auto anyBound = passageCondition::boundStates({}, 0, 2);
+    REQUIRE_FALSE(bound(integ, plist));
+    plist[0].boundTo = 1;
+    plist[0].boundState = 1;
+    REQUIRE_FALSE(bound(integ, plist));
+    plist[0].boundState = 3;
+    REQUIRE(bound(integ, plist));
+    REQUIRE_FALSE(anyBound(integ, plist));
+    plist[0].boundList = {2};
+    plist[0].boundStates = {4};
+    REQUIRE(anyBound(integ, plist));
+
+    // Unbound condition and composition of conditions
+    auto unbound = passageCondition::unbound(0.1, 0, 1);
+    REQUIRE_FALSE(unbound(integ, plist));
+    plist[0].boundTo = -1;
+    REQUIRE(unbound(integ, plist));
+    REQUIRE_FALSE(passageCondition::unbound(0.3, 0, 1)(integ, plist));
+    REQUIRE(passageCondition::allOf({unbound, anyBound})(integ, plist));
+    REQUIRE_FALSE(passageCondition::allOf({unbound, bound})(integ, plist));
+    REQUIRE(passageCondition::anyOf({bound, unbound})(integ, plist));
+    REQUIRE(passageCondition::negation(bound)(integ, plist));
+
+    /* First passage to a relative distance of one (or clock limit); it matches the same loop with the same
+     * seed written explicitly. */
+    plist = {particle(1.0, 0.0, vec3<double>(0, 0, 0), orientation),
+             particle(1.0, 0.0, vec3<double>(0.2, 0, 0), orientation)};
+    auto plistCopy = plist;
+    auto fpt = firstPassage<overdampedLangevin>(integ);
+    fpt.addCondition("unbound", passageCondition::unbound(1.0));
+    fpt.addCondition("timeout", passageCondition::clockLimit(100.0));
+    REQUIRE(fpt.getNumberOfConditions() == 2);
+    auto result = fpt.run(plist);
+    REQUIRE(result.conditionName == "unbound");
+    REQUIRE(result.condition == 0);
+    REQUIRE((plist[1].position - plist[0].position).norm() >= 1.0);
+    auto integCopy = overdampedLangevin(dt, 61, "point");
+    long numSteps = 0;
+    do {
+        integCopy.integrate(plistCopy);
+        numSteps++;
+    } while ((plistCopy[1].position - plistCopy[0].position).norm() < 1.0);
+    REQUIRE(numSteps == result.numSteps);
+    REQUIRE(result.time == Approx(dt * numSteps));
+
+    // Clock limit and maximum number of steps; the time is measured from the beginning of each run
+    fpt.clearConditions();
+    double initialClock = integ.getClock();
+    fpt.addCondition("timeout", passageCondition::clockLimit(initialClock + 0.05));
+    result = fpt.run(plist);
+    REQUIRE(result.conditionName == "timeout");
+    REQUIRE(integ.getClock() >= initialClock + 0.05);
+    REQUIRE(integ.getClock() - dt < initialClock + 0.05);
+    REQUIRE(result.time == Approx(integ.getClock() - initialClock));
+    result = fpt.run(plist, 10);
+    REQUIRE(result.condition == 0);
+    REQUIRE(result.numSteps == 1);
+    fpt.clearConditions();
+    result = fpt.run(plist, 10);
+    REQUIRE(result.condition == -1);
+    REQUIRE(result.conditionName.empty());
+    REQUIRE(result.numSteps == 10);
+    REQUIRE_THROWS(fpt.run(plist));
+
+    // Ring formation conditions can only be evaluated by integrators with particle compounds
+    fpt.addCondition("ring", passageCondition::ringFormation<overdampedLangevinSelective>(3));
+    REQUIRE_THROWS(fpt.run(plist, 1));
+    auto integSelective = overdampedLangevinSelective(dt, 61, "rigidbody");
+    auto fptSelective = firstPassage<overdampedLangevinSelective>(integSelective);
+    fptSelective.addCondition("ring", passageCondition::ringFormation<overdampedLangevinSelective>(3));
+    for (int i = 0; i < plist.size(); i++) {
+        plist[i].setID(i);
+        plist[i].activePatchList = {-1, -1};
+    }
+    result = fptSelective.run(plist, 5);
+    REQUIRE(result.condition == -1);
+    REQUIRE(result.numSteps == 5);
+}
+
+#ifdef _OPENMP
+TEST_CASE("Multithreaded force and torque calculation", "[integrator]") {
+    double boxsize = 6.0;
+    int numParticles = 120;
+    auto boundary = box(boxsize, boxsize, boxsize, "periodic");
+    randomgen randg;
+    randg.setSeed(11);
+
+    // Create random particle list of rigid bodies in periodic box
+    std::vector<particle> plist;
+    for (int i = 0; i < numParticles; i++) {
+        auto position = vec3<double> {randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                      randg.uniformRange(-0.5*boxsize, 0.5*boxsize),
+                                      randg.uniformRange(-0.5*boxsize, 0.5*boxsize)};
+        auto orientation = msmrdtools::axisangle2quaternion(randg.uniformSphere(M_PI));
+        plist.push_back(particle(1.0, 1.0, position, orientation));
+    }
+
+    // Patchy particle potential with two patches
+    double angleDiff = 3*M_PI/5.0;
+    std::vector<std::vector<double>> patchesCoordinates = {{std::cos(angleDiff/2), std::sin(angleDiff/2), 0.},
+                                                           {std::cos(-angleDiff/2), std::sin(-angleDiff/2), 0.}};
+    auto potential = patchyParticleAngular2(1.0, 50.0, patchesCoordinates);
+
+    // Integrate with one and four threads (twice), all pairs and neighbor list
+    double dt = 0.0001;
+    long seed = 3;
+    auto integratorSerial = overdampedLangevin(dt, seed, "rigidbody");
+    auto integratorThreads = overdampedLangevin(dt, seed, "rigidbody");
+    auto integratorThreads2 = overdampedLangevin(dt, seed, "rigidbody");
+    auto integratorThreadsList = overdampedLangevin(dt, seed, "rigidbody");
+    std::array<overdampedLangevin*, 4> integrators = {&integratorSerial, &integratorThreads,
+                                                      &integratorThreads2, &integratorThreadsList};
+    for (auto integ : integrators) {
+        integ->setBoundary(&boundary);
+        integ->setPairPotential(&potential);
+    }
+    integratorThreads.setNumThreads(4);
+    integratorThreads2.setNumThreads(4);
+    integratorThreadsList.setNumThreads(4);
+    integratorThreadsList.setNeighborList(0.2);
+    REQUIRE(integratorThreads.getNumThreads() == 4);
+    REQUIRE_THROWS(integratorSerial.setNumThreads(0));
+
+    auto plistThreads = plist;
+    auto plistThreads2 = plist;
+    auto plistThreadsList = plist;
+    for (int step = 0; step < 20; step++) {
+        integratorSerial.integrate(plist);
+        integratorThreads.integrate(plistThreads);
+        integratorThreads2.integrate(plistThreads2);
+        integratorThreadsList.integrate(plistThreadsList);
+    }
+    for (int i = 0; i < numParticles; i++) {
+        // Bitwise reproducible for a fixed number of threads
+        REQUIRE(plistThreads[i].position == plistThreads2[i].position);
+        REQUIRE(plistThreads[i].orientation == plistThreads2[i].orientation);
+        // Equal to serial integration up to round off
+        REQUIRE((plistThreads[i].position - plist[i].position).norm() < 1e-8);
+        REQUIRE((plistThreadsList[i].position - plist[i].position).norm() < 1e-8);
+        REQUIRE((plistThreads[i].orientation - plist[i].orientation).norm() < 1e-8);
+    }
 }
+#endif
@@ -2,8 +2,14 @@
 // Created by dibakma on 26.06.18.
 //
 #define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
+#include <cmath>
+#include <set>
 #include <catch2/catch.hpp>
+#include "bondGraph.hpp"
 #include "eventManager.hpp"
+#include "eventStream.hpp"
+#include "indexedPriorityQueue.hpp"
+#include "pairEventManager.hpp"
 #include "particle.hpp"
 #include "quaternion.hpp"
 #include "randomgen.hpp"
@@ -184,6 +190,95 @@ TEST_CASE("Sampling from randomgen, part2", "[randomgen]") {
 
 
 
+TEST_CASE("Counter-based random streams and seeding", "[randomgen]") {
+    // Philox4x32-10 known answer (Random123 test vector)
+    auto block = philox4x32::bijection({{0, 0, 0, 0}}, {{0, 0}});
+    REQUIRE(block[0] == 0x6627e8d5);
+    REQUIRE(block[1] == 0xe169c58d);
+    REQUIRE(block[2] == 0xbc57ac4c);
+    REQUIRE(block[3] == 0x9b00dbd8);
+
+    // Copies of seeded generators continue the same sequence, for both backends
+    randomgen randg;
+    randg.setSeed(42);
+    randg.normal(0, 1);
+    randomgen randgCopy(randg);
+    REQUIRE(randgCopy.getSeed() == 42);
+    REQUIRE(randgCopy.normal(0, 1) == randg.normal(0, 1));
+    randg.setBackend("philox");
+    randgCopy = randg;
+    REQUIRE(randgCopy.getBackend() == "philox");
+    REQUIRE(randgCopy.uniformRange(0, 1) == randg.uniformRange(0, 1));
+    REQUIRE_THROWS(randg.setBackend("unknown"));
+
+    // Substreams only depend on (seed, replica id, particle id, step), not on the order they are drawn
+    randomgen randg2;
+    randg2.setSeed(42);
+    randg2.setBackend("philox");
+    randg.setSubstream(3, 7);
+    auto sample1 = randg.normal3D(0, 1);
+    randg.setSubstream(5, 7);
+    auto sample2 = randg.normal3D(0, 1);
+    randg2.setSubstream(5, 7);
+    REQUIRE(randg2.normal3D(0, 1) == sample2);
+    randg2.setSubstream(3, 7);
+    REQUIRE(randg2.normal3D(0, 1) == sample1);
+    randg2.setSubstream(3, 8);
+    REQUIRE_FALSE(randg2.normal3D(0, 1) == sample1);
+    randg2.setReplicaID(1);
+    randg2.setSubstream(3, 7);
+    REQUIRE_FALSE(randg2.normal3D(0, 1) == sample1);
+
+    // Statistics of the counter-based generator
+    int numSamples = 20000;
+    double mean = 0.0;
+    double variance = 0.0;
+    for (int i = 0; i < numSamples; i++) {
+        randg2.setSubstream(i, 0);
+        double sample = randg2.normal(0, 1);
+        mean += sample/numSamples;
+        variance += sample*sample/numSamples;
+    }
+    REQUIRE(std::abs(mean) < 0.05);
+    REQUIRE(std::abs(variance - 1.0) < 0.05);
+}
+
+TEST_CASE("Batched sampling from randomgen", "[randomgen]") {
+    randomgen randg;
+    randomgen randg2;
+    randg.setSeed(9);
+    randg2.setSeed(9);
+    // Batches of normal samples follow the same sequence as single samples (also with odd batch sizes)
+    std::vector<double> buffer(7);
+    std::vector<double> buffer2(10);
+    randg.fillNormal(buffer, 1.0, 2.0);
+    randg.fillNormal(buffer2, 1.0, 2.0);
+    for (auto &sample : buffer) {
+        REQUIRE(sample == randg2.normal(1.0, 2.0));
+    }
+    auto noise = randg2.normal3D(1.0, 2.0);
+    REQUIRE(noise[0] == buffer2[0]);
+    REQUIRE(noise[2] == buffer2[2]);
+    // Moments of batched samples
+    std::vector<double> normals(100000);
+    std::vector<double> uniforms(100000);
+    randg.fillNormal(normals, 0.0, 1.0);
+    randg.fillUniform(uniforms, -1.0, 3.0);
+    double normalMean = 0.0;
+    double normalVariance = 0.0;
+    double uniformMean = 0.0;
+    for (int i = 0; i < normals.size(); i++) {
+        normalMean += normals[i]/normals.size();
+        normalVariance += normals[i]*normals[i]/normals.size();
+        uniformMean += uniforms[i]/uniforms.size();
+        REQUIRE(uniforms[i] >= -1.0);
+        REQUIRE(uniforms[i] < 3.0);
+    }
+    REQUIRE(std::abs(normalMean) < 0.02);
+    REQUIRE(std::abs(normalVariance - 1.0) < 0.02);
+    REQUIRE(std::abs(uniformMean - 1.0) < 0.02);
+}
+
 TEST_CASE("Particle class basic functionality", "[particle]") {
     double D = 1.0;
     double Drot = 0.5;
@@ -247,6 +342,45 @@ TEST_CASE("Particle class Markovian switching functionality", "[particleMS]") {
     REQUIRE(partMS.orientation == neworientation);
 }
 
+TEST_CASE("Particle list memory layout used by the python views", "[particle]") {
+    /* The numpy views of the python particle lists (see particleListView in binding.hpp) access the variables
+     * of the particle i at the address of the variable of the first particle plus i*sizeof(particle), and the
+     * components of vec3 and quaternion with a stride of sizeof(double). Check those addresses hold the values. */
+    std::vector<particle> parts;
+    for (int i = 0; i < 5; i++) {
+        auto position = vec3<double> {1.0*i, 2.0*i, 3.0*i};
+        auto orientation = quaternion<double> {1.0, 0.1*i, 0.2*i, 0.3*i};
+        parts.push_back(particle(0, i, 1.0, 0.5, position, orientation));
+    }
+    parts[3].deactivate();
+    auto base = reinterpret_cast<char *>(parts.data());
+    auto positionOffset = reinterpret_cast<char *>(parts[0].position.data.data()) - base;
+    auto orientationOffset = reinterpret_cast<char *>(parts[0].orientation.data.data()) - base;
+    auto stateOffset = reinterpret_cast<char *>(&parts[0].state) - base;
+    auto activeOffset = reinterpret_cast<char *>(&parts[0].active) - base;
+    REQUIRE(positionOffset + 3*sizeof(double) <= sizeof(particle));
+    REQUIRE(orientationOffset + 4*sizeof(double) <= sizeof(particle));
+    REQUIRE(stateOffset + sizeof(int) <= sizeof(particle));
+    REQUIRE(activeOffset + sizeof(bool) <= sizeof(particle));
+    REQUIRE(sizeof(bool) == 1); // numpy booleans are one byte
+    for (int i = 0; i < 5; i++) {
+        auto row = base + i*sizeof(particle);
+        auto positionView = reinterpret_cast<double *>(row + positionOffset);
+        auto orientationView = reinterpret_cast<double *>(row + orientationOffset);
+        for (int k = 0; k < 3; k++) {
+            REQUIRE(positionView[k] == parts[i].position[k]);
+        }
+        for (int k = 0; k < 4; k++) {
+            REQUIRE(orientationView[k] == parts[i].orientation[k]);
+        }
+        REQUIRE(*reinterpret_cast<int *>(row + stateOffset) == parts[i].state);
+        REQUIRE(*reinterpret_cast<bool *>(row + activeOffset) == parts[i].isActive());
+    }
+    // Writing through the view writes into the particle
+    reinterpret_cast<double *>(base + 2*sizeof(particle) + positionOffset)[1] = 7.5;
+    REQUIRE(parts[2].position == vec3<double>(2.0, 7.5, 6.0));
+}
+
 TEST_CASE("Event manager functionality", "[eventManager]") {
     eventManager eventMgr = eventManager();
     double waitTime = 5.5;
@@ -310,3 +444,269 @@ TEST_CASE("Event manager functionality", "[eventManager]") {
     auto finalEvent = eventMgr.getEvent(1,2);
     REQUIRE(finalEvent.eventType == "testType");
 }
+
+TEST_CASE("Pair event manager functionality", "[pairEventManager]") {
+    auto eventMgr = pairEventManager();
+    double waitTime = 5.5;
+    eventMgr.addEvent(waitTime, 1, 2, 3, 4, eventType::binding);
+    eventMgr.addEvent(0.5*waitTime, 3, 5, 3, 8, eventType::unbinding);
+    eventMgr.addEvent(2*waitTime, 6, 7, 3, 2, eventType::bound2bound);
+    eventMgr.addEvent(3*waitTime, 1, 3, 3, 12, eventType::transition2transition);
+    // Pairs with large indexes don't collide with other pairs
+    eventMgr.addEvent(4*waitTime, 1, 70000, 3, 1, eventType::binding);
+    eventMgr.addEvent(4*waitTime, 70000, 1, 3, 2, eventType::binding);
+    REQUIRE(eventMgr.getNumEvents() == 6);
+    REQUIRE(eventMgr.getEvent(1, 70000).endState == 1);
+    REQUIRE(eventMgr.getEvent(70000, 1).endState == 2);
+    eventMgr.removeEvent(1, 70000);
+    eventMgr.removeEvent(70000, 1);
+    // Remove events and check times
+    eventMgr.removeEvent(6, 7);
+    REQUIRE(eventMgr.getNumEvents() == 3);
+    REQUIRE(eventMgr.getEventTime(1, 2) == waitTime);
+    REQUIRE(eventMgr.getEventTime(3, 5) == 0.5*waitTime);
+    REQUIRE(eventMgr.getEventTime(6, 7) == std::numeric_limits<double>::infinity());
+    REQUIRE(eventMgr.getEvent(6, 7).type == eventType::empty);
+    // Advancing time reduces the time left of all the events, no event is due yet
+    eventMgr.addEvent(2*waitTime, 6, 7, 3, 2, eventType::bound2bound);
+    eventMgr.advanceTime(1.5);
+    REQUIRE(eventMgr.getEventTime(1, 2) == Approx(waitTime - 1.5));
+    REQUIRE(eventMgr.getEventTime(6, 7) == Approx(2*waitTime - 1.5));
+    REQUIRE(eventMgr.getCurrentTime() == 1.5);
+    pairEvent dueEvent;
+    REQUIRE_FALSE(eventMgr.popDueEvent(dueEvent));
+    // Only the event that happens first is kept for each pair
+    eventMgr.addEvent(5.0*waitTime, 1, 2, 3, 5, eventType::binding);
+    REQUIRE(eventMgr.getEvent(1, 2).endState == 4);
+    eventMgr.addEvent(0.5*waitTime, 1, 2, 3, 5, eventType::binding);
+    REQUIRE(eventMgr.getEvent(1, 2).endState == 5);
+    REQUIRE(eventMgr.getEventTime(1, 2) == 0.5*waitTime);
+    REQUIRE(eventMgr.getNumEvents() == 4);
+    // Due events are returned in time order, and they are kept until removed
+    std::vector<std::array<int, 2>> duePairs;
+    auto applyDueEvents = [&eventMgr, &duePairs]() {
+        pairEvent dueEvent;
+        while (eventMgr.popDueEvent(dueEvent)) {
+            duePairs.push_back({dueEvent.part1Index, dueEvent.part2Index});
+            if (dueEvent.type == eventType::transition2transition) {
+                eventMgr.setEventType(eventType::inTransition, dueEvent.part1Index, dueEvent.part2Index);
+            } else {
+                eventMgr.removeEvent(dueEvent.part1Index, dueEvent.part2Index);
+            }
+        }
+    };
+    eventMgr.advanceTime(2*waitTime + 0.5);
+    applyDueEvents();
+    REQUIRE(duePairs == std::vector<std::array<int, 2>>{{3, 5}, {1, 2}, {6, 7}});
+    REQUIRE(eventMgr.getNumEvents() == 1);
+    // In transition events are not due again, but they can be removed by a condition
+    eventMgr.advanceTime(waitTime);
+    applyDueEvents();
+    REQUIRE(duePairs.size() == 4);
+    REQUIRE(eventMgr.getNumEvents() == 1);
+    eventMgr.advanceTime(10*waitTime);
+    REQUIRE_FALSE(eventMgr.popDueEvent(dueEvent));
+    REQUIRE(eventMgr.getEvent(1, 3).type == eventType::inTransition);
+    eventMgr.addEvent(std::numeric_limits<double>::infinity(), 2, 4, 3, 4, eventType::binding);
+    eventMgr.addEvent(waitTime, 2, 5, 3, 4, eventType::binding);
+    eventMgr.removeEventsIf([](const pairEvent &thisEvent) {
+        return std::isinf(thisEvent.time) or thisEvent.type == eventType::inTransition;
+    });
+    REQUIRE(eventMgr.getNumEvents() == 1);
+    REQUIRE(eventMgr.getEvent(2, 5).type == eventType::binding);
+    // Event type names
+    REQUIRE(eventTypeName(eventType::bound2bound) == "bound2bound");
+    REQUIRE(eventTypeFromName("transition2transition") == eventType::transition2transition);
+    REQUIRE_THROWS(eventTypeFromName("testType"));
+    REQUIRE_THROWS(eventMgr.addEvent(waitTime, 1, 2, 3, 4, eventType::empty));
+    eventMgr.clear();
+    REQUIRE(eventMgr.getNumEvents() == 0);
+}
+
+TEST_CASE("Binary event stream", "[eventStream]") {
+    std::string filename = "testEventStream.bin";
+    int numRecords = 10000;
+    /* A small buffer makes the recording threads wait for the writer, records of each thread are written
+     * in order and none is lost. */
+    auto stream = std::unique_ptr<eventStream>(new eventStream(filename, 16));
+    REQUIRE(stream->getBufferSize() == 16);
+    auto recordEvents = [&stream, numRecords](int thread) {
+        for (int i = 0; i < numRecords; i++) {
+            stream->record(eventRecord{0.5 * i, thread, i, i % 7, i % 5, thread + 1, 0});
+        }
+    };
+    std::thread otherThread(recordEvents, 1);
+    recordEvents(0);
+    otherThread.join();
+    stream->flush();
+    REQUIRE(stream->getNumRecorded() == 2 * numRecords);
+    REQUIRE(stream->getNumWritten() == 2 * numRecords);
+    auto records = eventStream::readEventStream(filename);
+    REQUIRE(records.size() == 2 * numRecords);
+    std::vector<int> nextIndex = {0, 0};
+    int numWrong = 0;
+    for (auto &record : records) {
+        int thread = record.part1Index;
+        int i = nextIndex[thread]++;
+        numWrong += (record.time != 0.5 * i or record.part2Index != i or record.originState != i % 7 or
+                     record.endState != i % 5 or record.type != thread + 1);
+    }
+    REQUIRE(numWrong == 0);
+
+    // Applied events of the event manager; records are written when the stream is closed
+    auto appliedEvent = pairEvent{2.0, 3, 4, 12, 1, eventType::binding};
+    stream->record(1.75, appliedEvent, 6);
+    stream->close();
+    REQUIRE_THROWS(stream->record(1.75, appliedEvent));
+    records = eventStream::readEventStream(filename);
+    REQUIRE(records.size() == 2 * numRecords + 1);
+    auto lastRecord = records.back();
+    REQUIRE(lastRecord.time == 1.75);
+    REQUIRE(lastRecord.part1Index == 3);
+    REQUIRE(lastRecord.part2Index == 4);
+    REQUIRE(lastRecord.originState == 12);
+    REQUIRE(lastRecord.endState == 1);
+    REQUIRE(lastRecord.type == static_cast<int>(eventType::binding));
+    REQUIRE(lastRecord.replicaID == 6);
+    std::remove(filename.c_str());
+    REQUIRE_THROWS(eventStream(filename, 1));
+}
+
+TEST_CASE("Bond graph compounds and rings", "[bondGraph]") {
+    auto graph = bondGraph(7);
+    REQUIRE(graph.getNumberOfParticles() == 7);
+    REQUIRE(graph.getCompoundSize(3) == 1);
+    // Build the chain 0-1-2-3-4, binding twice doesn't change the graph
+    REQUIRE_FALSE(graph.addBond(0, 1));
+    REQUIRE_FALSE(graph.addBond(2, 3));
+    REQUIRE_FALSE(graph.addBond(1, 2));
+    REQUIRE_FALSE(graph.addBond(4, 3));
+    REQUIRE_FALSE(graph.addBond(1, 0));
+    REQUIRE(graph.getNumberOfBonds() == 4);
+    REQUIRE(graph.getCompoundSize(0) == 5);
+    REQUIRE(graph.getCompoundBonds(4) == 4);
+    REQUIRE(graph.getNumberOfRings() == 0);
+    REQUIRE_THROWS(graph.addBond(2, 2));
+    // Closing the chain forms a ring
+    REQUIRE(graph.addBond(0, 4));
+    REQUIRE(graph.getRingSizes() == std::vector<int>{5});
+    REQUIRE(graph.isInRing(2));
+    REQUIRE_FALSE(graph.isInRing(5));
+    /* A dimer is not a ring. Binding it to the ring adds a tail, the compound still has a single closed loop (as
+     * many bonds as particles), but a second bond between them closes another loop. */
+    graph.addBond(5, 6);
+    REQUIRE(graph.getNumberOfRings() == 1);
+    graph.addBond(6, 2);
+    REQUIRE(graph.getCompoundSize(5) == 7);
+    REQUIRE(graph.getRingSizes() == std::vector<int>{7});
+    REQUIRE(graph.addBond(5, 3));
+    REQUIRE(graph.getNumberOfRings() == 0);
+    graph.removeBond(5, 3);
+    // Unbinding the tail restores the ring and leaves the dimer
+    REQUIRE(graph.removeBond(2, 6));
+    REQUIRE_FALSE(graph.removeBond(2, 6));
+    REQUIRE(graph.getRingSizes() == std::vector<int>{5});
+    REQUIRE(graph.getCompoundSize(6) == 2);
+    // Opening the ring keeps the compound, breaking the chain splits it
+    graph.removeBond(2, 3);
+    REQUIRE(graph.getNumberOfRings() == 0);
+    REQUIRE(graph.getCompoundSize(0) == 5);
+    graph.removeBond(0, 1);
+    REQUIRE(graph.getCompoundSize(1) == 2);
+    REQUIRE(graph.getCompoundSize(2) == 2);
+    REQUIRE(graph.getCompoundSize(3) == 3);
+    REQUIRE(graph.getCompoundBonds(0) == 2);
+    REQUIRE(graph.isBound(0, 4));
+    REQUIRE_FALSE(graph.isBound(0, 1));
+    // Random bindings and unbindings match the compounds found from scratch
+    randomgen randg;
+    randg.setSeed(17);
+    int numParticles = 12;
+    graph.reset(numParticles);
+    std::vector<std::vector<bool>> bound(numParticles, std::vector<bool>(numParticles, false));
+    for (int step = 0; step < 500; step++) {
+        int i = static_cast<int>(randg.uniformRange(0, numParticles));
+        int j = static_cast<int>(randg.uniformRange(0, numParticles));
+        if (i == j) {
+            continue;
+        }
+        if (bound[i][j]) {
+            graph.removeBond(i, j);
+        } else {
+            graph.addBond(i, j);
+        }
+        bound[i][j] = not bound[i][j];
+        bound[j][i] = bound[i][j];
+        // Label the compounds with a depth first search
+        std::vector<int> label(numParticles, -1);
+        for (int k = 0; k < numParticles; k++) {
+            if (label[k] >= 0) {
+                continue;
+            }
+            int size = 0;
+            int numBonds = 0;
+            std::vector<int> stack = {k};
+            label[k] = k;
+            while (not stack.empty()) {
+                int current = stack.back();
+                stack.pop_back();
+                size++;
+                for (int l = 0; l < numParticles; l++) {
+                    if (bound[current][l]) {
+                        numBonds++;
+                        if (label[l] < 0) {
+                            label[l] = k;
+                            stack.push_back(l);
+                        }
+                    }
+                }
+            }
+            REQUIRE(graph.getCompoundSize(k) == size);
+            REQUIRE(graph.getCompoundBonds(k) == numBonds / 2);
+            REQUIRE(graph.isInRing(k) == (size > 2 and numBonds / 2 == size));
+        }
+    }
+}
+
+TEST_CASE("Indexed priority queue", "[indexedPriorityQueue]") {
+    int maxIndex = 40;
+    auto queue = indexedPriorityQueue(maxIndex);
+    REQUIRE(queue.empty());
+    REQUIRE_THROWS(queue.top());
+    REQUIRE_THROWS(queue.push(maxIndex, 1.0));
+    // Random insertions, key changes and removals match an ordered set of (key, index)
+    randomgen randg;
+    randg.setSeed(29);
+    std::set<std::pair<double, int>> reference;
+    std::vector<double> keys(maxIndex, -1.0);
+    for (int step = 0; step < 2000; step++) {
+        int index = static_cast<int>(randg.uniformRange(0, maxIndex));
+        double key = std::floor(randg.uniformRange(0, 20));
+        if (randg.uniformRange(0, 1) < 0.3) {
+            queue.remove(index);
+            reference.erase(std::make_pair(keys[index], index));
+            keys[index] = -1.0;
+        } else if (randg.uniformRange(0, 1) < 0.1 and not reference.empty()) {
+            REQUIRE(queue.pop() == reference.begin()->second);
+            keys[reference.begin()->second] = -1.0;
+            reference.erase(reference.begin());
+        } else {
+            queue.push(index, key);
+            reference.erase(std::make_pair(keys[index], index));
+            reference.insert(std::make_pair(key, index));
+            keys[index] = key;
+        }
+        REQUIRE(queue.size() == reference.size());
+        REQUIRE(queue.contains(index) == (keys[index] >= 0));
+        if (not reference.empty()) {
+            REQUIRE(queue.top() == reference.begin()->second);
+            REQUIRE(queue.topKey() == reference.begin()->first);
+        }
+    }
+    // Popping all the entries gives them in order
+    for (auto &entry : reference) {
+        REQUIRE(queue.getKey(entry.second) == entry.first);
+        REQUIRE(queue.pop() == entry.second);
+    }
+    REQUIRE(queue.empty());
+}
@@ -72,4 +72,126 @@ TEST_CASE("Initialization of msmrdMarkovModel class", "[msmrdMarkovModel]") {
         REQUIRE(msmrdMSM.getActiveSetIndex(i) == activeSet[i]);
         REQUIRE(msmrdMSM.getMSMindex(activeSet[i]) == i);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Sparse transition matrix of msmrdMarkovModel", "[msmrdMarkovModel]") {
+    double lagtime = 0.5;
+    long seed = 7;
+    std::vector<std::vector<double>> tmatrix = {{0.0, 0.3, 0.2, 0.5},
+                                                {0.4, 0.6, 0.0, 0.0},
+                                                {0.0, 0.0, 1.0, 0.0},
+                                                {0.4, 0.2, 0.3, 0.1}};
+    std::vector<int> activeSet = {1, 2, 11, 12};
+    // Same matrix as scipy csr_matrix arrays (indptr, indices, data)
+    std::vector<int> rowOffsets = {0, 3, 5, 6, 10};
+    std::vector<int> columns = {1, 2, 3, 0, 1, 2, 0, 1, 2, 3};
+    std::vector<double> values = {0.3, 0.2, 0.5, 0.4, 0.6, 1.0, 0.4, 0.2, 0.3, 0.1};
+    auto denseMSM = msmrdMarkovModel(2, 10, tmatrix, activeSet, lagtime, seed);
+    auto sparseMSM = msmrdMarkovModel(2, 10, rowOffsets, columns, values, activeSet, lagtime, seed);
+    // Dense input is stored in CSR format, only non-zero probabilities are kept
+    REQUIRE(denseMSM.getRowOffsets() == rowOffsets);
+    REQUIRE(denseMSM.getColumns() == columns);
+    REQUIRE(denseMSM.getValues() == values);
+    REQUIRE(denseMSM.getNumberOfNonZeros() == 10);
+    REQUIRE(denseMSM.nstates == 4);
+    REQUIRE(sparseMSM.getTmatrix() == tmatrix);
+    REQUIRE(sparseMSM.getLagtime() == lagtime);
+    REQUIRE(sparseMSM.getTransitionProbability(0, 3) == 0.5);
+    REQUIRE(sparseMSM.getTransitionProbability(1, 3) == 0.0);
+    REQUIRE_THROWS(sparseMSM.getTransitionProbability(4, 0));
+
+    // Both constructions yield the same transitions with the same seed
+    for (int i = 0; i < 1000; i++) {
+        REQUIRE(denseMSM.calculateTransition(12) == sparseMSM.calculateTransition(12));
+    }
+    int numSamples = 200000;
+    std::vector<double> frequencies(4, 0.0);
+    for (int i = 0; i < numSamples; i++) {
+        auto transition = sparseMSM.calculateTransition(1);
+        frequencies[sparseMSM.getMSMindex(std::get<1>(transition))] += 1.0 / numSamples;
+    }
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(frequencies[i] == Approx(tmatrix[0][i]).margin(0.005));
+    }
+    // Absorbing state
+    REQUIRE(std::get<1>(sparseMSM.calculateTransition(11)) == 11);
+
+    // Reverse lookup of the active set, -1 for indexes not in the active set
+    for (int i = 0; i < activeSet.size(); i++) {
+        REQUIRE(sparseMSM.getMSMindex(activeSet[i]) == i);
+    }
+    REQUIRE(sparseMSM.getMSMindex(0) == -1);
+    REQUIRE(sparseMSM.getMSMindex(5) == -1);
+    REQUIRE(sparseMSM.getMSMindex(13) == -1);
+    REQUIRE(sparseMSM.getMSMindex(-3) == -1);
+    REQUIRE(std::get<1>(sparseMSM.calculateTransition(5)) == -1);
+
+    // Invalid transition matrices
+    std::vector<double> wrongSum = {0.3, 0.2, 0.4, 0.4, 0.6, 1.0, 0.4, 0.2, 0.3, 0.1};
+    std::vector<int> wrongColumns = {1, 2, 4, 0, 1, 2, 0, 1, 2, 3};
+    std::vector<std::vector<double>> notSquare = {{0.5, 0.5}, {1.0}};
+    REQUIRE_THROWS(msmrdMarkovModel(2, 10, rowOffsets, columns, wrongSum, activeSet, lagtime, seed));
+    REQUIRE_THROWS(msmrdMarkovModel(2, 10, rowOffsets, wrongColumns, values, activeSet, lagtime, seed));
+    REQUIRE_THROWS(msmrdMarkovModel(2, 10, std::vector<int>{0, 3, 5, 6}, columns, values, activeSet,
+                                    lagtime, seed));
+    REQUIRE_THROWS(msmrdMarkovModel(2, 10, notSquare, activeSet, lagtime, seed));
+}
+TEST_CASE("Sampling of transitions with alias tables", "[aliasTable]") {
+    randomgen randg;
+    randg.setSeed(11);
+    int numSamples = 200000;
+    // Frequencies of the samples match the normalized weights, zero weights are never sampled
+    std::vector<double> weights = {0.5, 0.0, 3.0, 1.5, 0.25, 2.75};
+    auto table = aliasTable(weights);
+    std::vector<double> frequencies(weights.size(), 0.0);
+    for (int i = 0; i < numSamples; i++) {
+        frequencies[table.sample(randg)] += 1.0 / numSamples;
+    }
+    for (int i = 0; i < weights.size(); i++) {
+        REQUIRE(frequencies[i] == Approx(weights[i] / 8.0).margin(0.005));
+    }
+    REQUIRE(frequencies[1] == 0.0);
+    REQUIRE_THROWS(aliasTable(std::vector<double>{}));
+    REQUIRE_THROWS(aliasTable(std::vector<double>{1.0, -1.0}));
+
+    // Exponential samples have mean 1/rate, a zero rate yields infinite waiting times
+    double meanExponential = 0;
+    for (int i = 0; i < numSamples; i++) {
+        meanExponential += randg.exponential(4.0) / numSamples;
+    }
+    REQUIRE(meanExponential == Approx(0.25).epsilon(0.01));
+    REQUIRE(randg.exponential(0.0) == std::numeric_limits<double>::infinity());
+
+    // CTMSM transitions: mean waiting time 1/lambda0 and next state with probability rate/lambda0
+    std::vector<std::vector<double>> rates = {{-1.5, 0.5, 1.0}, {0.3, -0.3, 0.0}, {0.2, 0.6, -0.8}};
+    auto tmsm = ctmsm(0, rates, 13);
+    REQUIRE(tmsm.getLambda0() == std::vector<double>{1.5, 0.3, 0.8});
+    double meanLagtime = 0;
+    std::vector<double> ctmsmFrequencies(3, 0.0);
+    for (int i = 0; i < numSamples; i++) {
+        auto transition = tmsm.propagateMSM(2, 1);
+        meanLagtime += std::get<0>(transition) / numSamples;
+        ctmsmFrequencies[std::get<1>(transition)] += 1.0 / numSamples;
+    }
+    REQUIRE(meanLagtime == Approx(1.0 / 0.8).epsilon(0.01));
+    REQUIRE(ctmsmFrequencies[0] == Approx(0.25).margin(0.005));
+    REQUIRE(ctmsmFrequencies[1] == Approx(0.75).margin(0.005));
+    REQUIRE(ctmsmFrequencies[2] == 0.0);
+
+    // Discrete time MSM transitions, also without updating the particle state
+    std::vector<std::vector<double>> tmatrix = {{0.1, 0.6, 0.3}, {0.0, 0.2, 0.8}, {0.5, 0.5, 0.0}};
+    auto dtmsm = msm(0, tmatrix, 1.0, 17);
+    auto part = particle(0, 0, 1.0, 1.0, vec3<double>(0, 0, 0), quaternion<double>(1, 0, 0, 0));
+    std::vector<double> msmFrequencies(3, 0.0);
+    std::vector<double> noUpdateFrequencies(3, 0.0);
+    for (int i = 0; i < numSamples; i++) {
+        msmFrequencies[std::get<1>(dtmsm.propagateMSM(0, 1))] += 1.0 / numSamples;
+        dtmsm.propagateNoUpdate(part, 1);
+        noUpdateFrequencies[part.nextState] += 1.0 / numSamples;
+    }
+    REQUIRE(part.state == 0);
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(msmFrequencies[i] == Approx(tmatrix[0][i]).margin(0.005));
+        REQUIRE(noUpdateFrequencies[i] == Approx(tmatrix[0][i]).margin(0.005));
+    }
+}
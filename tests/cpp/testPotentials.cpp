@@ -6,6 +6,7 @@
 #include "randomgen.hpp"
 #include "potentials/gayBerne.hpp"
 #include "potentials/patchyParticle.hpp"
+#include "potentials/patchyParticleAngular.hpp"
 #include "potentials/patchyProteinMarkovSwitch.hpp"
 
 using namespace msmrd;
@@ -137,3 +138,57 @@ TEST_CASE("patchyProteinMS potential: test patchesActive", "[potentials]") {
     REQUIRE(potentialPPMS.arePatchesActive() == false);
 }
 
+TEST_CASE("Patch frame cache of patchy potentials", "[potentials]") {
+    randomgen randg;
+    randg.setSeed(4);
+    int numParticles = 20;
+    std::vector<particle> plist;
+    for (int i = 0; i < numParticles; i++) {
+        auto position = vec3<double> {randg.uniformRange(-1.0, 1.0), randg.uniformRange(-1.0, 1.0),
+                                      randg.uniformRange(-1.0, 1.0)};
+        auto orientation = msmrdtools::axisangle2quaternion(randg.uniformSphere(M_PI));
+        plist.push_back(particle(i % 2, 0, 1.0, 1.0, position, orientation));
+    }
+    double angleDiff = 3*M_PI/5.0;
+    std::vector<std::vector<double>> patchesCoordinates = {{std::cos(angleDiff/2), std::sin(angleDiff/2), 0.},
+                                                           {std::cos(-angleDiff/2), std::sin(-angleDiff/2), 0.}};
+    std::vector<std::vector<double>> patchesCoordinatesA = {{1., 0., 0.}, {0., 1., 0.}, {0., 0., 1.},
+                                                            {-1., 0., 0.}, {0., -1., 0.}, {0., 0., -1.}};
+    std::vector<std::vector<double>> patchesCoordinatesB = {{1., 0., 0.}};
+    auto potentialAngular2 = patchyParticleAngular2(1.0, 50.0, patchesCoordinates);
+    auto potentialProtein = patchyProteinMarkovSwitch(1.0, 50.0, 2.0, patchesCoordinatesA, patchesCoordinatesB);
+    std::array<pairPotential*, 2> potentials = {&potentialAngular2, &potentialProtein};
+
+    /* Forces and energies with cached patches must match the ones without cache (only pairs of type 0 and 1
+     * particles, as required by the patchy protein potential) */
+    for (auto potential : potentials) {
+        std::vector<std::array<vec3<double>, 4>> forctorqRef;
+        std::vector<double> energyRef;
+        for (int i = 0; i < numParticles; i += 2) {
+            for (int j = i + 1; j < numParticles; j += 2) {
+                forctorqRef.push_back(potential->forceTorque(plist[i], plist[j]));
+                energyRef.push_back(potential->evaluate(plist[i], plist[j]));
+            }
+        }
+        potential->precompute(plist);
+        int pairIndex = 0;
+        for (int i = 0; i < numParticles; i += 2) {
+            for (int j = i + 1; j < numParticles; j += 2) {
+                auto forctorq = potential->forceTorque(plist[i], plist[j]);
+                for (int k = 0; k < 4; k++) {
+                    REQUIRE(forctorq[k] == forctorqRef[pairIndex][k]);
+                }
+                REQUIRE(potential->evaluate(plist[i], plist[j]) == energyRef[pairIndex]);
+                pairIndex++;
+            }
+        }
+        // Particles that changed after the cache update, or not in the cached list, are not taken from the cache
+        plist[0].orientation = 1.0*plist[1].orientation;
+        auto partCopy = plist[0];
+        auto forctorq = potential->forceTorque(plist[0], plist[1]);
+        auto forctorqCopy = potential->forceTorque(partCopy, plist[1]);
+        for (int k = 0; k < 4; k++) {
+            REQUIRE(forctorq[k] == forctorqCopy[k]);
+        }
+    }
+}
@@ -2,12 +2,14 @@
 // Created by maojrs on 3/28/19.
 //
 
+#include <algorithm>
 #include <catch2/catch.hpp>
 #include "trajectories/trajectory.hpp"
 #include "trajectories/trajectoryPosition.hpp"
 #include "trajectories/trajectoryPositionOrientation.hpp"
 #include "trajectories/discrete/patchyProteinTrajectory.hpp"
 #include "integrators/overdampedLangevin.hpp"
+#include "randomgen.hpp"
 #include "simulation.hpp"
 #include "tools.hpp"
 
@@ -79,3 +81,107 @@ TEST_CASE("Patchy Protein trajectory", "[patchyProteinTrajectory]") {
         REQUIRE(discreteState == i+1);
     }
 }
+
+TEST_CASE("Batch discretization of trajectories", "[patchyProteinTrajectory]") {
+    randomgen randg;
+    randg.setSeed(7);
+    int numTimesteps = 2000;
+    int numParticles = 3;
+    int numColumns = 9;
+    int numPairs = 3;
+    patchyProteinTrajectory2 traj(numParticles, 1);
+    // Bound state of patchy protein (relative position {1,0,0}, relative rotation by pi around z)
+    auto boundOrientation = msmrdtools::axisangle2quaternion(vec3<double>{0.0, 0.0, M_PI});
+    // Trajectory array of shape (numTimesteps, numParticles, numColumns) and the corresponding particles
+    std::vector<double> trajectory(numTimesteps * numParticles * numColumns);
+    std::vector<std::vector<particle>> particleFrames(numTimesteps);
+    for (int t = 0; t < numTimesteps; t++) {
+        for (int i = 0; i < numParticles; i++) {
+            vec3<double> position = randg.uniformSphere(1.5);
+            auto orientation = quaternion<double>{randg.normal(0, 1), randg.normal(0, 1), randg.normal(0, 1),
+                                                  randg.normal(0, 1)};
+            orientation = orientation / orientation.norm();
+            // Place particle 1 in a bound state of particle 0 every few timesteps
+            if (i == 1 and t % 5 == 0) {
+                position = particleFrames[t][0].position + vec3<double>{1.0, 0.0, 0.0};
+                orientation = boundOrientation;
+            }
+            if (i == 0 and t % 5 == 0) {
+                orientation = {1.0, 0.0, 0.0, 0.0};
+            }
+            int state = randg.uniformInteger(0, 2);
+            particleFrames[t].push_back(particle(0, state, 0, 0, position, orientation));
+            double *row = trajectory.data() + (t * numParticles + i) * numColumns;
+            row[0] = t;
+            for (int k = 0; k < 3; k++) {
+                row[k + 1] = position[k];
+            }
+            for (int k = 0; k < 4; k++) {
+                row[k + 4] = orientation[k];
+            }
+            row[8] = state;
+        }
+    }
+    // Reference discretization particle by particle, applying the CoreMSM approach to each pair
+    std::vector<std::int32_t> reference(numTimesteps * numPairs);
+    std::vector<int> prevStates(numPairs, 0);
+    for (int t = 0; t < numTimesteps; t++) {
+        int pair = 0;
+        for (int i = 0; i < numParticles; i++) {
+            for (int j = i + 1; j < numParticles; j++) {
+                int state = traj.sampleDiscreteState(particleFrames[t][i], particleFrames[t][j]);
+                if (state == -1) {
+                    state = prevStates[pair];
+                }
+                prevStates[pair] = state;
+                reference[t * numPairs + pair] = state;
+                pair++;
+            }
+        }
+    }
+    auto discreteTrajectories = traj.discretizeTrajectoryBatch(trajectory.data(), numTimesteps, numParticles,
+                                                               numColumns);
+    REQUIRE(discreteTrajectories == reference);
+    // All kinds of states are sampled
+    REQUIRE(std::count(reference.begin(), reference.end(), 0) > 0);
+    REQUIRE(std::count_if(reference.begin(), reference.end(), [](int s) { return s > 0 and s <= 6; }) > 0);
+    REQUIRE(std::count_if(reference.begin(), reference.end(), [](int s) { return s > 10; }) > 0);
+#ifdef _OPENMP
+    traj.setNumThreads(4);
+    REQUIRE(traj.discretizeTrajectoryBatch(trajectory.data(), numTimesteps, numParticles,
+                                           numColumns) == reference);
+    traj.setNumThreads(1);
+#else
+    REQUIRE_THROWS(traj.setNumThreads(4));
+#endif
+
+    // Discretizing the first two particles from trajectory rows gives the first pair
+    std::vector<std::vector<double>> rows;
+    std::vector<double> dimerArray;
+    for (int t = 0; t < numTimesteps; t++) {
+        for (int i = 0; i < 2; i++) {
+            const double *row = trajectory.data() + (t * numParticles + i) * numColumns;
+            rows.emplace_back(row, row + numColumns);
+            dimerArray.insert(dimerArray.end(), row, row + numColumns);
+        }
+    }
+    auto dimerTrajectory = traj.discretizeTrajectory(rows);
+    auto dimerBatch = traj.discretizeTrajectoryBatch(dimerArray.data(), numTimesteps, 2, numColumns);
+    REQUIRE(dimerTrajectory.size() == numTimesteps);
+    for (int t = 0; t < numTimesteps; t++) {
+        REQUIRE(dimerTrajectory[t] == dimerBatch[t]);
+        REQUIRE(dimerBatch[t] == reference[t * numPairs]);
+    }
+
+    // Errors inside the threaded loop are thrown after it (non-unit quaternion in transition region)
+    const double *row0 = trajectory.data() + (numTimesteps / 2 * numParticles) * numColumns;
+    double *row1 = trajectory.data() + (numTimesteps / 2 * numParticles + 1) * numColumns;
+    row1[1] = row0[1] + 1.8;
+    row1[2] = row0[2];
+    row1[3] = row0[3];
+    row1[4] = 3.0;
+    REQUIRE_THROWS(traj.discretizeTrajectoryBatch(trajectory.data(), numTimesteps, numParticles, numColumns));
+    REQUIRE_THROWS(traj.discretizeTrajectoryBatch(trajectory.data(), numTimesteps, numParticles, 7));
+    REQUIRE_THROWS_AS(traj.discretizeTrajectoryBatchH5("test.h5", 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(traj.discretizeTrajectoryBatchH5("test.h5", 1), std::invalid_argument);
+}
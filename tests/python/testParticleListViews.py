@@ -0,0 +1,41 @@
+import msmrd2
+import numpy as np
+
+# Numpy views of the particles in a particle list (see particleListView in src/binding/binding.hpp)
+numParticles = 4
+particles = []
+for i in range(numParticles):
+    position = np.array([1.0*i, 2.0*i, 3.0*i])
+    orientation = np.array([1.0, 0.1*i, 0.2*i, 0.3*i])
+    particles.append(msmrd2.particle(0, i, 1.0, 0.5, position, orientation))
+partlist = msmrd2.integrators.particleList(particles)
+
+positions = partlist.positions
+orientations = partlist.orientations
+assert positions.shape == (numParticles, 3)
+assert orientations.shape == (numParticles, 4)
+for i in range(numParticles):
+    assert np.array_equal(positions[i], partlist[i].position)
+    assert np.array_equal(orientations[i], partlist[i].orientation)
+assert np.array_equal(partlist.states, np.arange(numParticles))
+assert partlist.active.all()
+
+# Writing through the views writes into the particles
+positions[2] = [7.0, 8.0, 9.0]
+assert np.array_equal(partlist[2].position, [7.0, 8.0, 9.0])
+orientations[1] = [0.0, 0.0, 0.0, 1.0]
+assert np.array_equal(partlist[1].orientation, [0.0, 0.0, 0.0, 1.0])
+partlist.active[3] = False
+assert not partlist[3].isActive
+
+# States are read only views, but they (and the other variables) can be set in bulk with the right shape
+assert not partlist.states.flags.writeable
+partlist.states = np.zeros(numParticles, dtype=np.intc)
+assert partlist[3].state == 0
+partlist.positions = np.zeros((numParticles, 3))
+assert np.array_equal(partlist[2].position, [0.0, 0.0, 0.0])
+try:
+    partlist.positions = np.zeros((numParticles + 1, 3))
+    assert False
+except ValueError:
+    pass